@@ -1,13 +1,31 @@
 #include "ap.h"
 
 
+#ifdef _USE_HW_CLI
+static void apCliRxEvent(uint8_t ch, uint32_t event);
+
+static volatile bool is_cli_rx    = true;
+static bool          is_cli_event = false;
+#endif
+
 
 
 void apInit(void)
 {  
   #ifdef _USE_HW_CLI
   cliOpen(HW_UART_CH_CLI, 115200);
+  cliOpen(HW_UART_CH_USB, 115200);
   cliLogo();
+  #ifdef _USE_HW_CLI_RUN
+  cliRunBoot();
+  #endif
+
+  // 모든 session 채널이 RX 이벤트를 지원하면 데이터가 들어왔을 때만 cliMain() 을 실행한다.
+  is_cli_event = uartAttachRxEvent(HW_UART_CH_CLI, apCliRxEvent);
+  if (uartAttachRxEvent(HW_UART_CH_USB, apCliRxEvent) != true)
+  {
+    is_cli_event = false;
+  }
   #endif    
 }
 
@@ -25,7 +43,22 @@ void apMain(void)
     }
 
     #ifdef _USE_HW_CLI
-    cliMain();
+    if (is_cli_rx == true || is_cli_event != true)
+    {
+      bool is_more;
+
+      is_cli_rx = false;
+
+      PROF_TASK_BEGIN();
+      is_more = cliMain();
+      PROF_TASK_END(PROF_TASK_CLI);
+
+      // Enter 뒤에 남은 입력은 다음 루프에서 이어서 처리한다.
+      if (is_more == true && is_cli_event == true)
+      {
+        is_cli_rx = true;
+      }
+    }
     #endif
 
     #ifdef _USE_HW_WPAN
@@ -34,3 +67,9 @@ void apMain(void)
   }
 }
 
+#ifdef _USE_HW_CLI
+void apCliRxEvent(uint8_t ch, uint32_t event)
+{
+  is_cli_rx = true;
+}
+#endif
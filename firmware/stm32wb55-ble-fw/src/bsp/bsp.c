@@ -26,6 +26,10 @@ bool bspInit(void)
   __HAL_RCC_GPIOA_CLK_ENABLE();
   __HAL_RCC_GPIOD_CLK_ENABLE();
 
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT       = 0;
+  DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+
   return true;
 }
 
@@ -39,6 +43,11 @@ uint32_t millis(void)
   return HAL_GetTick();
 }
 
+uint32_t cycles(void)
+{
+  return DWT->CYCCNT;
+}
+
 
 
 void Error_Handler(void)
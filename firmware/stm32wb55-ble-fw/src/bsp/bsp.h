@@ -20,6 +20,7 @@ bool bspInit(void);
 
 void delay(uint32_t time_ms);
 uint32_t millis(void);
+uint32_t cycles(void);
 
 void Error_Handler(void);
 
@@ -0,0 +1,562 @@
+#include "print.h"
+#include "cli.h"
+
+
+#if CLI_USE(HW_PRINT)
+static void cliPrint(cli_args_t *args);
+#endif
+
+
+#define PRINT_FLAG_LEFT       (1<<0)
+#define PRINT_FLAG_ZERO       (1<<1)
+#define PRINT_FLAG_PLUS       (1<<2)
+#define PRINT_FLAG_SPACE      (1<<3)
+#define PRINT_FLAG_UPPER      (1<<4)
+
+#define PRINT_NUM_BUF_MAX     36    // 64bit 10진수 20 + 소수점 + 소수부 9 + 지수 "e+308"
+#define PRINT_FLOAT_PREC_MAX  9
+
+
+typedef struct
+{
+  print_out_t p_out;
+  void       *p_arg;
+  uint32_t    index;
+  uint32_t    total;
+  uint8_t     buf[PRINT_CHUNK_MAX];
+} print_ctx_t;
+
+typedef struct
+{
+  char     *p_buf;
+  uint32_t  size;
+  uint32_t  index;
+} print_mem_t;
+
+
+
+
+void printInit(void)
+{
+#if CLI_USE(HW_PRINT)
+  cliAdd("print", cliPrint);
+#endif
+}
+
+static void printFlush(print_ctx_t *p_ctx)
+{
+  if (p_ctx->index > 0)
+  {
+    p_ctx->p_out(p_ctx->p_arg, p_ctx->buf, p_ctx->index);
+    p_ctx->index = 0;
+  }
+}
+
+static void printPut(print_ctx_t *p_ctx, char data)
+{
+  p_ctx->buf[p_ctx->index++] = (uint8_t)data;
+  p_ctx->total++;
+
+  if (p_ctx->index >= PRINT_CHUNK_MAX)
+  {
+    printFlush(p_ctx);
+  }
+}
+
+static void printRepeat(print_ctx_t *p_ctx, char data, int32_t count)
+{
+  while(count-- > 0)
+  {
+    printPut(p_ctx, data);
+  }
+}
+
+// [sign][0x][zero pad][body] 를 width 에 맞춰 출력한다.
+static void printField(print_ctx_t *p_ctx, const char *p_prefix, const char *p_body, int32_t length, int32_t width, uint32_t flags)
+{
+  int32_t prefix_len = strlen(p_prefix);
+  int32_t pad_len;
+
+  pad_len = width - length - prefix_len;
+
+  if ((flags & (PRINT_FLAG_LEFT | PRINT_FLAG_ZERO)) == 0)
+  {
+    printRepeat(p_ctx, ' ', pad_len);
+  }
+  while(*p_prefix)
+  {
+    printPut(p_ctx, *p_prefix++);
+  }
+  if ((flags & (PRINT_FLAG_LEFT | PRINT_FLAG_ZERO)) == PRINT_FLAG_ZERO)
+  {
+    printRepeat(p_ctx, '0', pad_len);
+  }
+  for (int32_t i=0; i<length; i++)
+  {
+    printPut(p_ctx, p_body[i]);
+  }
+  if (flags & PRINT_FLAG_LEFT)
+  {
+    printRepeat(p_ctx, ' ', pad_len);
+  }
+}
+
+// p_end 앞쪽으로 숫자를 채우고 시작 위치를 돌려준다.
+static char *printUtoa(char *p_end, uint64_t value, uint32_t base, uint32_t flags)
+{
+  const char *p_digit = (flags & PRINT_FLAG_UPPER) ? "0123456789ABCDEF":"0123456789abcdef";
+  uint32_t    value32;
+
+  // 대부분은 32bit 이므로 64bit 나눗셈(soft)은 필요할 때만 쓴다.
+  while(value > 0xFFFFFFFFULL)
+  {
+    *--p_end = p_digit[value % base];
+    value /= base;
+  }
+
+  value32 = (uint32_t)value;
+  do
+  {
+    *--p_end = p_digit[value32 % base];
+    value32 /= base;
+  } while(value32 > 0);
+
+  return p_end;
+}
+
+static void printInt(print_ctx_t *p_ctx, uint64_t value, bool is_neg, uint32_t base, int32_t width, int32_t prec, uint32_t flags)
+{
+  char        num_buf[PRINT_NUM_BUF_MAX];
+  char       *p_end = &num_buf[PRINT_NUM_BUF_MAX];
+  char       *p_begin;
+  const char *p_prefix = "";
+
+  p_begin = printUtoa(p_end, value, base, flags);
+
+  if (prec >= 0)
+  {
+    if (prec == 0 && value == 0)
+    {
+      p_begin = p_end;
+    }
+    while(p_end - p_begin < prec && p_begin > num_buf)
+    {
+      *--p_begin = '0';
+    }
+    flags &= ~PRINT_FLAG_ZERO;
+  }
+
+  if (is_neg)
+    p_prefix = "-";
+  else if (flags & PRINT_FLAG_PLUS)
+    p_prefix = "+";
+  else if (flags & PRINT_FLAG_SPACE)
+    p_prefix = " ";
+
+  printField(p_ctx, p_prefix, p_begin, p_end - p_begin, width, flags);
+}
+
+#if PRINT_USE_FLOAT == 1
+// 정수부/소수부를 나눠 정수로 찍는 고정소수점 방식이다.
+// 정수부가 64bit 를 넘는 1e19 이상은 d.ddde+NN 형태로 찍는다.
+static void printFloat(print_ctx_t *p_ctx, double value, int32_t width, int32_t prec, uint32_t flags)
+{
+  char        num_buf[PRINT_NUM_BUF_MAX];
+  char       *p_end = &num_buf[PRINT_NUM_BUF_MAX];
+  char       *p_begin;
+  const char *p_prefix = "";
+  uint64_t    int_part;
+  uint32_t    frac_part;
+  uint32_t    scale = 1;
+  int32_t     exp10 = 0;
+
+
+  if (prec < 0) prec = 6;
+  if (prec > PRINT_FLOAT_PREC_MAX) prec = PRINT_FLOAT_PREC_MAX;
+
+  if (value < 0)
+  {
+    value    = -value;
+    p_prefix = "-";
+  }
+  else if (flags & PRINT_FLAG_PLUS)
+    p_prefix = "+";
+  else if (flags & PRINT_FLAG_SPACE)
+    p_prefix = " ";
+
+  if (value != value)
+  {
+    printField(p_ctx, p_prefix, "nan", 3, width, flags & ~PRINT_FLAG_ZERO);
+    return;
+  }
+  if (value - value != 0)
+  {
+    printField(p_ctx, p_prefix, "inf", 3, width, flags & ~PRINT_FLAG_ZERO);
+    return;
+  }
+  if (value >= 1e19)
+  {
+    while(value >= 10)
+    {
+      value /= 10;
+      exp10++;
+    }
+  }
+
+  for (int32_t i=0; i<prec; i++)
+  {
+    scale *= 10;
+  }
+
+  value    += 0.5 / scale;
+  int_part  = (uint64_t)value;
+  frac_part = (uint32_t)((value - (double)int_part) * scale);
+  if (frac_part >= scale)
+  {
+    frac_part = scale - 1;
+  }
+  if (exp10 > 0 && int_part >= 10)
+  {
+    // 반올림으로 9.99.. 가 10 이 된 경우
+    int_part  = 1;
+    frac_part = 0;
+    exp10++;
+  }
+
+  p_begin = p_end;
+  if (exp10 > 0)
+  {
+    p_begin = printUtoa(p_begin, exp10, 10, flags);
+    if (exp10 < 10)
+    {
+      *--p_begin = '0';
+    }
+    *--p_begin = '+';
+    *--p_begin = (flags & PRINT_FLAG_UPPER) ? 'E':'e';
+  }
+  if (prec > 0)
+  {
+    for (int32_t i=0; i<prec; i++)
+    {
+      *--p_begin = '0' + (frac_part % 10);
+      frac_part /= 10;
+    }
+    *--p_begin = '.';
+  }
+  p_begin = printUtoa(p_begin, int_part, 10, flags);
+
+  printField(p_ctx, p_prefix, p_begin, p_end - p_begin, width, flags);
+}
+#endif
+
+uint32_t printFormat(print_out_t p_out, void *p_arg, const char *fmt, va_list arg)
+{
+  print_ctx_t ctx;
+
+
+  ctx.p_out = p_out;
+  ctx.p_arg = p_arg;
+  ctx.index = 0;
+  ctx.total = 0;
+
+  while(*fmt)
+  {
+    uint32_t flags = 0;
+    int32_t  width = 0;
+    int32_t  prec  = -1;
+    uint32_t size  = 0;     // 0:int 1:long 2:long long
+    char     spec;
+
+    if (*fmt != '%')
+    {
+      printPut(&ctx, *fmt++);
+      continue;
+    }
+    fmt++;
+
+    // flags
+    while(1)
+    {
+      if      (*fmt == '-') flags |= PRINT_FLAG_LEFT;
+      else if (*fmt == '0') flags |= PRINT_FLAG_ZERO;
+      else if (*fmt == '+') flags |= PRINT_FLAG_PLUS;
+      else if (*fmt == ' ') flags |= PRINT_FLAG_SPACE;
+      else if (*fmt == '#') { }
+      else break;
+      fmt++;
+    }
+
+    // width
+    if (*fmt == '*')
+    {
+      width = va_arg(arg, int);
+      if (width < 0)
+      {
+        flags |= PRINT_FLAG_LEFT;
+        width  = -width;
+      }
+      fmt++;
+    }
+    while(*fmt >= '0' && *fmt <= '9')
+    {
+      width = width * 10 + (*fmt++ - '0');
+    }
+
+    // precision
+    if (*fmt == '.')
+    {
+      fmt++;
+      prec = 0;
+      if (*fmt == '*')
+      {
+        prec = va_arg(arg, int);
+        fmt++;
+      }
+      while(*fmt >= '0' && *fmt <= '9')
+      {
+        prec = prec * 10 + (*fmt++ - '0');
+      }
+    }
+
+    // length
+    while(*fmt == 'l' || *fmt == 'h' || *fmt == 'z' || *fmt == 't')
+    {
+      if (*fmt == 'l') size++;
+      if (*fmt == 'z' || *fmt == 't') size = sizeof(size_t) > sizeof(int) ? 1:0;
+      fmt++;
+    }
+
+    spec = *fmt;
+    if (spec == 0) break;
+    fmt++;
+
+    switch(spec)
+    {
+      case 'd':
+      case 'i':
+        {
+          int64_t value;
+
+          if (size >= 2)      value = va_arg(arg, long long);
+          else if (size == 1) value = va_arg(arg, long);
+          else                value = va_arg(arg, int);
+
+          printInt(&ctx, value < 0 ? -(uint64_t)value:(uint64_t)value, value < 0, 10, width, prec, flags);
+        }
+        break;
+
+      case 'u':
+      case 'x':
+      case 'X':
+      case 'o':
+        {
+          uint64_t value;
+          uint32_t base = spec == 'u' ? 10 : spec == 'o' ? 8 : 16;
+
+          if (size >= 2)      value = va_arg(arg, unsigned long long);
+          else if (size == 1) value = va_arg(arg, unsigned long);
+          else                value = va_arg(arg, unsigned int);
+
+          if (spec == 'X') flags |= PRINT_FLAG_UPPER;
+          flags &= ~(PRINT_FLAG_PLUS | PRINT_FLAG_SPACE);
+          printInt(&ctx, value, false, base, width, prec, flags);
+        }
+        break;
+
+      case 'p':
+        {
+          char  num_buf[PRINT_NUM_BUF_MAX];
+          char *p_end = &num_buf[PRINT_NUM_BUF_MAX];
+          char *p_begin;
+
+          p_begin = printUtoa(p_end, (uintptr_t)va_arg(arg, void *), 16, 0);
+          printField(&ctx, "0x", p_begin, p_end - p_begin, width, flags & PRINT_FLAG_LEFT);
+        }
+        break;
+
+      case 'c':
+        {
+          char data = (char)va_arg(arg, int);
+
+          printField(&ctx, "", &data, 1, width, flags & PRINT_FLAG_LEFT);
+        }
+        break;
+
+      case 's':
+        {
+          const char *p_str = va_arg(arg, const char *);
+          int32_t     length = 0;
+
+          if (p_str == NULL)
+          {
+            p_str = "(null)";
+          }
+          while(p_str[length] != 0 && (prec < 0 || length < prec))
+          {
+            length++;
+          }
+          printField(&ctx, "", p_str, length, width, flags & PRINT_FLAG_LEFT);
+        }
+        break;
+
+      case 'f':
+      case 'F':
+        {
+          double value = va_arg(arg, double);
+#if PRINT_USE_FLOAT == 1
+          printFloat(&ctx, value, width, prec, flags);
+#else
+          (void)value;
+          printField(&ctx, "", "?", 1, width, flags & PRINT_FLAG_LEFT);
+#endif
+        }
+        break;
+
+      case '%':
+        printPut(&ctx, '%');
+        break;
+
+      default:
+        printPut(&ctx, '%');
+        printPut(&ctx, spec);
+        break;
+    }
+  }
+
+  printFlush(&ctx);
+
+  return ctx.total;
+}
+
+static void printOutMem(void *p_arg, const uint8_t *p_data, uint32_t length)
+{
+  print_mem_t *p_mem = (print_mem_t *)p_arg;
+
+  for (uint32_t i=0; i<length; i++)
+  {
+    if (p_mem->index + 1 < p_mem->size)
+    {
+      p_mem->p_buf[p_mem->index++] = p_data[i];
+    }
+  }
+}
+
+int32_t printVSnprintf(char *p_buf, uint32_t size, const char *fmt, va_list arg)
+{
+  print_mem_t mem;
+  uint32_t    total;
+
+
+  mem.p_buf = p_buf;
+  mem.size  = size;
+  mem.index = 0;
+
+  total = printFormat(printOutMem, &mem, fmt, arg);
+  if (size > 0)
+  {
+    p_buf[mem.index] = 0;
+  }
+
+  return (int32_t)total;
+}
+
+int32_t printSnprintf(char *p_buf, uint32_t size, const char *fmt, ...)
+{
+  va_list arg;
+  int32_t ret;
+
+  va_start(arg, fmt);
+  ret = printVSnprintf(p_buf, size, fmt, arg);
+  va_end(arg);
+
+  return ret;
+}
+
+
+#if CLI_USE(HW_PRINT)
+typedef int (*print_vsnprintf_t)(char *p_buf, size_t size, const char *fmt, va_list arg);
+
+static int printVSnprintfWrap(char *p_buf, size_t size, const char *fmt, va_list arg)
+{
+  return printVSnprintf(p_buf, size, fmt, arg);
+}
+
+static uint32_t printBench(print_vsnprintf_t p_func, uint32_t index, uint32_t count, ...)
+{
+  static char buf[128];
+  va_list  arg;
+  uint32_t pre_cycles;
+  uint32_t exe_cycles = 0;
+  const char *fmt_tbl[] =
+  {
+    "%d %s 0x%08X\n",
+    "%-8s %5u %02x%02x\n",
+    "ch %d : %d.%02d V, %.2f ms\n",
+  };
+
+  for (uint32_t i=0; i<count; i++)
+  {
+    va_start(arg, count);
+    pre_cycles = cycles();
+    p_func(buf, sizeof(buf), fmt_tbl[index], arg);
+    exe_cycles += cycles() - pre_cycles;
+    va_end(arg);
+  }
+
+  return exe_cycles / count;
+}
+
+void cliPrint(cli_args_t *args)
+{
+  bool ret = false;
+
+
+  if (args->argc == 1 && args->isStr(0, "bench") == true)
+  {
+    const uint32_t count = 100;
+    uint32_t print_cycles[3];
+
+    print_cycles[0] = printBench(printVSnprintfWrap, 0, count, -1234, "qspi", 0x9000ABCD);
+    print_cycles[1] = printBench(printVSnprintfWrap, 1, count, "fs", 512, 0xAB, 0xCD);
+    print_cycles[2] = printBench(printVSnprintfWrap, 2, count, 1, 3, 30, 7.5);
+
+#if PRINT_USE_BENCH_NEWLIB == 1
+    uint32_t newlib_cycles[3];
+
+    newlib_cycles[0] = printBench(vsnprintf, 0, count, -1234, "qspi", 0x9000ABCD);
+    newlib_cycles[1] = printBench(vsnprintf, 1, count, "fs", 512, 0xAB, 0xCD);
+    newlib_cycles[2] = printBench(vsnprintf, 2, count, 1, 3, 30, 7.5);
+
+    cliPrintf("fmt  newlib   print    (cycles/call)\n");
+    for (int i=0; i<3; i++)
+    {
+      cliPrintf("%-3d  %-7d  %-7d\n", i, (int)newlib_cycles[i], (int)print_cycles[i]);
+    }
+#else
+    cliPrintf("fmt  print    (cycles/call)\n");
+    for (int i=0; i<3; i++)
+    {
+      cliPrintf("%-3d  %-7d\n", i, (int)print_cycles[i]);
+    }
+#endif
+    cliPrintf("chunk : %d bytes on stack\n", PRINT_CHUNK_MAX);
+    ret = true;
+  }
+
+  if (args->argc == 1 && args->isStr(0, "test") == true)
+  {
+    cliPrintf("[%d] [%5d] [%-5d] [%05d] [%+d]\n", -12, 34, 56, -78, 9);
+    cliPrintf("[%u] [%x] [%X] [%08X] [%p]\n", 4000000000U, 0xbeef, 0xbeef, 0x1234, (void *)args);
+    cliPrintf("[%s] [%-6s] [%6s] [%.2s] [%c]\n", "abc", "ab", "ab", "abc", 'z');
+    cliPrintf("[%ld] [%lu] [%lx] [%*d]\n", -1L, 1UL, 0xABCDUL, 4, 5);
+    cliPrintf("[%f] [%.2f] [%8.3f] [%.0f]\n", 3.14159, -0.125, 2.5, 9.5);
+    ret = true;
+  }
+
+  if (ret != true)
+  {
+    cliPrintf("print bench\n");
+    cliPrintf("print test\n");
+  }
+}
+#endif
@@ -0,0 +1,42 @@
+#ifndef PRINT_H_
+#define PRINT_H_
+
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+
+#include "def.h"
+
+
+#ifndef PRINT_CHUNK_MAX
+#define PRINT_CHUNK_MAX       32
+#endif
+
+#ifndef PRINT_USE_FLOAT
+#define PRINT_USE_FLOAT       1
+#endif
+
+// "print bench" 에서 newlib vsnprintf 와 비교한다. 켜면 newlib printf 가 같이 링크된다.
+#ifndef PRINT_USE_BENCH_NEWLIB
+#define PRINT_USE_BENCH_NEWLIB  0
+#endif
+
+
+// 변환된 문자열은 PRINT_CHUNK_MAX 단위로 p_out 에 넘어간다.
+typedef void (*print_out_t)(void *p_arg, const uint8_t *p_data, uint32_t length);
+
+
+void     printInit(void);
+uint32_t printFormat(print_out_t p_out, void *p_arg, const char *fmt, va_list arg);
+int32_t  printSnprintf(char *p_buf, uint32_t size, const char *fmt, ...);
+int32_t  printVSnprintf(char *p_buf, uint32_t size, const char *fmt, va_list arg);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif
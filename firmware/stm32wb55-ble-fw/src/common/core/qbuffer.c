@@ -1,12 +1,86 @@
 #include "qbuffer.h"
 
 
+// in 은 producer 만, out 은 consumer 만 갱신한다(SPSC).
+// 상대편 index 는 acquire 로 읽고 자신의 index 는 release 로 발행해서
+// 데이터 복사가 index 갱신보다 먼저 보이도록 한다.
+#define qbufferLoad(p)          __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define qbufferStore(p, v)      __atomic_store_n((p), (v), __ATOMIC_RELEASE)
 
 
 
-void qbufferInit(void)
+static uint32_t   qbuffer_cnt = 0;
+static qbuffer_t *qbuffer_list[QBUFFER_LIST_MAX];
+
+
+
+
+static inline uint32_t qbufferWrap(qbuffer_t *p_node, uint32_t index)
+{
+  if (p_node->mask != 0)
+  {
+    return index & p_node->mask;
+  }
+  if (index >= p_node->len)
+  {
+    index -= p_node->len;
+  }
+  return index;
+}
+
+static uint32_t qbufferGetMask(uint32_t length)
+{
+  if (length >= 2 && (length & (length - 1)) == 0)
+  {
+    return length - 1;
+  }
+  return 0;
+}
+
+static void qbufferRegister(qbuffer_t *p_node)
+{
+  for (uint32_t i=0; i<qbuffer_cnt; i++)
+  {
+    if (qbuffer_list[i] == p_node)
+    {
+      return;
+    }
+  }
+
+  if (qbuffer_cnt < QBUFFER_LIST_MAX)
+  {
+    qbuffer_list[qbuffer_cnt++] = p_node;
+  }
+}
+
+static void qbufferUnregister(qbuffer_t *p_node)
 {
+  for (uint32_t i=0; i<qbuffer_cnt; i++)
+  {
+    if (qbuffer_list[i] == p_node)
+    {
+      qbuffer_cnt--;
+      for (; i<qbuffer_cnt; i++)
+      {
+        qbuffer_list[i] = qbuffer_list[i + 1];
+      }
+      qbuffer_list[qbuffer_cnt] = NULL;
+      return;
+    }
+  }
+}
 
+static inline void qbufferUpdatePeak(qbuffer_t *p_node, uint32_t used_len)
+{
+  if (used_len > p_node->stat.peak)
+  {
+    p_node->stat.peak = used_len;
+  }
+}
+
+
+void qbufferInit(void)
+{
 }
 
 bool qbufferCreate(qbuffer_t *p_node, uint8_t *p_buf, uint32_t length)
@@ -17,8 +91,14 @@ bool qbufferCreate(qbuffer_t *p_node, uint8_t *p_buf, uint32_t length)
   p_node->out   = 0;
   p_node->len   = length;
   p_node->size  = 1;
+  p_node->mask  = qbufferGetMask(length);
   p_node->p_buf = p_buf;
 
+  p_node->is_overwrite = false;
+  p_node->p_name       = NULL;
+  qbufferClearStat(p_node);
+  qbufferRegister(p_node);
+
   return ret;
 }
 
@@ -30,78 +110,206 @@ bool qbufferCreateBySize(qbuffer_t *p_node, uint8_t *p_buf, uint32_t size, uint3
   p_node->out   = 0;
   p_node->len   = length;
   p_node->size  = size;
+  p_node->mask  = qbufferGetMask(length);
   p_node->p_buf = p_buf;
 
+  p_node->is_overwrite = false;
+  p_node->p_name       = NULL;
+  qbufferClearStat(p_node);
+  qbufferRegister(p_node);
+
   return ret;
 }
 
+// 임시로 만든 queue 를 registry 에서 뺀다. 다시 쓰려면 qbufferCreate() 부터 한다.
+void qbufferDelete(qbuffer_t *p_node)
+{
+  qbufferUnregister(p_node);
+
+  p_node->in    = 0;
+  p_node->out   = 0;
+  p_node->len   = 0;
+  p_node->p_buf = NULL;
+}
+
 bool qbufferWrite(qbuffer_t *p_node, uint8_t *p_data, uint32_t length)
 {
-  bool ret = true;
-  uint32_t next_in;
+  bool     ret = true;
+  uint32_t in  = p_node->in;
+  uint32_t used_len;
+  uint32_t free_len;
+  uint32_t seg_len;
 
 
-  for (int i=0; i<length; i++)
+  used_len = qbufferAvailable(p_node);
+  free_len = p_node->len - used_len - 1;
+  if (length > free_len)
   {
-    next_in = (p_node->in + 1) % p_node->len;
-
-    if (next_in != p_node->out)
+    if (p_node->is_overwrite == true)
     {
-      if (p_node->p_buf != NULL && p_data != NULL)
-      {
-        uint8_t *p_buf;
+      uint32_t cap_len = p_node->len - 1;
 
-        p_buf = &p_node->p_buf[p_node->in*p_node->size];
-        for (int j=0; j<p_node->size; j++)
+      // 한번에 링보다 큰 데이터는 뒤쪽만 남긴다.
+      if (length > cap_len)
+      {
+        if (p_data != NULL)
         {
-          p_buf[j] = p_data[j];
+          p_data += (length - cap_len) * p_node->size;
         }
-        p_data += p_node->size;
+        p_node->stat.drop_bytes += (length - cap_len) * p_node->size;
+        length = cap_len;
+      }
+
+      if (length > free_len)
+      {
+        qbufferStore(&p_node->out, qbufferWrap(p_node, p_node->out + (length - free_len)));
+        p_node->stat.drop_bytes += (length - free_len) * p_node->size;
+        used_len -= (length - free_len);
       }
-      p_node->in = next_in;
     }
     else
     {
-      ret = false;
-      break;
+      p_node->stat.drop_bytes += (length - free_len) * p_node->size;
+      length = free_len;
+      ret    = false;
     }
   }
 
+  if (length == 0)
+  {
+    return ret;
+  }
+
+  if (p_node->p_buf != NULL && p_data != NULL)
+  {
+    seg_len = p_node->len - in;
+    if (seg_len > length)
+    {
+      seg_len = length;
+    }
+
+    memcpy(&p_node->p_buf[in * p_node->size], p_data, seg_len * p_node->size);
+    if (length > seg_len)
+    {
+      memcpy(&p_node->p_buf[0], &p_data[seg_len * p_node->size], (length - seg_len) * p_node->size);
+    }
+  }
+  qbufferStore(&p_node->in, qbufferWrap(p_node, in + length));
+
+  p_node->stat.in_bytes += length * p_node->size;
+  qbufferUpdatePeak(p_node, used_len + length);
+
   return ret;
 }
 
 bool qbufferRead(qbuffer_t *p_node, uint8_t *p_data, uint32_t length)
 {
-  bool ret = true;
+  bool     ret = true;
+  uint32_t out = p_node->out;
+  uint32_t used_len;
+  uint32_t seg_len;
 
 
-  for (int i=0; i<length; i++)
+  used_len = qbufferAvailable(p_node);
+  if (length > used_len)
   {
-    if (p_node->p_buf != NULL && p_data != NULL)
-    {
-      uint8_t *p_buf;
+    length = used_len;
+    ret    = false;
+  }
 
-      p_buf = &p_node->p_buf[p_node->out*p_node->size];
-      for (int j=0; j<p_node->size; j++)
-      {
-        p_data[j] = p_buf[j];
-      }
+  if (length == 0)
+  {
+    return ret;
+  }
 
-      p_data += p_node->size;
+  if (p_node->p_buf != NULL && p_data != NULL)
+  {
+    seg_len = p_node->len - out;
+    if (seg_len > length)
+    {
+      seg_len = length;
     }
 
-    if (p_node->out != p_node->in)
+    memcpy(p_data, &p_node->p_buf[out * p_node->size], seg_len * p_node->size);
+    if (length > seg_len)
     {
-      p_node->out = (p_node->out + 1) % p_node->len;
+      memcpy(&p_data[seg_len * p_node->size], &p_node->p_buf[0], (length - seg_len) * p_node->size);
     }
-    else
+  }
+  qbufferStore(&p_node->out, qbufferWrap(p_node, out + length));
+
+  p_node->stat.out_bytes += length * p_node->size;
+
+  return ret;
+}
+
+uint32_t qbufferReserve(qbuffer_t *p_node, uint8_t **pp_data, uint32_t length)
+{
+  uint32_t in  = p_node->in;
+  uint32_t out = qbufferLoad(&p_node->out);
+  uint32_t cont_len;
+
+
+  if (in >= out)
+  {
+    cont_len = p_node->len - in;
+    if (out == 0)
     {
-      ret = false;
-      break;
+      cont_len -= 1;
     }
   }
+  else
+  {
+    cont_len = out - in - 1;
+  }
 
-  return ret;
+  if (length > cont_len)
+  {
+    length = cont_len;
+  }
+  *pp_data = &p_node->p_buf[in * p_node->size];
+
+  return length;
+}
+
+void qbufferCommit(qbuffer_t *p_node, uint32_t length)
+{
+  qbufferStore(&p_node->in, qbufferWrap(p_node, p_node->in + length));
+
+  p_node->stat.in_bytes += length * p_node->size;
+  qbufferUpdatePeak(p_node, qbufferAvailable(p_node));
+}
+
+uint32_t qbufferPeek(qbuffer_t *p_node, uint8_t **pp_data, uint32_t length)
+{
+  uint32_t in  = qbufferLoad(&p_node->in);
+  uint32_t out = p_node->out;
+  uint32_t cont_len;
+
+
+  if (in >= out)
+  {
+    cont_len = in - out;
+  }
+  else
+  {
+    cont_len = p_node->len - out;
+  }
+
+  if (length > cont_len)
+  {
+    length = cont_len;
+  }
+  *pp_data = &p_node->p_buf[out * p_node->size];
+
+  return length;
+}
+
+void qbufferConsume(qbuffer_t *p_node, uint32_t length)
+{
+  qbufferStore(&p_node->out, qbufferWrap(p_node, p_node->out + length));
+
+  p_node->stat.out_bytes += length * p_node->size;
 }
 
 uint8_t *qbufferPeekWrite(qbuffer_t *p_node)
@@ -118,15 +326,78 @@ uint8_t *qbufferPeekRead(qbuffer_t *p_node)
 uint32_t qbufferAvailable(qbuffer_t *p_node)
 {
   uint32_t ret;
+  uint32_t in  = qbufferLoad(&p_node->in);
+  uint32_t out = qbufferLoad(&p_node->out);
 
 
-  ret = (p_node->len + p_node->in - p_node->out) % p_node->len;
+  if (p_node->mask != 0)
+  {
+    ret = (in - out) & p_node->mask;
+  }
+  else
+  {
+    ret = (in >= out) ? (in - out) : (p_node->len + in - out);
+  }
 
   return ret;
 }
 
+void qbufferAvailableSpan(qbuffer_t *p_node, qbuffer_span_t *p_span)
+{
+  uint32_t in  = qbufferLoad(&p_node->in);
+  uint32_t out = qbufferLoad(&p_node->out);
+
+
+  if (in >= out)
+  {
+    p_span->used    = in - out;
+    p_span->rd_cont = in - out;
+    p_span->wr_cont = p_node->len - in;
+    if (out == 0)
+    {
+      p_span->wr_cont -= 1;
+    }
+  }
+  else
+  {
+    p_span->used    = p_node->len + in - out;
+    p_span->rd_cont = p_node->len - out;
+    p_span->wr_cont = out - in - 1;
+  }
+  p_span->free = p_node->len - p_span->used - 1;
+}
+
 void qbufferFlush(qbuffer_t *p_node)
 {
   p_node->in  = 0;
   p_node->out = 0;
-}
\ No newline at end of file
+}
+
+void qbufferSetName(qbuffer_t *p_node, const char *p_name)
+{
+  p_node->p_name = p_name;
+}
+
+void qbufferSetOverwrite(qbuffer_t *p_node, bool enable)
+{
+  p_node->is_overwrite = enable;
+}
+
+void qbufferClearStat(qbuffer_t *p_node)
+{
+  memset(&p_node->stat, 0, sizeof(p_node->stat));
+}
+
+uint32_t qbufferGetCount(void)
+{
+  return qbuffer_cnt;
+}
+
+qbuffer_t *qbufferGetNode(uint32_t index)
+{
+  if (index >= qbuffer_cnt)
+  {
+    return NULL;
+  }
+  return qbuffer_list[index];
+}
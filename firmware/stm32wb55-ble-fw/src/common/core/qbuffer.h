@@ -9,6 +9,18 @@ extern "C" {
 #include "def.h"
 
 
+#ifndef QBUFFER_LIST_MAX
+#define QBUFFER_LIST_MAX      16
+#endif
+
+
+typedef struct
+{
+  uint32_t in_bytes;
+  uint32_t out_bytes;
+  uint32_t drop_bytes;
+  uint32_t peak;      // max elements stored
+} qbuffer_stat_t;
 
 typedef struct
 {
@@ -16,25 +28,53 @@ typedef struct
   uint32_t out;
   uint32_t len;
   uint32_t size;
+  uint32_t mask;      // len - 1 when len is a power of two, otherwise 0
+
+  // overwrite 모드에서는 producer 가 out 도 옮기므로
+  // consumer 와 같은 context 에서 쓰거나 유실을 허용하는 trace 용도로만 쓴다.
+  bool        is_overwrite;
+  const char *p_name;
+
+  qbuffer_stat_t stat;
 
   uint8_t *p_buf;
 } qbuffer_t;
 
+typedef struct
+{
+  uint32_t used;      // elements stored
+  uint32_t free;      // elements that can still be written
+  uint32_t rd_cont;   // elements readable without wrapping
+  uint32_t wr_cont;   // elements writable without wrapping
+} qbuffer_span_t;
+
 
 void     qbufferInit(void);
 bool     qbufferCreate(qbuffer_t *p_node, uint8_t *p_buf, uint32_t length);
 bool     qbufferCreateBySize(qbuffer_t *p_node, uint8_t *p_buf, uint32_t size, uint32_t length);
+void     qbufferDelete(qbuffer_t *p_node);
 bool     qbufferWrite(qbuffer_t *p_node, uint8_t *p_data, uint32_t length);
 bool     qbufferRead(qbuffer_t *p_node, uint8_t *p_data, uint32_t length);
+uint32_t qbufferReserve(qbuffer_t *p_node, uint8_t **pp_data, uint32_t length);
+void     qbufferCommit(qbuffer_t *p_node, uint32_t length);
+uint32_t qbufferPeek(qbuffer_t *p_node, uint8_t **pp_data, uint32_t length);
+void     qbufferConsume(qbuffer_t *p_node, uint32_t length);
 uint8_t *qbufferPeekWrite(qbuffer_t *p_node);
 uint8_t *qbufferPeekRead(qbuffer_t *p_node);
 uint32_t qbufferAvailable(qbuffer_t *p_node);
+void     qbufferAvailableSpan(qbuffer_t *p_node, qbuffer_span_t *p_span);
 void     qbufferFlush(qbuffer_t *p_node);
 
+void     qbufferSetName(qbuffer_t *p_node, const char *p_name);
+void     qbufferSetOverwrite(qbuffer_t *p_node, bool enable);
+void     qbufferClearStat(qbuffer_t *p_node);
+uint32_t qbufferGetCount(void);
+qbuffer_t *qbufferGetNode(uint32_t index);
+
 
 
 #ifdef __cplusplus
 }
 #endif
 
-#endif
\ No newline at end of file
+#endif
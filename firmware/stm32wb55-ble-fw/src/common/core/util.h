@@ -14,6 +14,7 @@ uint32_t utilConvert8ToU32 (uint8_t *p_data);
 uint16_t utilConvert8ToU16 (uint8_t *p_data);
 
 void utilUpdateCrc(uint16_t *p_crc_cur, uint8_t data_in);
+uint32_t utilUpdateCrc32(uint32_t crc, const uint8_t *p_data, uint32_t length);
 
 #ifdef __cplusplus
 }
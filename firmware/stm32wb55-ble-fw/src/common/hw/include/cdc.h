@@ -18,9 +18,13 @@ bool     cdcIsInit(void);
 bool     cdcIsConnect(void);
 uint32_t cdcAvailable(void);
 uint8_t  cdcRead(void);
+uint32_t cdcReadBlock(uint8_t *p_data, uint32_t length);
+uint32_t cdcPeekSpan(uint8_t **pp_data);
+void     cdcConsume(uint32_t length);
 uint32_t cdcWrite(uint8_t *p_data, uint32_t length);
 uint32_t cdcGetBaud(void);
 uint8_t  cdcGetType(void);
+bool     cdcAttachRxEvent(void (*p_func)(void));
 
 #endif
 
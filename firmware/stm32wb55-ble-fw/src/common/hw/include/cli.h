@@ -14,10 +14,21 @@ extern "C" {
 
 #define CLI_CMD_LIST_MAX      HW_CLI_CMD_LIST_MAX
 #define CLI_CMD_NAME_MAX      HW_CLI_CMD_NAME_MAX
+#define CLI_CMD_HASH_MAX      HW_CLI_CMD_HASH_MAX
 
 #define CLI_LINE_HIS_MAX      HW_CLI_LINE_HIS_MAX
 #define CLI_LINE_BUF_MAX      HW_CLI_LINE_BUF_MAX
 
+#ifdef HW_CLI_SESSION_MAX
+#define CLI_SESSION_MAX       HW_CLI_SESSION_MAX
+#else
+#define CLI_SESSION_MAX       1
+#endif
+
+#ifdef HW_CLI_STAT_MAX
+#define CLI_STAT_MAX          HW_CLI_STAT_MAX
+#endif
+
 
 
 
@@ -25,6 +36,8 @@ typedef struct
 {
   uint16_t   argc;
   char     **argv;
+  uint8_t    ch;          // 명령을 실행한 session 의 uart 채널
+  uint8_t    session;
 
   int32_t  (*getData)(uint8_t index);
   float    (*getFloat)(uint8_t index);
@@ -33,6 +46,52 @@ typedef struct
 } cli_args_t;
 
 
+#define CLI_ARGC_ANY          0xFF
+
+// 명령과 하위 명령은 const table 로 정의하고 cliAddItem() 으로 등록한다.
+// leaf 의 argc 는 명령 이름들을 뺀 나머지 인자 수이고 범위는 framework 가 검사한다.
+typedef struct cli_item_s
+{
+  const char               *name;
+  void                    (*func)(cli_args_t *args);
+  const struct cli_item_s  *p_sub;
+  uint8_t                   sub_cnt;
+  uint8_t                   argc_min;
+  uint8_t                   argc_max;
+  const char               *usage;
+} cli_item_t;
+
+// 오래 걸리는 명령은 job 으로 나누어 superloop 에 양보한다.
+// func 는 한 조각만 처리하고 true 를 돌려주면 다음 조각이 이어서 호출된다.
+// Ctrl-C 를 받으면 is_cancel 이 세워진 채로 호출되므로 정리하고 false 를 돌려준다.
+typedef struct cli_job_s
+{
+  const char  *name;
+  bool       (*func)(struct cli_job_s *p_job);
+  bool         is_cancel;
+  bool         ret;
+  uint8_t      step;
+  const char  *p_stage;
+  uint32_t     done;
+  uint32_t     total;
+  uint32_t     arg[4];
+
+  uint8_t      percent;
+  uint32_t     start_time;
+  uint32_t     loop_time;
+  uint32_t     loop_max;     // job 이 도는 동안 superloop 한 바퀴의 최대 시간 (ms)
+  uint32_t     run_us;       // func 안에서 보낸 시간
+
+  struct cli_job_s *p_parent;
+  struct cli_job_s *p_child;
+  bool         child_ret;    // 마지막으로 끝난 하위 job 의 결과
+} cli_job_t;
+
+
+#define CLI_ITEM(name, func, argc_min, argc_max, usage)   { name, func, NULL, 0, argc_min, argc_max, usage }
+#define CLI_GROUP(name, sub_tbl, usage)                   { name, NULL, sub_tbl, sizeof(sub_tbl)/sizeof(cli_item_t), 0, 0, usage }
+
+
 bool cliInit(void);
 bool cliOpen(uint8_t ch, uint32_t baud);
 bool cliIsBusy(void);
@@ -41,6 +100,7 @@ void cliLogo(void);
 bool cliMain(void);
 void cliPrintf(const char *fmt, ...);
 bool cliAdd(const char *cmd_str, void (*p_func)(cli_args_t *));
+bool cliAddItem(const cli_item_t *p_item);
 bool cliKeepLoop(void);
 void cliPutch(uint8_t data);
 uint8_t  cliGetPort(void);
@@ -48,10 +108,16 @@ uint32_t cliAvailable(void);
 uint8_t  cliRead(void);
 uint32_t cliWrite(uint8_t *p_data, uint32_t length);
 bool cliRunStr(const char *fmt, ...);
+void cliSetError(void);
+bool cliIsError(void);
 void cliShowCursor(bool visibility);
 void cliMoveUp(uint8_t y);
 void cliMoveDown(uint8_t y);
 
+bool cliJobIsIdle(cli_job_t *p_job, const char *name);
+bool cliJobStart(cli_job_t *p_job, const char *name, bool (*p_func)(cli_job_t *p_job));
+void cliJobStage(cli_job_t *p_job, const char *p_stage, uint32_t total);
+
 #endif
 
 #ifdef __cplusplus
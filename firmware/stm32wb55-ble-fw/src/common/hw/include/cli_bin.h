@@ -0,0 +1,90 @@
+#ifndef CLI_BIN_H_
+#define CLI_BIN_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "hw_def.h"
+
+
+#ifdef _USE_HW_CLI_BIN
+
+#define CLI_BIN_DATA_MAX      HW_CLI_BIN_DATA_MAX
+#define CLI_BIN_CMD_MAX       HW_CLI_BIN_CMD_MAX
+
+#define CLI_BIN_PACKET_MAX    (3 + 1 + CLI_BIN_DATA_MAX + 2)
+#define CLI_BIN_FRAME_MAX     (CLI_BIN_PACKET_MAX + CLI_BIN_PACKET_MAX/254 + 1)
+
+// frame 이 끝난 뒤 이 시간 안에 이어지는 byte 는 다음 frame 으로 받는다.
+#ifndef HW_CLI_BIN_NEXT_MS
+#define HW_CLI_BIN_NEXT_MS    50
+#endif
+#define CLI_BIN_NEXT_MS       HW_CLI_BIN_NEXT_MS
+
+
+// 0x00 으로 구분되는 COBS frame. 이어지는 frame 은 구분자 하나를 같이 쓸 수 있다.
+//   req  : [seq:1] [cmd:2] [data:n] [crc16:2]
+//   resp : [seq:1] [cmd:2] [status:1] [data:n] [crc16:2]
+//   crc16 은 utilUpdateCrc() (poly 0x8005, init 0) 를 쓰고 little endian 이다.
+#define CLI_BIN_CMD_PING      0x0000
+#define CLI_BIN_CMD_INFO      0x0001
+#define CLI_BIN_CMD_LIST      0x0002
+
+typedef enum
+{
+  CLI_BIN_OK = 0,
+  CLI_BIN_ERR_CRC,
+  CLI_BIN_ERR_CMD,
+  CLI_BIN_ERR_LENGTH,
+  CLI_BIN_ERR_PARAM,
+  CLI_BIN_ERR_FAIL,
+} cli_bin_status_t;
+
+typedef struct
+{
+  uint8_t   seq;
+  uint16_t  cmd;
+
+  uint8_t  *p_req;
+  uint16_t  req_len;
+  uint16_t  req_index;
+
+  uint8_t  *p_resp;
+  uint16_t  resp_len;
+  uint16_t  resp_max;
+} cli_bin_t;
+
+// 수신 frame 상태는 CLI session 마다 따로 둔다.
+typedef struct
+{
+  bool      is_frame;
+  bool      is_next;      // frame 을 막 끝내고 다음 frame 을 기다리는 중
+  uint32_t  pre_time;
+  uint16_t  rx_len;
+  uint8_t   rx_buf[CLI_BIN_FRAME_MAX];
+} cli_bin_rx_t;
+
+
+bool cliBinInit(void);
+bool cliBinInitRx(cli_bin_rx_t *p_rx);
+bool cliBinUpdate(cli_bin_rx_t *p_rx, uint8_t ch, uint8_t rx_data);
+bool cliBinAdd(uint16_t cmd, const char *name, cli_bin_status_t (*p_func)(cli_bin_t *p_bin));
+
+bool cliBinGetU8(cli_bin_t *p_bin, uint8_t *p_data);
+bool cliBinGetU16(cli_bin_t *p_bin, uint16_t *p_data);
+bool cliBinGetU32(cli_bin_t *p_bin, uint32_t *p_data);
+bool cliBinGetBytes(cli_bin_t *p_bin, uint8_t **pp_data, uint16_t length);
+bool cliBinPutU8(cli_bin_t *p_bin, uint8_t data);
+bool cliBinPutU16(cli_bin_t *p_bin, uint16_t data);
+bool cliBinPutU32(cli_bin_t *p_bin, uint32_t data);
+bool cliBinPutBytes(cli_bin_t *p_bin, const uint8_t *p_data, uint16_t length);
+uint8_t *cliBinReserve(cli_bin_t *p_bin, uint16_t length);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
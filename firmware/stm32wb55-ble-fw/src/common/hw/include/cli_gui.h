@@ -142,9 +142,15 @@ typedef struct
   void      (*drawBoxLine)(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const char *title);
   void      (*drawBox)(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const char *title);
   void      (*eraseBox)(uint8_t x, uint8_t y, uint8_t w, uint8_t h);
+
+  // frame 모드에서는 그리기가 off-screen buffer 에 쌓이고 flush() 가 바뀐 칸만 보낸다.
+  void      (*setFrame)(bool enable);
+  uint32_t  (*flush)(uint32_t byte_max);
+  void      (*invalidate)(void);
 } cli_gui_api_t;
 
 
+bool cliGuiInit(void);
 cli_gui_api_t *cliGui(void);
 
 
@@ -0,0 +1,23 @@
+#ifndef CLI_QBUFFER_H_
+#define CLI_QBUFFER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "hw_def.h"
+#include "cli.h"
+
+
+#if CLI_USE(HW_QBUFFER)
+
+// qbuffer 의 list/clear/bench 명령. qbuffer.c 는 CLI 를 모르도록 여기로 뺀다.
+bool cliQbufferInit(void);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef CLI_RUN_H_
+#define CLI_RUN_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "hw_def.h"
+
+
+#ifdef _USE_HW_CLI_RUN
+
+#define CLI_RUN_VAR_MAX       HW_CLI_RUN_VAR_MAX
+#define CLI_RUN_LOOP_MAX      HW_CLI_RUN_LOOP_MAX
+
+
+// littlefs 의 script 파일을 한 줄씩 읽어서 CLI 명령으로 실행한다.
+//   # comment
+//   set  name value         : $name, ${name} 으로 치환, run 인자는 $1 ~ $9
+//   repeat count [name]     : end 까지 반복, name 에 0 ~ count-1
+//   end
+//   echo text
+//   onerror stop:continue   : 기본은 stop
+bool cliRunInit(void);
+bool cliRunFile(const char *file_name);
+bool cliRunBoot(void);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -15,13 +15,110 @@ extern "C" {
 #define LOG_BOOT_BUF_MAX  HW_LOG_BOOT_BUF_MAX
 #define LOG_LIST_BUF_MAX  HW_LOG_LIST_BUF_MAX
 
+#define LOG_DEFER_ARG_MAX 6
+
+#define LOG_ARGC(...)                         LOG_ARGC_(0, ##__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0)
+#define LOG_ARGC_(z, a1, a2, a3, a4, a5, a6, n, ...)  n
+
+// 인자는 32bit 정수/포인터만 지원하고 %s 는 flash 의 상수 문자열이어야 한다.
+// 문자열은 host 에서 tools/log_decode.py 가 ELF 를 보고 복원한다.
+#define logDefer(fmt, ...)  logDeferPrintf(fmt, LOG_ARGC(__VA_ARGS__), ##__VA_ARGS__)
+
+
+#define LOG_LEVEL_NONE    0
+#define LOG_LEVEL_ERROR   1
+#define LOG_LEVEL_WARN    2
+#define LOG_LEVEL_INFO    3
+#define LOG_LEVEL_DEBUG   4
+#define LOG_LEVEL_TRACE   5
+
+// 모듈별 최소 레벨은 hw_def.h 나 빌드 옵션(-DHW_LOG_LEVEL_xxx)으로 정한다.
+// 이보다 높은 레벨의 호출은 format 문자열까지 컴파일에서 빠진다.
+#ifndef HW_LOG_LEVEL
+#define HW_LOG_LEVEL          LOG_LEVEL_INFO
+#endif
+#ifndef HW_LOG_LEVEL_SYS
+#define HW_LOG_LEVEL_SYS      HW_LOG_LEVEL
+#endif
+#ifndef HW_LOG_LEVEL_FS
+#define HW_LOG_LEVEL_FS       HW_LOG_LEVEL
+#endif
+#ifndef HW_LOG_LEVEL_QSPI
+#define HW_LOG_LEVEL_QSPI     HW_LOG_LEVEL
+#endif
+#ifndef HW_LOG_LEVEL_EEPROM
+#define HW_LOG_LEVEL_EEPROM   HW_LOG_LEVEL
+#endif
+#ifndef HW_LOG_LEVEL_FLASH
+#define HW_LOG_LEVEL_FLASH    HW_LOG_LEVEL
+#endif
+#ifndef HW_LOG_LEVEL_NVS
+#define HW_LOG_LEVEL_NVS      HW_LOG_LEVEL
+#endif
+#ifndef HW_LOG_LEVEL_BUTTON
+#define HW_LOG_LEVEL_BUTTON   HW_LOG_LEVEL
+#endif
+#ifndef HW_LOG_LEVEL_USB
+#define HW_LOG_LEVEL_USB      HW_LOG_LEVEL
+#endif
+#ifndef HW_LOG_LEVEL_BLE
+#define HW_LOG_LEVEL_BLE      HW_LOG_LEVEL
+#endif
+
+typedef enum
+{
+  LOG_MOD_SYS,
+  LOG_MOD_FS,
+  LOG_MOD_QSPI,
+  LOG_MOD_EEPROM,
+  LOG_MOD_FLASH,
+  LOG_MOD_NVS,
+  LOG_MOD_BUTTON,
+  LOG_MOD_USB,
+  LOG_MOD_BLE,
+  LOG_MOD_MAX
+} log_mod_t;
+
+// mod 는 FLASH, USB 처럼 CMSIS 매크로와 이름이 겹치므로 바로 붙여서 쓴다.
+#define logLevel(mod_id, mod_level, level, fmt, ...) \
+  do \
+  { \
+    if ((level) <= (mod_level)) \
+      logLevelPrintf(mod_id, level, fmt, ##__VA_ARGS__); \
+  } while (0)
+
+#define logE(mod, fmt, ...)   logLevel(LOG_MOD_##mod, HW_LOG_LEVEL_##mod, LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+#define logW(mod, fmt, ...)   logLevel(LOG_MOD_##mod, HW_LOG_LEVEL_##mod, LOG_LEVEL_WARN,  fmt, ##__VA_ARGS__)
+#define logI(mod, fmt, ...)   logLevel(LOG_MOD_##mod, HW_LOG_LEVEL_##mod, LOG_LEVEL_INFO,  fmt, ##__VA_ARGS__)
+#define logD(mod, fmt, ...)   logLevel(LOG_MOD_##mod, HW_LOG_LEVEL_##mod, LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+#define logT(mod, fmt, ...)   logLevel(LOG_MOD_##mod, HW_LOG_LEVEL_##mod, LOG_LEVEL_TRACE, fmt, ##__VA_ARGS__)
+
 
 bool logInit(void);
 void logEnable(void);
 void logDisable(void);
 bool logOpen(uint8_t ch, uint32_t baud);
 void logBoot(uint8_t enable);
+uint32_t logGetBootCount(void);
+uint32_t logReadBuf(bool is_all, uint32_t offset, uint8_t *p_data, uint32_t length);
+void logReplay(uint8_t ch);
 void logPrintf(const char *fmt, ...);
+void logLevelPrintf(log_mod_t mod, uint8_t level, const char *fmt, ...);
+bool logSetLevel(log_mod_t mod, uint8_t level);
+uint8_t logGetLevel(log_mod_t mod);
+bool logSetDefer(bool enable);
+bool logIsDefer(void);
+void logDeferPrintf(const char *fmt, uint32_t argc, ...);
+bool logDeferProcess(uint32_t max_cnt);
+
+#else
+
+// log 를 쓰지 않는 빌드(host 등)에서도 드라이버를 그대로 컴파일할 수 있도록 한다.
+#define logE(mod, fmt, ...)
+#define logW(mod, fmt, ...)
+#define logI(mod, fmt, ...)
+#define logD(mod, fmt, ...)
+#define logT(mod, fmt, ...)
 
 #endif
 
@@ -0,0 +1,83 @@
+#ifndef PROF_H_
+#define PROF_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "hw_def.h"
+
+
+#ifdef _USE_HW_PROF
+
+#define PROF_SEQ_MAX          HW_PROF_SEQ_MAX
+
+#define PROF_TASK_CLI         (PROF_SEQ_MAX + 0)
+#define PROF_TASK_MAX         (PROF_SEQ_MAX + 1)
+
+
+typedef enum
+{
+  PROF_ISR_USB,
+  PROF_ISR_IPCC,
+  PROF_ISR_TIM17,
+  PROF_ISR_QSPI,
+  PROF_ISR_MAX
+} prof_isr_t;
+
+typedef struct
+{
+  uint32_t count;
+  uint32_t cycles;      // 누적, 32bit 로 wrap 된다 (64Mhz 에서 67초)
+  uint32_t max_cycles;
+} prof_cnt_t;
+
+typedef struct
+{
+  uint32_t start;
+  uint32_t isr;
+  uint32_t task;
+} prof_mark_t;
+
+
+extern volatile uint32_t prof_isr_cycles;
+extern volatile uint32_t prof_task_cycles;
+
+
+// DWT CYCCNT 로 구간의 cycle 을 잰다.
+// 구간 안에서 실행된 ISR 과 중첩된 sequencer task 의 시간은 빼고 자기 시간만 누적한다.
+// begin/end 한 쌍의 비용은 수십 cycle 이고 prof bench 로 확인할 수 있다.
+// hw_def.h 에서 _USE_HW_PROF 를 빼면 아래 매크로는 모두 비어서 비용이 없다.
+static inline void profMarkBegin(prof_mark_t *p_mark)
+{
+  p_mark->isr   = prof_isr_cycles;
+  p_mark->task  = prof_task_cycles;
+  p_mark->start = DWT->CYCCNT;
+}
+
+bool profInit(void);
+void profTaskEnd(uint32_t id, prof_mark_t *p_mark);
+void profIsrEnd(uint32_t id, prof_mark_t *p_mark);
+void profClear(void);
+bool profGetTask(uint32_t id, prof_cnt_t *p_cnt);
+bool profGetIsr(uint32_t id, prof_cnt_t *p_cnt);
+
+#define PROF_TASK_BEGIN()     prof_mark_t prof_mark; profMarkBegin(&prof_mark)
+#define PROF_TASK_END(id)     profTaskEnd(id, &prof_mark)
+#define PROF_ISR_BEGIN()      prof_mark_t prof_mark; profMarkBegin(&prof_mark)
+#define PROF_ISR_END(id)      profIsrEnd(id, &prof_mark)
+
+#else
+
+#define PROF_TASK_BEGIN()
+#define PROF_TASK_END(id)
+#define PROF_ISR_BEGIN()
+#define PROF_ISR_END(id)
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -28,6 +28,12 @@ bool qspiReset(void);
 
 bool qspiRead(uint32_t addr, uint8_t *p_data, uint32_t length);
 bool qspiWrite(uint32_t addr, uint8_t *p_data, uint32_t length);
+bool qspiReadAsync(uint32_t addr, uint8_t *p_data, uint32_t length, void (*p_func)(void *p_arg, bool ret), void *p_arg);
+bool qspiWriteAsync(uint32_t addr, uint8_t *p_data, uint32_t length, void (*p_func)(void *p_arg, bool ret), void *p_arg);
+bool qspiEraseAsync(uint32_t addr, uint32_t length, void (*p_func)(void *p_arg, bool ret), void *p_arg);
+bool qspiIsBusy(void);
+bool qspiGetProgress(uint32_t *p_done, uint32_t *p_length);
+bool qspiCancel(void);
 bool qspiErase(uint32_t addr, uint32_t length);
 bool qspiEraseBlock(uint32_t block_addr);
 bool qspiEraseSector(uint32_t sector_addr);
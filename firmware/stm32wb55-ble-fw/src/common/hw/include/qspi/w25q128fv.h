@@ -74,6 +74,7 @@
   */
 #define W25Q128FV_FLASH_SIZE                  (0x1000000)    /* 128 MBits => 16MBytes */
 #define W25Q128FV_SECTOR_SIZE                 0x10000        /* 256 sectors of 64KBytes */
+#define W25Q128FV_BLOCK_32K_SIZE              0x8000         /* 512 blocks of 32KBytes */
 #define W25Q128FV_SUBSECTOR_SIZE              0x1000         /* 4096 subsectors of 4kBytes */
 #define W25Q128FV_PAGE_SIZE                   0x100          /* 65536 pages of 256 bytes */
 
@@ -82,6 +83,8 @@
 
 #define W25Q128FV_BULK_ERASE_MAX_TIME         250000
 #define W25Q128FV_SECTOR_ERASE_MAX_TIME       3000
+#define W25Q128FV_BLOCK_32K_ERASE_MAX_TIME    1600
+#define W25Q128FV_SUSPEND_MAX_US              20             /* tSUS */
 #define W25Q128FV_SUBSECTOR_ERASE_MAX_TIME    800
 
 /**
@@ -145,6 +148,7 @@
 /* Erase Operations */
 #define SUBSECTOR_ERASE_CMD                  0x20
 #define SECTOR_ERASE_CMD                     0xD8
+#define BLOCK_32K_ERASE_CMD                  0x52
 #define BULK_ERASE_CMD                       0xC7
 
 #define PROG_ERASE_RESUME_CMD                0x7A
@@ -164,6 +168,10 @@
 #define W25Q128FV_SR_PRBOTTOM                 ((uint8_t)0x20)    /*!< Protected memory area defined by BLOCKPR starts from top or bottom */
 #define W25Q128FV_SR_SRWREN                   ((uint8_t)0x80)    /*!< Status register write enable/disable */
 
+/* Status Register 2 */
+#define W25Q128FV_SR2_QE                      ((uint8_t)0x02)    /*!< Quad enable */
+#define W25Q128FV_SR2_SUS                     ((uint8_t)0x80)    /*!< Erase/program suspended */
+
 /* Nonvolatile Configuration Register */
 #define W25Q128FV_NVCR_LOCK                   ((uint16_t)0x0001) /*!< Lock nonvolatile configuration register */
 #define W25Q128FV_NVCR_DUAL                   ((uint16_t)0x0004) /*!< Dual I/O protocol */
@@ -12,21 +12,43 @@ extern "C" {
 #define UART_MAX_CH         HW_UART_MAX_CH
 
 
+typedef enum
+{
+  UART_TX_POLICY_BLOCK,     // 공간이 생길 때까지 기다림(timeout 있음)
+  UART_TX_POLICY_TRUNCATE,  // 들어가는 만큼만 쓰고 나머지는 버림
+  UART_TX_POLICY_DROP,      // 전부 들어가지 않으면 전체를 버림
+} uart_tx_policy_t;
+
+#define UART_RX_EVENT_IDLE      (1<<0)
+#define UART_RX_EVENT_HALF      (1<<1)
+#define UART_RX_EVENT_FULL      (1<<2)
+#define UART_RX_EVENT_OVERRUN   (1<<3)
+
+
 bool     uartInit(void);
 bool     uartDeInit(void);
 bool     uartIsInit(void);
 bool     uartOpen(uint8_t ch, uint32_t baud);
 bool     uartIsOpen(uint8_t ch);
+bool     uartIsConnected(uint8_t ch);
 bool     uartClose(uint8_t ch);
 uint32_t uartAvailable(uint8_t ch);
 bool     uartFlush(uint8_t ch);
 uint8_t  uartRead(uint8_t ch);
+uint32_t uartReadBlock(uint8_t ch, uint8_t *p_data, uint32_t length);
+bool     uartPeekSpan(uint8_t ch, uint8_t **pp_data, uint32_t *p_length);
+bool     uartConsume(uint8_t ch, uint32_t length);
+bool     uartAttachRxEvent(uint8_t ch, void (*p_func)(uint8_t ch, uint32_t event));
 uint32_t uartWrite(uint8_t ch, uint8_t *p_data, uint32_t length);
+uint32_t uartWriteEx(uint8_t ch, uint8_t *p_data, uint32_t length, uart_tx_policy_t policy);
+bool     uartSetTxPolicy(uint8_t ch, uart_tx_policy_t policy);
+bool     uartFlushTx(uint8_t ch);
 uint32_t uartPrintf(uint8_t ch, const char *fmt, ...);
 uint32_t uartVPrintf(uint8_t ch, const char *fmt, va_list arg);
 uint32_t uartGetBaud(uint8_t ch);
 uint32_t uartGetRxCnt(uint8_t ch);
 uint32_t uartGetTxCnt(uint8_t ch);
+uint32_t uartGetRxOverrun(uint8_t ch);
 
 #ifdef __cplusplus
 }
@@ -10,6 +10,10 @@
 
 #include "cli.h"
 #include "uart.h"
+#include "print.h"
+#include "util.h"
+#include "cli_bin.h"
+#include "log.h"
 
 
 #ifdef _USE_HW_CLI
@@ -25,11 +29,21 @@
 #define CLI_KEY_DOWN              0x42
 #define CLI_KEY_HOME              0x31
 #define CLI_KEY_END               0x34
+#define CLI_KEY_CTRL_C            0x03
 
 #define CLI_PROMPT_STR            "cli# "
 
 #define CLI_ARGS_MAX              32
-#define CLI_PRINT_BUF_MAX         256
+
+#ifndef CLI_JOB_SLICE_MS
+#define CLI_JOB_SLICE_MS          2     // 한 loop 에서 job 을 실행하는 최대 시간
+#endif
+
+#define CLI_MD_BIN_CHUNK          512
+#define CLI_MD_B64_CHUNK          384           // base64 512 문자 한 줄
+
+#define CLI_HASH_SEED             0x811C9DC5    // FNV-1a offset basis
+#define CLI_HASH_PRIME            0x01000193
 
 
 enum
@@ -44,10 +58,39 @@ enum
 
 typedef struct
 {
-  char   cmd_str[CLI_CMD_NAME_MAX];
-  void (*cmd_func)(cli_args_t *);
+  char        cmd_str[CLI_CMD_NAME_MAX];
+  cli_item_t  item;
 } cli_cmd_t;
 
+// 모든 레벨의 명령을 (부모 hash, 이름) 으로 한 테이블에 넣어 단계마다 O(1) 로 찾는다.
+typedef struct
+{
+  uint32_t          hash;
+  const cli_item_t *p_parent;
+  const cli_item_t *p_item;
+} cli_slot_t;
+
+typedef struct
+{
+  uint32_t    size;         // 2의 거듭제곱
+  uint32_t    count;
+  cli_slot_t *p_slot;
+} cli_index_t;
+
+
+#ifdef CLI_STAT_MAX
+// 실행된 leaf 명령마다 하나씩 쓴다.
+typedef struct
+{
+  const cli_item_t *p_root;     // 하위 명령이면 최상위 명령, 아니면 NULL
+  const cli_item_t *p_item;
+  uint32_t          count;
+  uint32_t          min_cycles;
+  uint32_t          max_cycles;
+  uint64_t          sum_cycles;
+  uint32_t          tx_bytes;
+} cli_stat_t;
+#endif
 
 typedef struct
 {
@@ -58,17 +101,16 @@ typedef struct
 } cli_line_t;
 
 
+// 포트마다 하나씩 있는 session 상태
 typedef struct
 {
   uint8_t  ch;
   uint32_t baud;
   bool     is_open;
-  bool     is_log;
+  bool     is_connected;
   bool     is_busy;
-  uint8_t  log_ch;
-  uint32_t log_baud;
+  bool     is_error;
   uint8_t  state;
-  char     print_buffer[CLI_PRINT_BUF_MAX];
   uint16_t  argc;
   char     *argv[CLI_ARGS_MAX];
 
@@ -81,14 +123,39 @@ typedef struct
   cli_line_t  line_buf[CLI_LINE_HIS_MAX];
   cli_line_t  line;
 
-  uint16_t    cmd_count;
-  cli_cmd_t   cmd_list[CLI_CMD_LIST_MAX];
   cli_args_t  cmd_args;
+  cli_job_t  *p_job;
+  uint32_t    tx_bytes;
+#ifdef _USE_HW_CLI_BIN
+  cli_bin_rx_t bin_rx;
+#endif
 } cli_t;
 
+// 모든 session 이 같이 쓰는 명령 목록
+typedef struct
+{
+  bool        is_log;
+  uint8_t     log_ch;
+  uint32_t    log_baud;
+
+  uint16_t    cmd_count;
+  cli_cmd_t   cmd_list[CLI_CMD_LIST_MAX];
+  cli_slot_t  cmd_slot[CLI_CMD_HASH_MAX];
+  cli_index_t cmd_index;
+
+#ifdef CLI_STAT_MAX
+  bool        is_footer;
+  uint16_t    stat_count;
+  uint32_t    stat_drop;
+  cli_stat_t  stat[CLI_STAT_MAX];
+#endif
+} cli_cmd_node_t;
+
 
 
-cli_t   cli_node;
+static cli_t          cli_node[CLI_SESSION_MAX];
+static cli_t         *p_cli_cur = &cli_node[0];   // 명령을 실행 중인 session
+static cli_cmd_node_t cli_cmd;
 
 
 
@@ -97,7 +164,6 @@ static void cliLineClean(cli_t *p_cli);
 static void cliLineAdd(cli_t *p_cli);
 static void cliLineChange(cli_t *p_cli, int8_t key_up);
 static void cliShowPrompt(cli_t *p_cli);
-static void cliToUpper(char *str);
 static bool cliRunCmd(cli_t *p_cli);
 static bool cliParseArgs(cli_t *p_cli);
 
@@ -109,100 +175,189 @@ static bool     cliArgsIsStr(uint8_t index, const char *p_str);
 
 void cliShowList(cli_args_t *args);
 void cliMemoryDump(cli_args_t *args);
+#if CLI_USE(HW_CLI)
+static void cliBench(cli_args_t *args);
+static void cliSession(cli_args_t *args);
+static void cliJob(cli_args_t *args);
+#ifdef CLI_STAT_MAX
+static void cliStats(cli_args_t *args);
+#endif
+#endif
+
+
+#if CLI_USE(HW_CLI)
+static const cli_item_t cli_sub_tbl[] =
+{
+  CLI_ITEM("bench", cliBench, 0, 1, "[count]"),
+  CLI_ITEM("session", cliSession, 0, 0, ""),
+  CLI_ITEM("job",     cliJob,     0, 0, ""),
+#ifdef CLI_STAT_MAX
+  CLI_ITEM("stats",   cliStats,   0, 2, "[clear] [footer on:off]"),
+#endif
+};
+
+static const cli_item_t cli_item = CLI_GROUP("cli", cli_sub_tbl, "");
+#endif
 
 
 bool cliInit(void)
 {
-  cli_node.is_open = false;
-  cli_node.is_log  = false;
-  cli_node.is_busy = false;
-  cli_node.state   = CLI_RX_IDLE;
-
-  cli_node.hist_line_i     = 0;
-  cli_node.hist_line_last  = 0;
-  cli_node.hist_line_count = 0;
-  cli_node.hist_line_new   = false;
+  for (int i=0; i<CLI_SESSION_MAX; i++)
+  {
+    cli_t *p_cli = &cli_node[i];
 
-  cli_node.cmd_args.getData  = cliArgsGetData;
-  cli_node.cmd_args.getFloat = cliArgsGetFloat;
-  cli_node.cmd_args.getStr   = cliArgsGetStr;
-  cli_node.cmd_args.isStr    = cliArgsIsStr;
+    p_cli->ch      = 0;
+    p_cli->baud    = 0;
+    p_cli->is_open = false;
+    p_cli->is_connected = false;
+    p_cli->is_busy = false;
+    p_cli->is_error = false;
+    p_cli->state   = CLI_RX_IDLE;
+
+    p_cli->hist_line_i     = 0;
+    p_cli->hist_line_last  = 0;
+    p_cli->hist_line_count = 0;
+    p_cli->hist_line_new   = false;
+
+    p_cli->cmd_args.argc     = 0;
+    p_cli->cmd_args.argv     = NULL;
+    p_cli->cmd_args.ch       = 0;
+    p_cli->cmd_args.session  = i;
+    p_cli->cmd_args.getData  = cliArgsGetData;
+    p_cli->cmd_args.getFloat = cliArgsGetFloat;
+    p_cli->cmd_args.getStr   = cliArgsGetStr;
+    p_cli->cmd_args.isStr    = cliArgsIsStr;
+    p_cli->p_job             = NULL;
+    p_cli->tx_bytes          = 0;
+
+    cliLineClean(p_cli);
+#ifdef _USE_HW_CLI_BIN
+    cliBinInitRx(&p_cli->bin_rx);
+#endif
+  }
+  p_cli_cur = &cli_node[0];
 
-  cliLineClean(&cli_node);
+  cli_cmd.is_log          = false;
+  cli_cmd.cmd_count       = 0;
+  cli_cmd.cmd_index.size  = CLI_CMD_HASH_MAX;
+  cli_cmd.cmd_index.count = 0;
+  cli_cmd.cmd_index.p_slot = cli_cmd.cmd_slot;
+  memset(cli_cmd.cmd_slot, 0, sizeof(cli_cmd.cmd_slot));
+#ifdef CLI_STAT_MAX
+  cli_cmd.is_footer  = false;
+  cli_cmd.stat_count = 0;
+  cli_cmd.stat_drop  = 0;
+#endif
 
 
   cliAdd("help", cliShowList);
   cliAdd("md"  , cliMemoryDump);
+#if CLI_USE(HW_CLI)
+  cliAddItem(&cli_item);
+#endif
+#ifdef _USE_HW_CLI_BIN
+  cliBinInit();
+#endif
 
   return true;
 }
 
+// 같은 채널에 열린 session 이 있으면 그것을 쓰고 없으면 빈 session 을 하나 할당한다.
 bool cliOpen(uint8_t ch, uint32_t baud)
 {
-  cli_node.ch = ch;
+  cli_t *p_cli = NULL;
+
 
+  for (int i=0; i<CLI_SESSION_MAX; i++)
+  {
+    if (cli_node[i].is_open == true && cli_node[i].ch == ch)
+    {
+      p_cli = &cli_node[i];
+      break;
+    }
+  }
+  for (int i=0; i<CLI_SESSION_MAX && p_cli == NULL; i++)
+  {
+    if (cli_node[i].is_open != true)
+    {
+      p_cli = &cli_node[i];
+    }
+  }
+  if (p_cli == NULL)
+  {
+    return false;
+  }
 
-  if (cli_node.is_open == false || cli_node.baud != baud)
+  if (p_cli->is_open == false || p_cli->baud != baud)
   {
     if (baud > 0)
     {
-      cli_node.baud = baud;
-      cli_node.is_open = uartOpen(ch, baud);
+      p_cli->ch      = ch;
+      p_cli->baud    = baud;
+      p_cli->is_open = uartOpen(ch, baud);
+      p_cli->cmd_args.ch = ch;
     }
   }
 
-  return cli_node.is_open;
+  return p_cli->is_open;
 }
 
 bool cliIsBusy(void)
 {
-  return cli_node.is_busy;
+  for (int i=0; i<CLI_SESSION_MAX; i++)
+  {
+    if (cli_node[i].is_busy == true)
+    {
+      return true;
+    }
+  }
+  return false;
 }
 
 bool cliOpenLog(uint8_t ch, uint32_t baud)
 {
   bool ret;
 
-  cli_node.log_ch = ch;
-  cli_node.log_baud = baud;
+  cli_cmd.log_ch = ch;
+  cli_cmd.log_baud = baud;
 
   ret = uartOpen(ch, baud);
 
   if (ret == true)
   {
-    cli_node.is_log = true;
+    cli_cmd.is_log = true;
   }
   return ret;
 }
 
 uint8_t cliGetPort(void)
 {
-  return cli_node.ch;
+  return p_cli_cur->ch;
 }
 
 bool cliLogClose(void)
 {
-  cli_node.is_log = false;
+  cli_cmd.is_log = false;
   return true;
 }
 
 void cliShowLog(cli_t *p_cli)
 {
-  if (cli_node.is_log == true)
+  if (cli_cmd.is_log == true)
   {
-    uartPrintf(p_cli->log_ch, "Cursor  : %d\n", p_cli->line.cursor);
-    uartPrintf(p_cli->log_ch, "Count   : %d\n", p_cli->line.count);
-    uartPrintf(p_cli->log_ch, "buf_len : %d\n", p_cli->line.buf_len);
-    uartPrintf(p_cli->log_ch, "buf     : %s\n", p_cli->line.buf);
-    uartPrintf(p_cli->log_ch, "line_i  : %d\n", p_cli->hist_line_i);
-    uartPrintf(p_cli->log_ch, "line_lt : %d\n", p_cli->hist_line_last);
-    uartPrintf(p_cli->log_ch, "line_c  : %d\n", p_cli->hist_line_count);
+    uartPrintf(cli_cmd.log_ch, "Cursor  : %d\n", p_cli->line.cursor);
+    uartPrintf(cli_cmd.log_ch, "Count   : %d\n", p_cli->line.count);
+    uartPrintf(cli_cmd.log_ch, "buf_len : %d\n", p_cli->line.buf_len);
+    uartPrintf(cli_cmd.log_ch, "buf     : %s\n", p_cli->line.buf);
+    uartPrintf(cli_cmd.log_ch, "line_i  : %d\n", p_cli->hist_line_i);
+    uartPrintf(cli_cmd.log_ch, "line_lt : %d\n", p_cli->hist_line_last);
+    uartPrintf(cli_cmd.log_ch, "line_c  : %d\n", p_cli->hist_line_count);
 
     for (int i=0; i<p_cli->hist_line_count; i++)
     {
-      uartPrintf(p_cli->log_ch, "buf %d   : %s\n", i, p_cli->line_buf[i].buf);
+      uartPrintf(cli_cmd.log_ch, "buf %d   : %s\n", i, p_cli->line_buf[i].buf);
     }
-    uartPrintf(p_cli->log_ch, "\n");
+    uartPrintf(cli_cmd.log_ch, "\n");
   }
 }
 
@@ -212,44 +367,190 @@ void cliShowPrompt(cli_t *p_cli)
   uartPrintf(p_cli->ch, CLI_PROMPT_STR);
 }
 
-bool cliMain(void)
+static void cliJobUpdate(cli_t *p_cli)
 {
-  if (cli_node.is_open != true)
+  cli_job_t *p_job = p_cli->p_job;
+  uint8_t   *p_data;
+  uint32_t   length;
+  uint32_t   pre_time;
+  uint32_t   pre_cycles;
+  bool       is_run;
+
+
+  // job 이 도는 동안 입력은 Ctrl-C 만 본다.
+  if (uartPeekSpan(p_cli->ch, &p_data, &length) == true)
   {
-    return false;
+    for (uint32_t i=0; i<length; i++)
+    {
+#ifdef _USE_HW_CLI_BIN
+      if (cliBinUpdate(&p_cli->bin_rx, p_cli->ch, p_data[i]) == true)
+      {
+        continue;
+      }
+#endif
+      if (p_data[i] == CLI_KEY_CTRL_C)
+      {
+        p_job->is_cancel = true;
+      }
+    }
+    uartConsume(p_cli->ch, length);
   }
 
-  if (uartAvailable(cli_node.ch) > 0)
+  pre_time = millis();
+  p_job->loop_max  = cmax(p_job->loop_max, pre_time - p_job->loop_time);
+  p_job->loop_time = pre_time;
+
+  do
   {
-    cliUpdate(&cli_node, uartRead(cli_node.ch));
+    pre_cycles = cycles();
+    is_run = p_job->func(p_job);
+    p_job->run_us += (cycles() - pre_cycles) / (SystemCoreClock / 1000000);
+
+    if (p_job->total > 0)
+    {
+      uint8_t percent;
+
+      percent = (uint64_t)p_job->done * 100 / p_job->total;
+      if (percent != p_job->percent)
+      {
+        p_job->percent = percent;
+        cliPrintf("\r%-8s %3d%%", p_job->p_stage, percent);
+      }
+    }
+  } while(is_run == true && p_job->is_cancel != true && p_cli->p_job == p_job && millis()-pre_time < CLI_JOB_SLICE_MS);
+
+  if (is_run != true)
+  {
+    cli_job_t *p_parent = p_job->p_parent;
+
+    cliPrintf("\n%s : %s, %d ms (run %d ms), loop max %d ms\n",
+              p_job->name,
+              p_job->is_cancel ? "canceled" : p_job->ret ? "OK":"Fail",
+              (int)(millis() - p_job->start_time),
+              (int)(p_job->run_us / 1000),
+              (int)p_job->loop_max);
+
+    // 하위 job 이 끝나면 결과를 넘기고 상위 job 을 이어서 실행한다.
+    p_cli->p_job = p_parent;
+    if (p_parent != NULL)
+    {
+      p_parent->p_child   = NULL;
+      p_parent->child_ret = (p_job->ret == true && p_job->is_cancel != true);
+      p_parent->loop_time = millis();
+      if (p_job->is_cancel == true)
+      {
+        p_parent->is_cancel = true;
+      }
+    }
+    else
+    {
+      // 명령의 결과는 job 이 끝난 결과로 정한다.
+      if (p_job->ret != true || p_job->is_cancel == true)
+      {
+        p_cli->is_error = true;
+      }
+      p_cli->is_busy = false;
+      cliShowPrompt(p_cli);
+    }
   }
+}
 
-  return true;
+static bool cliMainSession(cli_t *p_cli)
+{
+  uint8_t *p_data;
+  uint32_t length;
+  bool     is_connected;
+
+
+  // 나중에 붙은 console 에는 부팅 로그를 다시 보낸다. log 채널은 이미 받았다.
+  is_connected = uartIsConnected(p_cli->ch);
+  if (is_connected == true && p_cli->is_connected != true)
+  {
+#ifdef _USE_HW_LOG
+    if (p_cli->ch != LOG_CH)
+    {
+      logReplay(p_cli->ch);
+    }
+#endif
+  }
+  p_cli->is_connected = is_connected;
+
+  if (p_cli->p_job != NULL)
+  {
+    cliJobUpdate(p_cli);
+    return p_cli->p_job != NULL;
+  }
+
+  if (uartPeekSpan(p_cli->ch, &p_data, &length) == true)
+  {
+    for (uint32_t i=0; i<length; i++)
+    {
+#ifdef _USE_HW_CLI_BIN
+      if (cliBinUpdate(&p_cli->bin_rx, p_cli->ch, p_data[i]) == true)
+      {
+        continue;
+      }
+#endif
+      // 실행되는 명령이 이어지는 입력을 직접 읽을 수 있도록 Enter 까지 먼저 consume 한다.
+      if (p_data[i] == CLI_KEY_ENTER && p_cli->state == CLI_RX_IDLE)
+      {
+        uint8_t rx_data = p_data[i];
+
+        uartConsume(p_cli->ch, i + 1);
+        cliUpdate(p_cli, rx_data);
+        return uartAvailable(p_cli->ch) > 0;
+      }
+      cliUpdate(p_cli, p_data[i]);
+    }
+    uartConsume(p_cli->ch, length);
+  }
+
+  return false;
 }
 
-void cliLogo(void)
+// 열린 session 을 차례로 처리한다. Enter 뒤에 남은 입력이 있거나 job 이 돌고 있으면 true 를 돌려준다.
+bool cliMain(void)
 {
-  if (cli_node.is_open != true)
+  bool ret = false;
+
+
+  for (int i=0; i<CLI_SESSION_MAX; i++)
   {
-    return;
+    if (cli_node[i].is_open == true)
+    {
+      p_cli_cur = &cli_node[i];
+      ret |= cliMainSession(&cli_node[i]);
+    }
   }
 
-  cliShowPrompt(&cli_node);
+  return ret;
+}
+
+void cliLogo(void)
+{
+  for (int i=0; i<CLI_SESSION_MAX; i++)
+  {
+    if (cli_node[i].is_open == true)
+    {
+      cliShowPrompt(&cli_node[i]);
+    }
+  }
 }
 
 uint32_t cliAvailable(void)
 {
-  return uartAvailable(cli_node.ch);
+  return uartAvailable(p_cli_cur->ch);
 }
 
 uint8_t cliRead(void)
 {
-  return uartRead(cli_node.ch);
+  return uartRead(p_cli_cur->ch);
 }
 
 uint32_t cliWrite(uint8_t *p_data, uint32_t length)
 {
-  return uartWrite(cli_node.ch, p_data, length);
+  p_cli_cur->tx_bytes += length;
+  return uartWrite(p_cli_cur->ch, p_data, length);
 }
 
 bool cliUpdate(cli_t *p_cli, uint8_t rx_data)
@@ -277,7 +578,10 @@ bool cliUpdate(cli_t *p_cli, uint8_t rx_data)
         line->count = 0;
         line->cursor = 0;
         line->buf[0] = 0;
-        cliShowPrompt(p_cli);
+        if (p_cli->p_job == NULL)
+        {
+          cliShowPrompt(p_cli);
+        }
         break;
 
 
@@ -529,29 +833,286 @@ void cliLineChange(cli_t *p_cli, int8_t key_up)
   p_cli->hist_line_new = false;
 }
 
+static uint32_t cliHash(uint32_t hash, const char *p_str)
+{
+  uint8_t str_ch;
+
+  while((str_ch = (uint8_t)*p_str++) != 0)
+  {
+    if ((str_ch >= 'A') && (str_ch <= 'Z'))
+    {
+      str_ch = str_ch - 'A' + 'a';
+    }
+    hash = (hash ^ str_ch) * CLI_HASH_PRIME;
+  }
+
+  return hash;
+}
+
+static bool cliIsSameName(const char *p_a, const char *p_b)
+{
+  uint8_t a_ch;
+  uint8_t b_ch;
+
+  do
+  {
+    a_ch = (uint8_t)*p_a++;
+    b_ch = (uint8_t)*p_b++;
+    if ((a_ch >= 'A') && (a_ch <= 'Z')) a_ch = a_ch - 'A' + 'a';
+    if ((b_ch >= 'A') && (b_ch <= 'Z')) b_ch = b_ch - 'A' + 'a';
+    if (a_ch != b_ch)
+    {
+      return false;
+    }
+  } while(a_ch != 0);
+
+  return true;
+}
+
+static const cli_item_t *cliIndexFind(cli_index_t *p_index, const cli_item_t *p_parent, uint32_t hash, const char *p_name)
+{
+  uint32_t mask = p_index->size - 1;
+  uint32_t i;
+
+
+  for (i=hash & mask; p_index->p_slot[i].p_item != NULL; i=(i + 1) & mask)
+  {
+    cli_slot_t *p_slot = &p_index->p_slot[i];
+
+    if (p_slot->hash == hash && p_slot->p_parent == p_parent && cliIsSameName(p_slot->p_item->name, p_name))
+    {
+      return p_slot->p_item;
+    }
+  }
+
+  return NULL;
+}
+
+// linear probing 이므로 지운 자리 뒤의 항목을 당겨서 검색이 끊기지 않게 한다.
+static void cliIndexRemove(cli_index_t *p_index, uint32_t hash, const cli_item_t *p_item)
+{
+  uint32_t mask = p_index->size - 1;
+  uint32_t i;
+  uint32_t j;
+  uint32_t home;
+
+
+  for (i=hash & mask; p_index->p_slot[i].p_item != p_item; i=(i + 1) & mask)
+  {
+    if (p_index->p_slot[i].p_item == NULL)
+    {
+      return;
+    }
+  }
+
+  for (j=(i + 1) & mask; p_index->p_slot[j].p_item != NULL; j=(j + 1) & mask)
+  {
+    home = p_index->p_slot[j].hash & mask;
+
+    // home 이 (i, j] 안에 있으면 그 자리에 그대로 둔다.
+    if (((j - home) & mask) < ((j - i) & mask))
+    {
+      continue;
+    }
+    p_index->p_slot[i] = p_index->p_slot[j];
+    i = j;
+  }
+
+  p_index->p_slot[i].p_item = NULL;
+  p_index->count--;
+}
+
+// p_item 과 앞의 sub_cnt 개 하위 명령을 모두 지운다.
+static void cliIndexRollback(cli_index_t *p_index, uint32_t parent_hash, const cli_item_t *p_item, uint32_t sub_cnt)
+{
+  uint32_t hash;
+
+
+  hash = cliHash(parent_hash, p_item->name);
+
+  for (uint32_t sub_i=0; sub_i<sub_cnt; sub_i++)
+  {
+    cliIndexRollback(p_index, hash, &p_item->p_sub[sub_i], p_item->p_sub[sub_i].sub_cnt);
+  }
+  cliIndexRemove(p_index, hash, p_item);
+}
+
+// 실패하면 이번에 넣은 항목을 모두 되돌려서 일부만 등록된 명령이 남지 않게 한다.
+static bool cliIndexAdd(cli_index_t *p_index, const cli_item_t *p_parent, uint32_t parent_hash, const cli_item_t *p_item)
+{
+  uint32_t mask = p_index->size - 1;
+  uint32_t hash;
+  uint32_t i;
+
+
+  hash = cliHash(parent_hash, p_item->name);
+
+  if (cliIndexFind(p_index, p_parent, hash, p_item->name) != NULL)
+  {
+    return false;
+  }
+  // 빈 slot 이 하나는 남아야 검색이 끝난다.
+  if (p_index->count + 1 >= p_index->size)
+  {
+    return false;
+  }
+
+  for (i=hash & mask; p_index->p_slot[i].p_item != NULL; i=(i + 1) & mask);
+
+  p_index->p_slot[i].hash     = hash;
+  p_index->p_slot[i].p_parent = p_parent;
+  p_index->p_slot[i].p_item   = p_item;
+  p_index->count++;
+
+  for (uint32_t sub_i=0; sub_i<p_item->sub_cnt; sub_i++)
+  {
+    if (cliIndexAdd(p_index, p_item, hash, &p_item->p_sub[sub_i]) != true)
+    {
+      cliIndexRollback(p_index, parent_hash, p_item, sub_i);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static void cliShowUsage(cli_t *p_cli, const cli_item_t *p_item, uint16_t depth)
+{
+  if (p_item->func == NULL)
+  {
+    for (int i=0; i<p_item->sub_cnt; i++)
+    {
+      for (int d=0; d<=depth; d++)
+      {
+        cliPrintf("%s ", p_cli->argv[d]);
+      }
+      cliPrintf("%s %s\n", p_item->p_sub[i].name, p_item->p_sub[i].usage != NULL ? p_item->p_sub[i].usage:"");
+    }
+  }
+  else
+  {
+    cliPrintf("usage : ");
+    for (int d=0; d<=depth; d++)
+    {
+      cliPrintf("%s ", p_cli->argv[d]);
+    }
+    cliPrintf("%s\n", p_item->usage != NULL ? p_item->usage:"");
+  }
+}
+
+#ifdef CLI_STAT_MAX
+// leaf item 주소로 찾는다. 실행되는 명령 수 만큼만 쓰므로 선형 검색으로 충분하다.
+static void cliStatAdd(const cli_item_t *p_root, const cli_item_t *p_item, uint32_t exe_cycles, uint32_t tx_bytes)
+{
+  cli_stat_t *p_stat = NULL;
+
+  for (int i=0; i<cli_cmd.stat_count; i++)
+  {
+    if (cli_cmd.stat[i].p_item == p_item && cli_cmd.stat[i].p_root == p_root)
+    {
+      p_stat = &cli_cmd.stat[i];
+      break;
+    }
+  }
+  if (p_stat == NULL)
+  {
+    if (cli_cmd.stat_count >= CLI_STAT_MAX)
+    {
+      cli_cmd.stat_drop++;
+      return;
+    }
+    p_stat = &cli_cmd.stat[cli_cmd.stat_count++];
+    memset(p_stat, 0, sizeof(cli_stat_t));
+    p_stat->p_root     = p_root;
+    p_stat->p_item     = p_item;
+    p_stat->min_cycles = 0xFFFFFFFF;
+  }
+
+  p_stat->count++;
+  p_stat->sum_cycles += exe_cycles;
+  p_stat->tx_bytes   += tx_bytes;
+  p_stat->min_cycles  = cmin(p_stat->min_cycles, exe_cycles);
+  p_stat->max_cycles  = cmax(p_stat->max_cycles, exe_cycles);
+}
+#endif
+
 bool cliRunCmd(cli_t *p_cli)
 {
   bool ret = false;
+  const cli_item_t *p_item;
+  const cli_item_t *p_root;
+  const cli_item_t *p_sub;
+  uint32_t hash;
+  uint16_t depth = 0;
+  uint16_t argc;
 
 
   if (cliParseArgs(p_cli) == true)
   {
     cliPrintf("\r\n");
 
-    cliToUpper(p_cli->argv[0]);
+    hash   = cliHash(CLI_HASH_SEED, p_cli->argv[0]);
+    p_item = cliIndexFind(&cli_cmd.cmd_index, NULL, hash, p_cli->argv[0]);
+    if (p_item == NULL)
+    {
+      return false;
+    }
+    p_root = p_item;
 
-    p_cli->is_busy = true;
-    for (int i=0; i<p_cli->cmd_count; i++)
+    while(p_item->sub_cnt > 0 && depth + 1 < p_cli->argc)
     {
-      if (strcmp(p_cli->argv[0], p_cli->cmd_list[i].cmd_str) == 0)
+      uint32_t sub_hash;
+
+      sub_hash = cliHash(hash, p_cli->argv[depth + 1]);
+      p_sub    = cliIndexFind(&cli_cmd.cmd_index, p_item, sub_hash, p_cli->argv[depth + 1]);
+      if (p_sub == NULL)
       {
-        p_cli->cmd_args.argc =  p_cli->argc - 1;
-        p_cli->cmd_args.argv = &p_cli->argv[1];
-        p_cli->cmd_list[i].cmd_func(&p_cli->cmd_args);
         break;
       }
+      p_item = p_sub;
+      hash   = sub_hash;
+      depth++;
     }
-    p_cli->is_busy = false;
+
+    argc = p_cli->argc - depth - 1;
+
+    if (p_item->func == NULL || argc < p_item->argc_min || (p_item->argc_max != CLI_ARGC_ANY && argc > p_item->argc_max))
+    {
+      cliShowUsage(p_cli, p_item, depth);
+      return false;
+    }
+
+    p_cli_cur       = p_cli;
+    p_cli->is_busy  = true;
+    p_cli->is_error = false;
+    p_cli->cmd_args.argc = argc;
+    p_cli->cmd_args.argv = &p_cli->argv[depth + 1];
+#ifdef CLI_STAT_MAX
+    {
+      cli_job_t *p_job      = p_cli->p_job;
+      uint32_t   pre_bytes  = p_cli->tx_bytes;
+      uint32_t   pre_cycles = cycles();
+      uint32_t   exe_cycles;
+
+      p_item->func(&p_cli->cmd_args);
+      exe_cycles = cycles() - pre_cycles;
+
+      cliStatAdd(depth > 0 ? p_root : NULL, p_item, exe_cycles, p_cli->tx_bytes - pre_bytes);
+
+      // job 으로 넘어간 명령은 job 이 끝날 때 시간을 따로 출력한다.
+      if (cli_cmd.is_footer == true && p_cli->p_job == p_job)
+      {
+        cliPrintf("[ %d us, %d bytes ]\n",
+                  (int)(exe_cycles / (SystemCoreClock / 1000000)),
+                  (int)(p_cli->tx_bytes - pre_bytes));
+      }
+    }
+#else
+    p_item->func(&p_cli->cmd_args);
+#endif
+    p_cli->is_busy = (p_cli->p_job != NULL);
+
+    ret = !p_cli->is_error;
   }
 
   return ret;
@@ -594,9 +1155,9 @@ bool cliRunStr(const char *fmt, ...)
   bool ret;
   va_list arg;
   va_start (arg, fmt);  
-  cli_t *p_cli = &cli_node;
+  cli_t *p_cli = p_cli_cur;
 
-  vsnprintf((char *)p_cli->line.buf, CLI_LINE_BUF_MAX, fmt, arg);
+  printVSnprintf((char *)p_cli->line.buf, CLI_LINE_BUF_MAX, fmt, arg);
   va_end (arg);
   
   ret = cliRunCmd(p_cli);
@@ -604,58 +1165,37 @@ bool cliRunStr(const char *fmt, ...)
   return ret;
 }
 
+static void cliPrintOut(void *p_arg, const uint8_t *p_data, uint32_t length)
+{
+  cli_t *p_cli = (cli_t *)p_arg;
+
+  p_cli->tx_bytes += length;
+  uartWrite(p_cli->ch, (uint8_t *)p_data, length);
+}
+
 void cliPrintf(const char *fmt, ...)
 {
   va_list arg;
   va_start (arg, fmt);
-  int32_t len;
-  cli_t *p_cli = &cli_node;
+  cli_t *p_cli = p_cli_cur;
 
 
-  len = vsnprintf(p_cli->print_buffer, 256, fmt, arg);
+  printFormat(cliPrintOut, p_cli, fmt, arg);
   va_end (arg);
-
-  uartWrite(p_cli->ch, (uint8_t *)p_cli->print_buffer, len);
 }
 
 void cliPutch(uint8_t data)
 {
-  cli_t *p_cli = &cli_node;
+  cli_t *p_cli = p_cli_cur;
   
+  p_cli->tx_bytes++;
   uartWrite(p_cli->ch, &data, 1);
 }
 
-void cliToUpper(char *str)
-{
-  uint16_t i;
-  uint8_t  str_ch;
-
-  for (i=0; i<CLI_CMD_NAME_MAX; i++)
-  {
-    str_ch = str[i];
-
-    if (str_ch == 0)
-    {
-      break;
-    }
-
-    if ((str_ch >= 'a') && (str_ch <= 'z'))
-    {
-      str_ch = str_ch - 'a' + 'A';
-    }
-    str[i] = str_ch;
-  }
-
-  if (i == CLI_CMD_NAME_MAX)
-  {
-    str[i-1] = 0;
-  }
-}
-
 int32_t cliArgsGetData(uint8_t index)
 {
   int32_t ret = 0;
-  cli_t *p_cli = &cli_node;
+  cli_t *p_cli = p_cli_cur;
 
 
   if (index >= p_cli->cmd_args.argc)
@@ -671,7 +1211,7 @@ int32_t cliArgsGetData(uint8_t index)
 float cliArgsGetFloat(uint8_t index)
 {
   float ret = 0.0;
-  cli_t *p_cli = &cli_node;
+  cli_t *p_cli = p_cli_cur;
 
 
   if (index >= p_cli->cmd_args.argc)
@@ -687,7 +1227,7 @@ float cliArgsGetFloat(uint8_t index)
 char *cliArgsGetStr(uint8_t index)
 {
   char *ret = NULL;
-  cli_t *p_cli = &cli_node;
+  cli_t *p_cli = p_cli_cur;
 
 
   if (index >= p_cli->cmd_args.argc)
@@ -703,7 +1243,7 @@ char *cliArgsGetStr(uint8_t index)
 bool cliArgsIsStr(uint8_t index, const char *p_str)
 {
   bool ret = false;
-  cli_t *p_cli = &cli_node;
+  cli_t *p_cli = p_cli_cur;
 
 
   if (index >= p_cli->cmd_args.argc)
@@ -721,7 +1261,7 @@ bool cliArgsIsStr(uint8_t index, const char *p_str)
 
 bool cliKeepLoop(void)
 {
-  cli_t *p_cli = &cli_node;
+  cli_t *p_cli = p_cli_cur;
 
 
   if (uartAvailable(p_cli->ch) == 0)
@@ -736,44 +1276,176 @@ bool cliKeepLoop(void)
 
 bool cliAdd(const char *cmd_str, void (*p_func)(cli_args_t *))
 {
-  bool ret = true;
-  cli_t *p_cli = &cli_node;
-  uint16_t index;
+  cli_cmd_node_t *p_cli = &cli_cmd;
+  cli_cmd_t *p_cmd;
 
   if (p_cli->cmd_count >= CLI_CMD_LIST_MAX)
   {
     return false;
   }
 
-  index = p_cli->cmd_count;
-
-  strcpy(p_cli->cmd_list[index].cmd_str, cmd_str);
-  p_cli->cmd_list[index].cmd_func = p_func;
+  // 기존 방식 명령은 인자 검사 없이 leaf 하나로 등록한다.
+  p_cmd = &p_cli->cmd_list[p_cli->cmd_count];
 
-  cliToUpper(p_cli->cmd_list[index].cmd_str);
+  strncpy(p_cmd->cmd_str, cmd_str, CLI_CMD_NAME_MAX - 1);
+  p_cmd->cmd_str[CLI_CMD_NAME_MAX - 1] = 0;
+  p_cmd->item.name     = p_cmd->cmd_str;
+  p_cmd->item.func     = p_func;
+  p_cmd->item.p_sub    = NULL;
+  p_cmd->item.sub_cnt  = 0;
+  p_cmd->item.argc_min = 0;
+  p_cmd->item.argc_max = CLI_ARGC_ANY;
+  p_cmd->item.usage    = NULL;
 
+  if (cliIndexAdd(&p_cli->cmd_index, NULL, CLI_HASH_SEED, &p_cmd->item) != true)
+  {
+#ifdef _USE_HW_LOG
+    logPrintf("[NG] cliAdd() %s\n", cmd_str);
+#endif
+    return false;
+  }
   p_cli->cmd_count++;
 
-  return ret;
+  return true;
+}
+
+bool cliAddItem(const cli_item_t *p_item)
+{
+  if (cliIndexAdd(&cli_cmd.cmd_index, NULL, CLI_HASH_SEED, p_item) != true)
+  {
+#ifdef _USE_HW_LOG
+    logPrintf("[NG] cliAddItem() %s\n", p_item->name);
+#endif
+    return false;
+  }
+  return true;
 }
 
 void cliShowList(cli_args_t *args)
 {
-  cli_t *p_cli = &cli_node;
+  cli_cmd_node_t *p_cli = &cli_cmd;
 
 
   cliPrintf("\r\n");
   cliPrintf("---------- cmd list ---------\r\n");
 
-  for (int i=0; i<p_cli->cmd_count; i++)
+  for (int i=0; i<p_cli->cmd_index.size; i++)
   {
-    cliPrintf(p_cli->cmd_list[i].cmd_str);
-    cliPrintf("\r\n");
+    cli_slot_t *p_slot = &p_cli->cmd_index.p_slot[i];
+
+    if (p_slot->p_item != NULL && p_slot->p_parent == NULL)
+    {
+      cliPrintf("%s\r\n", p_slot->p_item->name);
+    }
   }
 
   cliPrintf("-----------------------------\r\n");
 }
 
+static uint32_t cliB64Encode(const uint8_t *p_src, uint32_t length, char *p_dst)
+{
+  static const char b64_tbl[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  uint32_t dst_i = 0;
+  uint32_t i;
+
+  for (i=0; i+2<length; i+=3)
+  {
+    uint32_t v = (p_src[i] << 16) | (p_src[i+1] << 8) | p_src[i+2];
+
+    p_dst[dst_i++] = b64_tbl[(v >> 18) & 0x3F];
+    p_dst[dst_i++] = b64_tbl[(v >> 12) & 0x3F];
+    p_dst[dst_i++] = b64_tbl[(v >>  6) & 0x3F];
+    p_dst[dst_i++] = b64_tbl[(v >>  0) & 0x3F];
+  }
+  if (i < length)
+  {
+    uint32_t v = p_src[i] << 16;
+
+    if (i+1 < length) v |= p_src[i+1] << 8;
+
+    p_dst[dst_i++] = b64_tbl[(v >> 18) & 0x3F];
+    p_dst[dst_i++] = b64_tbl[(v >> 12) & 0x3F];
+    p_dst[dst_i++] = (i+1 < length) ? b64_tbl[(v >> 6) & 0x3F] : '=';
+    p_dst[dst_i++] = '=';
+  }
+
+  return dst_i;
+}
+
+// 한 번에 한 block 씩 메모리에서 바로 TX 로 보낸다.
+//   #MD BIN|B64 addr length\n  [data]  \n#MD END crc32 length\n
+static bool cliMemoryStreamJob(cli_job_t *p_job)
+{
+  static char b64_buf[CLI_MD_B64_CHUNK/3*4 + 1];
+  uint8_t *p_addr = (uint8_t *)(uintptr_t)(p_job->arg[0] + p_job->done);
+  uint32_t length;
+  uint32_t tx_len;
+  uint32_t sent;
+
+
+  if (p_job->is_cancel == true)
+  {
+    cliPrintf("\n#MD ABORT\n");
+    return false;
+  }
+
+  if (p_job->done >= p_job->arg[1])
+  {
+    cliPrintf("\n#MD END %08X %u\n", (unsigned)p_job->arg[2], (unsigned)p_job->arg[1]);
+    return false;
+  }
+
+  if (p_job->step == 0)
+  {
+    length = cmin(p_job->arg[1] - p_job->done, CLI_MD_BIN_CHUNK);
+    tx_len = length;
+    sent   = cliWrite(p_addr, tx_len);
+  }
+  else
+  {
+    length = cmin(p_job->arg[1] - p_job->done, CLI_MD_B64_CHUNK);
+    tx_len = cliB64Encode(p_addr, length, b64_buf);
+    b64_buf[tx_len++] = '\n';
+    sent   = cliWrite((uint8_t *)b64_buf, tx_len);
+  }
+
+  // 받는 쪽이 없어서 TX 가 timeout 되면 멈춘다.
+  if (sent != tx_len)
+  {
+    cliPrintf("\n#MD ABORT\n");
+    p_job->ret = false;
+    return false;
+  }
+
+  p_job->arg[2] = utilUpdateCrc32(p_job->arg[2], p_addr, length);
+  p_job->done  += length;
+
+  return true;
+}
+
+static void cliMemoryStream(cli_args_t *args)
+{
+  static cli_job_t job;
+  uint8_t mode;
+
+  mode = args->isStr(0, "bin") ? 0 : 1;
+
+  // 다른 session 에서 돌고 있으면 arg[2] 의 CRC 가 깨지므로 먼저 확인한다.
+  if (cliJobIsIdle(&job, "md") != true)
+  {
+    return;
+  }
+  job.arg[0] = (uint32_t)args->getData(1);
+  job.arg[1] = (uint32_t)args->getData(2);
+  job.arg[2] = 0;
+  if (cliJobStart(&job, "md", cliMemoryStreamJob) == true)
+  {
+    // total 을 0 으로 두어서 진행률이 data 사이에 섞이지 않도록 한다.
+    job.step = mode;
+    cliPrintf("#MD %s 0x%08X %u\n", mode == 0 ? "BIN":"B64", (unsigned)job.arg[0], (unsigned)job.arg[1]);
+  }
+}
+
 void cliMemoryDump(cli_args_t *args)
 {
   int idx, size = 16;
@@ -786,9 +1458,16 @@ void cliMemoryDump(cli_args_t *args)
   char **argv = args->argv;
 
 
+  if (argc == 3 && (args->isStr(0, "bin") == true || args->isStr(0, "b64") == true))
+  {
+    cliMemoryStream(args);
+    return;
+  }
+
   if(args->argc < 1)
   {
     cliPrintf(">> md addr [size] \n");
+    cliPrintf(">> md bin:b64 addr length\n");
     return;
   }
 
@@ -804,7 +1483,7 @@ void cliMemoryDump(cli_args_t *args)
   {
     if((idx%4) == 0)
     {
-      cliPrintf(" 0x%08X: ", (unsigned int)addr);
+      cliPrintf(" 0x%08X: ", (unsigned int)(uintptr_t)addr);
     }
     cliPrintf(" 0x%08X", *(addr));
 
@@ -856,4 +1535,260 @@ void cliMoveDown(uint8_t y)
   cliPrintf("\x1B[%dB", y);
 }
 
+// 어느 session 에서도 돌고 있지 않으면 true, 돌고 있으면 알리고 false 를 돌려준다.
+// 돌고 있는 job 의 arg[] 를 덮어쓰지 않도록 arg[] 를 채우기 전에 부른다.
+bool cliJobIsIdle(cli_job_t *p_job, const char *name)
+{
+  for (int i=0; i<CLI_SESSION_MAX; i++)
+  {
+    for (cli_job_t *p_run = cli_node[i].p_job; p_run != NULL; p_run = p_run->p_parent)
+    {
+      if (p_run == p_job)
+      {
+        cliPrintf("%s : already running on session %d\n", name, i);
+        cliSetError();
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+// 지금 명령을 실행 중인 session 에 job 을 건다. 같은 job 이 이미 돌고 있으면 실패한다.
+// job 안에서 다른 job 을 시작하면 하위 job 으로 붙고, 끝날 때까지 상위 job 은 멈춘다.
+bool cliJobStart(cli_job_t *p_job, const char *name, bool (*p_func)(cli_job_t *p_job))
+{
+  cli_t *p_cli = p_cli_cur;
+
+
+  if (cliJobIsIdle(p_job, name) != true)
+  {
+    return false;
+  }
+
+  p_job->name       = name;
+  p_job->func       = p_func;
+  p_job->is_cancel  = false;
+  p_job->ret        = true;
+  p_job->step       = 0;
+  p_job->p_stage    = "";
+  p_job->done       = 0;
+  p_job->total      = 0;
+  p_job->percent    = 0xFF;
+  p_job->start_time = millis();
+  p_job->loop_time  = p_job->start_time;
+  p_job->loop_max   = 0;
+  p_job->run_us     = 0;
+  p_job->p_child    = NULL;
+  p_job->child_ret  = true;
+  p_job->p_parent   = p_cli->p_job;
+
+  if (p_job->p_parent != NULL)
+  {
+    p_job->p_parent->p_child = p_job;
+  }
+  p_cli->p_job = p_job;
+
+  return true;
+}
+
+// 명령이 실패했음을 알린다. cliRunStr() 과 script 는 이것으로 성공 여부를 판단한다.
+void cliSetError(void)
+{
+  p_cli_cur->is_error = true;
+}
+
+// 마지막 명령이 실패했는지 본다. job 으로 넘어간 명령은 job 이 끝난 뒤에 판단한다.
+bool cliIsError(void)
+{
+  return p_cli_cur->is_error;
+}
+
+void cliJobStage(cli_job_t *p_job, const char *p_stage, uint32_t total)
+{
+  if (p_job->percent != 0xFF)
+  {
+    cliPrintf("\n");
+  }
+  p_job->p_stage = p_stage;
+  p_job->done    = 0;
+  p_job->total   = total;
+  p_job->percent = 0xFF;
+}
+
+#if CLI_USE(HW_CLI)
+#define CLI_BENCH_CMD_MAX     200
+#define CLI_BENCH_HASH_MAX    256
+
+static void cliBenchFunc(cli_args_t *args)
+{
+}
+
+void cliBench(cli_args_t *args)
+{
+  static char        name_buf[CLI_BENCH_CMD_MAX][8];
+  static cli_item_t  item_tbl[CLI_BENCH_CMD_MAX];
+  static cli_slot_t  slot_tbl[CLI_BENCH_HASH_MAX];
+  cli_index_t index;
+  uint32_t    count = 1000;
+  uint32_t    pre_cycles;
+  uint32_t    hash_cycles;
+  uint32_t    linear_cycles;
+  const uint32_t name_i[3] = {0, CLI_BENCH_CMD_MAX/2, CLI_BENCH_CMD_MAX-1};
+
+
+  if (args->argc == 1)
+  {
+    count = constrain(args->getData(0), 1, 100000);
+  }
+
+  index.size   = CLI_BENCH_HASH_MAX;
+  index.count  = 0;
+  index.p_slot = slot_tbl;
+  memset(slot_tbl, 0, sizeof(slot_tbl));
+
+  for (int i=0; i<CLI_BENCH_CMD_MAX; i++)
+  {
+    printSnprintf(name_buf[i], sizeof(name_buf[i]), "cmd%03d", i);
+    item_tbl[i] = (cli_item_t)CLI_ITEM(name_buf[i], cliBenchFunc, 0, 0, NULL);
+    cliIndexAdd(&index, NULL, CLI_HASH_SEED, &item_tbl[i]);
+  }
+
+  cliPrintf("commands : %d, slots : %d\n", CLI_BENCH_CMD_MAX, CLI_BENCH_HASH_MAX);
+  cliPrintf("name     hash     linear   (cycles/lookup)\n");
+
+  for (int n=0; n<3; n++)
+  {
+    const char *p_name = name_buf[name_i[n]];
+    const char *volatile p_key = p_name;    // 반복문 밖으로 빠지지 않도록 매번 읽는다.
+    const cli_item_t *p_found = NULL;
+    volatile const cli_item_t *p_result;
+
+    pre_cycles = cycles();
+    for (uint32_t i=0; i<count; i++)
+    {
+      p_result = cliIndexFind(&index, NULL, cliHash(CLI_HASH_SEED, p_key), p_key);
+    }
+    hash_cycles = (cycles() - pre_cycles) / count;
+
+    // 이전 방식 : 등록 순서대로 strcmp
+    pre_cycles = cycles();
+    for (uint32_t i=0; i<count; i++)
+    {
+      for (int j=0; j<CLI_BENCH_CMD_MAX; j++)
+      {
+        if (strcmp(p_key, item_tbl[j].name) == 0)
+        {
+          p_found = &item_tbl[j];
+          break;
+        }
+      }
+      p_result = p_found;
+    }
+    linear_cycles = (cycles() - pre_cycles) / count;
+    (void)p_result;
+
+    cliPrintf("%-8s %-8d %-8d\n", p_name, (int)hash_cycles, (int)linear_cycles);
+  }
+}
+
+void cliSession(cli_args_t *args)
+{
+  cliPrintf("session ch   open busy ram\n");
+  for (int i=0; i<CLI_SESSION_MAX; i++)
+  {
+    cli_t *p_cli = &cli_node[i];
+
+    cliPrintf("%-7d %-4d %-4s %-4s %d bytes%s\n",
+              i,
+              p_cli->ch + 1,
+              p_cli->is_open ? "on":"off",
+              p_cli->is_busy ? "on":"off",
+              (int)sizeof(cli_t),
+              p_cli == p_cli_cur ? " *":"");
+  }
+  cliPrintf("shared  cmd  %d/%d, index %d/%d, %d bytes\n",
+            cli_cmd.cmd_count, CLI_CMD_LIST_MAX,
+            (int)cli_cmd.cmd_index.count, (int)cli_cmd.cmd_index.size,
+            (int)sizeof(cli_cmd_node_t));
+}
+
+void cliJob(cli_args_t *args)
+{
+  for (int i=0; i<CLI_SESSION_MAX; i++)
+  {
+    for (cli_job_t *p_job = cli_node[i].p_job; p_job != NULL; p_job = p_job->p_parent)
+    {
+      cliPrintf("session %d : %-12s %-8s %d/%d, %d ms, loop max %d ms\n",
+                i,
+                p_job->name,
+                p_job->p_stage,
+                (int)p_job->done,
+                (int)p_job->total,
+                (int)(millis() - p_job->start_time),
+                (int)p_job->loop_max);
+    }
+  }
+}
+
+#ifdef CLI_STAT_MAX
+void cliStats(cli_args_t *args)
+{
+  uint32_t mhz = SystemCoreClock / 1000000;
+
+
+  if (args->argc == 1 && args->isStr(0, "clear") == true)
+  {
+    cli_cmd.stat_count = 0;
+    cli_cmd.stat_drop  = 0;
+    cliPrintf("cli stats clear\n");
+    return;
+  }
+
+  if (args->argc == 2 && args->isStr(0, "footer") == true)
+  {
+    cli_cmd.is_footer = args->isStr(1, "on");
+    cliPrintf("footer : %s\n", cli_cmd.is_footer ? "on":"off");
+    return;
+  }
+
+  if (args->argc > 0)
+  {
+    cliPrintf("cli stats [clear] [footer on:off]\n");
+    return;
+  }
+
+  // 버전 간 비교를 위해 펌웨어 버전과 clock 을 같이 출력한다.
+  cliPrintf("fw %s, %d Mhz, min/avg/max in cycles\n", _DEF_FIRMWATRE_VERSION, (int)mhz);
+  cliPrintf("command            count    min        avg        max        avg us   bytes/call\n");
+  for (int i=0; i<cli_cmd.stat_count; i++)
+  {
+    cli_stat_t *p_stat = &cli_cmd.stat[i];
+    char        name[24];
+    uint32_t    avg;
+
+    if (p_stat->p_root != NULL)
+      printSnprintf(name, sizeof(name), "%s %s", p_stat->p_root->name, p_stat->p_item->name);
+    else
+      printSnprintf(name, sizeof(name), "%s", p_stat->p_item->name);
+
+    avg = (uint32_t)(p_stat->sum_cycles / p_stat->count);
+    cliPrintf("%-18s %-8u %-10u %-10u %-10u %-8u %u\n",
+              name,
+              (unsigned)p_stat->count,
+              (unsigned)p_stat->min_cycles,
+              (unsigned)avg,
+              (unsigned)p_stat->max_cycles,
+              (unsigned)(avg / mhz),
+              (unsigned)(p_stat->tx_bytes / p_stat->count));
+  }
+  if (cli_cmd.stat_drop > 0)
+  {
+    cliPrintf("table full, %d calls not recorded\n", (int)cli_cmd.stat_drop);
+  }
+}
+#endif
+#endif
+
 #endif
\ No newline at end of file
@@ -0,0 +1,413 @@
+#include "cli_bin.h"
+#include "uart.h"
+#include "util.h"
+
+
+#ifdef _USE_HW_CLI_BIN
+
+
+#define CLI_BIN_HEAD_LEN      3   // seq, cmd
+#define CLI_BIN_CRC_LEN       2
+
+
+typedef struct
+{
+  uint16_t    cmd;
+  const char *name;
+  cli_bin_status_t (*func)(cli_bin_t *p_bin);
+} cli_bin_cmd_t;
+
+typedef struct
+{
+  uint8_t   tx_packet[CLI_BIN_PACKET_MAX];
+  uint8_t   tx_frame[CLI_BIN_FRAME_MAX + 2];
+
+  uint32_t  rx_cnt;
+  uint32_t  err_crc;
+  uint32_t  err_frame;
+} cli_bin_node_t;
+
+
+static cli_bin_status_t cliBinPing(cli_bin_t *p_bin);
+static cli_bin_status_t cliBinInfo(cli_bin_t *p_bin);
+static cli_bin_status_t cliBinList(cli_bin_t *p_bin);
+
+
+static cli_bin_node_t cli_bin;
+static uint16_t       cmd_count = 0;
+static cli_bin_cmd_t  cmd_list[CLI_BIN_CMD_MAX];
+
+
+
+
+bool cliBinInit(void)
+{
+  cliBinAdd(CLI_BIN_CMD_PING, "ping", cliBinPing);
+  cliBinAdd(CLI_BIN_CMD_INFO, "info", cliBinInfo);
+  cliBinAdd(CLI_BIN_CMD_LIST, "list", cliBinList);
+
+  return true;
+}
+
+bool cliBinInitRx(cli_bin_rx_t *p_rx)
+{
+  p_rx->is_frame = false;
+  p_rx->is_next  = false;
+  p_rx->pre_time = 0;
+  p_rx->rx_len   = 0;
+
+  return true;
+}
+
+bool cliBinAdd(uint16_t cmd, const char *name, cli_bin_status_t (*p_func)(cli_bin_t *p_bin))
+{
+  if (cmd_count >= CLI_BIN_CMD_MAX)
+  {
+    return false;
+  }
+
+  cmd_list[cmd_count].cmd  = cmd;
+  cmd_list[cmd_count].name = name;
+  cmd_list[cmd_count].func = p_func;
+  cmd_count++;
+
+  return true;
+}
+
+static uint16_t cliBinCrc(const uint8_t *p_data, uint32_t length)
+{
+  uint16_t crc = 0;
+
+  for (uint32_t i=0; i<length; i++)
+  {
+    utilUpdateCrc(&crc, p_data[i]);
+  }
+
+  return crc;
+}
+
+static uint32_t cliBinCobsEncode(const uint8_t *p_src, uint32_t length, uint8_t *p_dst)
+{
+  uint32_t code_i = 0;
+  uint32_t dst_i  = 1;
+  uint8_t  code   = 1;
+
+  for (uint32_t i=0; i<length; i++)
+  {
+    if (p_src[i] == 0)
+    {
+      p_dst[code_i] = code;
+      code_i = dst_i++;
+      code   = 1;
+    }
+    else
+    {
+      p_dst[dst_i++] = p_src[i];
+      code++;
+      if (code == 0xFF)
+      {
+        p_dst[code_i] = code;
+        code_i = dst_i++;
+        code   = 1;
+      }
+    }
+  }
+  p_dst[code_i] = code;
+
+  return dst_i;
+}
+
+// in-place 로 decode 한다. 잘못된 frame 이면 0 을 돌려준다.
+static uint32_t cliBinCobsDecode(uint8_t *p_buf, uint32_t length)
+{
+  uint32_t src_i = 0;
+  uint32_t dst_i = 0;
+
+  while(src_i < length)
+  {
+    uint8_t code = p_buf[src_i++];
+
+    if (code == 0 || src_i + code - 1 > length)
+    {
+      return 0;
+    }
+    for (uint8_t i=1; i<code; i++)
+    {
+      p_buf[dst_i++] = p_buf[src_i++];
+    }
+    if (code != 0xFF && src_i < length)
+    {
+      p_buf[dst_i++] = 0;
+    }
+  }
+
+  return dst_i;
+}
+
+static void cliBinSend(uint8_t ch, cli_bin_t *p_bin, cli_bin_status_t status)
+{
+  uint8_t *p_packet = cli_bin.tx_packet;
+  uint32_t length;
+  uint16_t crc;
+
+
+  p_packet[0] = p_bin->seq;
+  p_packet[1] = (p_bin->cmd >> 0) & 0xFF;
+  p_packet[2] = (p_bin->cmd >> 8) & 0xFF;
+  p_packet[3] = status;
+
+  // 응답 data 는 handler 가 이미 p_packet[4] 부터 채워 두었다.
+  length = CLI_BIN_HEAD_LEN + 1 + p_bin->resp_len;
+  crc    = cliBinCrc(p_packet, length);
+  p_packet[length++] = (crc >> 0) & 0xFF;
+  p_packet[length++] = (crc >> 8) & 0xFF;
+
+  cli_bin.tx_frame[0] = 0;
+  length = cliBinCobsEncode(p_packet, length, &cli_bin.tx_frame[1]) + 1;
+  cli_bin.tx_frame[length++] = 0;
+
+  uartWrite(ch, cli_bin.tx_frame, length);
+}
+
+static void cliBinProcess(uint8_t ch, uint8_t *p_packet, uint32_t length)
+{
+  cli_bin_t        bin;
+  cli_bin_status_t status = CLI_BIN_ERR_CMD;
+  uint16_t         crc;
+
+
+  bin.seq      = p_packet[0];
+  bin.cmd      = (p_packet[1] << 0) | (p_packet[2] << 8);
+  bin.p_req    = &p_packet[CLI_BIN_HEAD_LEN];
+  bin.req_len  = length - CLI_BIN_HEAD_LEN - CLI_BIN_CRC_LEN;
+  bin.req_index = 0;
+  bin.p_resp   = &cli_bin.tx_packet[CLI_BIN_HEAD_LEN + 1];
+  bin.resp_len = 0;
+  bin.resp_max = CLI_BIN_DATA_MAX;
+
+  crc = (p_packet[length - 2] << 0) | (p_packet[length - 1] << 8);
+  if (crc != cliBinCrc(p_packet, length - CLI_BIN_CRC_LEN))
+  {
+    cli_bin.err_crc++;
+    cliBinSend(ch, &bin, CLI_BIN_ERR_CRC);
+    return;
+  }
+
+  for (int i=0; i<cmd_count; i++)
+  {
+    if (cmd_list[i].cmd == bin.cmd)
+    {
+      status = cmd_list[i].func(&bin);
+      break;
+    }
+  }
+  if (status != CLI_BIN_OK)
+  {
+    bin.resp_len = 0;
+  }
+
+  cliBinSend(ch, &bin, status);
+}
+
+// 0x00 이후로 들어오는 byte 는 frame 으로 받고 true 를 돌려준다.
+// text CLI 입력에는 0x00 이 없으므로 같은 port 에서 섞어 쓸 수 있다.
+// frame 이 끝나도 frame mode 에 남아서 구분자를 같이 쓰는 다음 frame 을 받고
+// CLI_BIN_NEXT_MS 가 지나서 들어온 첫 byte 에서 text 로 돌아간다.
+bool cliBinUpdate(cli_bin_rx_t *p_rx, uint8_t ch, uint8_t rx_data)
+{
+  if (rx_data == 0)
+  {
+    p_rx->is_next = false;
+    if (p_rx->is_frame == true && p_rx->rx_len > 0)
+    {
+      uint32_t length;
+
+      length = cliBinCobsDecode(p_rx->rx_buf, p_rx->rx_len);
+      if (length >= CLI_BIN_HEAD_LEN + CLI_BIN_CRC_LEN)
+      {
+        cli_bin.rx_cnt++;
+        cliBinProcess(ch, p_rx->rx_buf, length);
+      }
+      else
+      {
+        cli_bin.err_frame++;
+      }
+      p_rx->is_next  = true;
+      p_rx->pre_time = millis();
+    }
+    p_rx->is_frame = true;
+    p_rx->rx_len   = 0;
+    return true;
+  }
+
+  if (p_rx->is_frame != true)
+  {
+    return false;
+  }
+
+  if (p_rx->is_next == true)
+  {
+    p_rx->is_next = false;
+    if (millis()-p_rx->pre_time >= CLI_BIN_NEXT_MS)
+    {
+      p_rx->is_frame = false;
+      return false;
+    }
+  }
+
+  if (p_rx->rx_len < CLI_BIN_FRAME_MAX)
+  {
+    p_rx->rx_buf[p_rx->rx_len++] = rx_data;
+  }
+  else
+  {
+    cli_bin.err_frame++;
+    p_rx->is_frame = false;
+    p_rx->rx_len   = 0;
+  }
+
+  return true;
+}
+
+bool cliBinGetU8(cli_bin_t *p_bin, uint8_t *p_data)
+{
+  uint8_t *p_src;
+
+  if (cliBinGetBytes(p_bin, &p_src, 1) != true) return false;
+
+  *p_data = p_src[0];
+  return true;
+}
+
+bool cliBinGetU16(cli_bin_t *p_bin, uint16_t *p_data)
+{
+  uint8_t *p_src;
+
+  if (cliBinGetBytes(p_bin, &p_src, 2) != true) return false;
+
+  *p_data = utilConvert8ToU16(p_src);
+  return true;
+}
+
+bool cliBinGetU32(cli_bin_t *p_bin, uint32_t *p_data)
+{
+  uint8_t *p_src;
+
+  if (cliBinGetBytes(p_bin, &p_src, 4) != true) return false;
+
+  *p_data = utilConvert8ToU32(p_src);
+  return true;
+}
+
+bool cliBinGetBytes(cli_bin_t *p_bin, uint8_t **pp_data, uint16_t length)
+{
+  if (p_bin->req_index + length > p_bin->req_len)
+  {
+    return false;
+  }
+
+  *pp_data = &p_bin->p_req[p_bin->req_index];
+  p_bin->req_index += length;
+
+  return true;
+}
+
+uint8_t *cliBinReserve(cli_bin_t *p_bin, uint16_t length)
+{
+  uint8_t *p_dst;
+
+  if (p_bin->resp_len + length > p_bin->resp_max)
+  {
+    return NULL;
+  }
+
+  p_dst = &p_bin->p_resp[p_bin->resp_len];
+  p_bin->resp_len += length;
+
+  return p_dst;
+}
+
+bool cliBinPutU8(cli_bin_t *p_bin, uint8_t data)
+{
+  return cliBinPutBytes(p_bin, &data, 1);
+}
+
+bool cliBinPutU16(cli_bin_t *p_bin, uint16_t data)
+{
+  uint8_t buf[2];
+
+  buf[0] = (data >> 0) & 0xFF;
+  buf[1] = (data >> 8) & 0xFF;
+  return cliBinPutBytes(p_bin, buf, 2);
+}
+
+bool cliBinPutU32(cli_bin_t *p_bin, uint32_t data)
+{
+  uint8_t buf[4];
+
+  buf[0] = (data >>  0) & 0xFF;
+  buf[1] = (data >>  8) & 0xFF;
+  buf[2] = (data >> 16) & 0xFF;
+  buf[3] = (data >> 24) & 0xFF;
+  return cliBinPutBytes(p_bin, buf, 4);
+}
+
+bool cliBinPutBytes(cli_bin_t *p_bin, const uint8_t *p_data, uint16_t length)
+{
+  uint8_t *p_dst;
+
+  p_dst = cliBinReserve(p_bin, length);
+  if (p_dst == NULL)
+  {
+    return false;
+  }
+  memcpy(p_dst, p_data, length);
+
+  return true;
+}
+
+cli_bin_status_t cliBinPing(cli_bin_t *p_bin)
+{
+  if (cliBinPutBytes(p_bin, p_bin->p_req, p_bin->req_len) != true)
+  {
+    return CLI_BIN_ERR_LENGTH;
+  }
+  return CLI_BIN_OK;
+}
+
+cli_bin_status_t cliBinInfo(cli_bin_t *p_bin)
+{
+  const char *name_str = _DEF_BOARD_NAME;
+  const char *ver_str  = _DEF_FIRMWATRE_VERSION;
+
+  bool ret = true;
+
+  ret &= cliBinPutU16(p_bin, CLI_BIN_DATA_MAX);
+  ret &= cliBinPutU32(p_bin, cli_bin.rx_cnt);
+  ret &= cliBinPutU32(p_bin, cli_bin.err_crc);
+  ret &= cliBinPutU32(p_bin, cli_bin.err_frame);
+  ret &= cliBinPutBytes(p_bin, (const uint8_t *)name_str, strlen(name_str) + 1);
+  ret &= cliBinPutBytes(p_bin, (const uint8_t *)ver_str, strlen(ver_str) + 1);
+  if (ret != true)
+  {
+    return CLI_BIN_ERR_LENGTH;
+  }
+
+  return CLI_BIN_OK;
+}
+
+cli_bin_status_t cliBinList(cli_bin_t *p_bin)
+{
+  for (int i=0; i<cmd_count; i++)
+  {
+    if (cliBinPutU16(p_bin, cmd_list[i].cmd) != true ||
+        cliBinPutBytes(p_bin, (const uint8_t *)cmd_list[i].name, strlen(cmd_list[i].name) + 1) != true)
+    {
+      return CLI_BIN_ERR_LENGTH;
+    }
+  }
+
+  return CLI_BIN_OK;
+}
+
+#endif
@@ -1,5 +1,6 @@
 #include "cli.h"
 #include "cli_gui.h"
+#include "print.h"
 
 
 #ifdef _USE_HW_CLI_GUI
@@ -10,6 +11,19 @@
 #define CHARSET_G0      0
 #define CHARSET_G1      1
 
+#define CLI_GUI_POS_NONE    0xFF
+
+
+#if HW_CLI_GUI_FRAME == 1
+// frame 모드에서는 그리기 함수가 back 에 쓰고 flush() 가 front 와 달라진 칸만 보낸다.
+// front 는 터미널에 지금 보이는 내용이다.
+typedef struct
+{
+  uint8_t  ch[CLI_GUI_HEIGHT][CLI_GUI_WIDTH];
+  uint16_t attr[CLI_GUI_HEIGHT][CLI_GUI_WIDTH];
+} cli_gui_frame_t;
+#endif
+
 
 static uint16_t cli_gui_w = CLI_GUI_WIDTH;
 static uint16_t cli_gui_h = CLI_GUI_HEIGHT;
@@ -22,28 +36,132 @@ static bool    cli_gui_is_init = false;
 static uint8_t cli_gui_scrl_start = 0;   
 static uint8_t cli_gui_scrl_end   = CLI_GUI_HEIGHT - 1;
 
-static char line_buf[1024];
+static char line_buf[CLI_GUI_WIDTH + 1];
+
+static uint8_t  term_x       = CLI_GUI_POS_NONE;
+static uint8_t  term_y       = CLI_GUI_POS_NONE;
+static uint16_t term_attr    = 0xFFFF;
+static uint8_t  term_charset = 0xFF;
+
+static bool     cli_gui_is_frame = false;
+static bool     cli_gui_is_dry   = false;     // 보내지 않고 byte 수만 센다 (bench)
+static uint16_t cli_gui_attr     = A_NORMAL;
+static uint32_t cli_gui_tx_bytes = 0;
+
+#if HW_CLI_GUI_FRAME == 1
+static cli_gui_frame_t frame_back;
+static cli_gui_frame_t frame_front;
+#endif
+
+#if CLI_USE(HW_CLI_GUI)
+static void cliGuiBench(cli_args_t *args);
+static void cliGuiDemo(cli_args_t *args);
+
+static const cli_item_t cli_sub_tbl[] =
+{
+  CLI_ITEM("bench", cliGuiBench, 0, 1, "[frames]"),
+  CLI_ITEM("demo",  cliGuiDemo,  0, 1, "[byte_max]"),
+};
+
+static const cli_item_t cli_item = CLI_GROUP("gui", cli_sub_tbl, "");
+#endif
+
+
+static void guiWrite(const uint8_t *p_data, uint32_t length)
+{
+  cli_gui_tx_bytes += length;
+  if (cli_gui_is_dry != true)
+  {
+    cliWrite((uint8_t *)p_data, length);
+  }
+}
 
+static void guiPutch(uint8_t ch)
+{
+  guiWrite(&ch, 1);
+}
 
+static void guiPrintf(const char *fmt, ...)
+{
+  char    buf[32];
+  int32_t len;
+  va_list arg;
+
+  va_start (arg, fmt);
+  len = printVSnprintf(buf, sizeof(buf), fmt, arg);
+  va_end (arg);
 
+  guiWrite((uint8_t *)buf, constrain(len, 0, (int32_t)sizeof(buf) - 1));
+}
+
+#if HW_CLI_GUI_FRAME == 1
+static void frameFill(cli_gui_frame_t *p_frame, uint8_t ch, uint16_t attr)
+{
+  memset(p_frame->ch, ch, sizeof(p_frame->ch));
+  for (int y=0; y<CLI_GUI_HEIGHT; y++)
+  {
+    for (int x=0; x<CLI_GUI_WIDTH; x++)
+    {
+      p_frame->attr[y][x] = attr;
+    }
+  }
+}
+#endif
+
+// 다음 flush 에서 화면 전체를 다시 보내게 한다.
+static void invalidate(void)
+{
+#if HW_CLI_GUI_FRAME == 1
+  memset(frame_front.ch, 0, sizeof(frame_front.ch));
+#endif
+}
+
+
+
+
+bool cliGuiInit(void)
+{
+#if CLI_USE(HW_CLI_GUI)
+  cliAddItem(&cli_item);
+#endif
+  return true;
+}
 
 static void initScreen(int16_t w, int16_t h)
 {
 
-  cli_gui_w = w;
-  cli_gui_h = h;
+  cli_gui_w = constrain(w, 1, CLI_GUI_WIDTH);
+  cli_gui_h = constrain(h, 1, CLI_GUI_HEIGHT);
+
+  // frame 모드여도 터미널은 바로 지우고 두 버퍼를 빈 화면으로 맞춘다.
+  term_x       = CLI_GUI_POS_NONE;
+  term_y       = CLI_GUI_POS_NONE;
+  term_attr    = 0xFFFF;
+  term_charset = 0xFF;
+  cli_gui_attr = A_NORMAL;
 
-  cliPrintf(SEQ_LOAD_G1);
+  guiPrintf(SEQ_LOAD_G1);
 
   cliGui()->showCursor(false);
-  cliGui()->setAttr(A_NORMAL);
-  cliGui()->move(0, 0);
-  cliGui()->clear();
+  guiPrintf("%sm", SEQ_ATTRSET);
+  term_attr = A_NORMAL;
+  guiPrintf("%sH", SEQ_CSI);
+  guiPrintf(SEQ_CLEAR);
+  term_x = 0;
+  term_y = 0;
+  cli_gui_curx = 0;
+  cli_gui_cury = 0;
+
+#if HW_CLI_GUI_FRAME == 1
+  frameFill(&frame_back, ' ', A_NORMAL);
+  frameFill(&frame_front, ' ', A_NORMAL);
+#endif
   cli_gui_is_init = true;
 }
 
 static void closeScreen(void)
 {  
+  cli_gui_is_frame = false;
   cliGui()->setAttr(A_NORMAL);
   cliGui()->showCursor(true);
 
@@ -61,82 +179,97 @@ static uint32_t getHeight(void)
   return cli_gui_h;
 }
 
-static void setAttr(uint16_t attr)
+static uint32_t guiAttrStr(uint16_t attr, char *p_buf)
 {
-  static uint16_t cur_attr = 0xff;     
-  uint8_t idx = 0;
+  uint32_t len = 0;
+  uint8_t  idx;
 
-  if (attr != cur_attr)
+  len += printSnprintf(&p_buf[len], 8, SEQ_ATTRSET);
+
+  idx = (attr & F_COLOR) >> 8;
+  if (idx >= 1 && idx <= 8)
   {
-    cliPrintf(SEQ_ATTRSET);
+    len += printSnprintf(&p_buf[len], 8, "%s%c", SEQ_ATTRSET_FCOLOR, idx - 1 + '0');
+  }
 
-    idx = (attr & F_COLOR) >> 8;
+  idx = (attr & B_COLOR) >> 12;
+  if (idx >= 1 && idx <= 8)
+  {
+    len += printSnprintf(&p_buf[len], 8, "%s%c", SEQ_ATTRSET_BCOLOR, idx - 1 + '0');
+  }
 
-    if (idx >= 1 && idx <= 8)
-    {
-      cliPrintf(SEQ_ATTRSET_FCOLOR);
-      cliPutch(idx - 1 + '0');
-    }
+  if (attr & A_REVERSE)   len += printSnprintf(&p_buf[len], 8, SEQ_ATTRSET_REVERSE);
+  if (attr & A_UNDERLINE) len += printSnprintf(&p_buf[len], 8, SEQ_ATTRSET_UNDERLINE);
+  if (attr & A_BLINK)     len += printSnprintf(&p_buf[len], 8, SEQ_ATTRSET_BLINK);
+  if (attr & A_BOLD)      len += printSnprintf(&p_buf[len], 8, SEQ_ATTRSET_BOLD);
+  if (attr & A_DIM)       len += printSnprintf(&p_buf[len], 8, SEQ_ATTRSET_DIM);
+  p_buf[len++] = 'm';
+  p_buf[len]   = 0;
 
-    idx = (attr & B_COLOR) >> 12;
+  return len;
+}
 
-    if (idx >= 1 && idx <= 8)
-    {
-      cliPrintf(SEQ_ATTRSET_BCOLOR);
-      cliPutch(idx - 1 + '0');
-    }
+static void guiSetAttr(uint16_t attr)
+{
+  char     buf[32];
+  uint32_t len;
 
-    if (attr & A_REVERSE)
-    {
-      cliPrintf(SEQ_ATTRSET_REVERSE);
-    }
-    if (attr & A_UNDERLINE)
-    {
-      cliPrintf(SEQ_ATTRSET_UNDERLINE);
-    }
-    if (attr & A_BLINK)
-    {
-      cliPrintf(SEQ_ATTRSET_BLINK);
-    }
-    if (attr & A_BOLD)
-    {
-      cliPrintf(SEQ_ATTRSET_BOLD);
-    }
-    if (attr & A_DIM)
-    {
-      cliPrintf(SEQ_ATTRSET_DIM);
-    }
-    cliPutch('m');
-    cur_attr = attr;
+  if (attr != term_attr)
+  {
+    len = guiAttrStr(attr, buf);
+    guiWrite((uint8_t *)buf, len);
+    term_attr = attr;
+  }
+}
+
+static void setAttr(uint16_t attr)
+{
+  cli_gui_attr = attr;
+
+  if (cli_gui_is_frame != true)
+  {
+    guiSetAttr(attr);
   }
 }
 
 static void clear(void)
 {
-  cliPrintf(SEQ_CLEAR);
+#if HW_CLI_GUI_FRAME == 1
+  if (cli_gui_is_frame == true)
+  {
+    frameFill(&frame_back, ' ', A_NORMAL);
+    return;
+  }
+#endif
+  guiPrintf(SEQ_CLEAR);
 }
 
 static void guiMove(uint8_t x, uint8_t y)
 {
-  cliPrintf("%s%d;%dH", SEQ_CSI, y+1,x+1);
+  guiPrintf("%s%d;%dH", SEQ_CSI, y+1,x+1);
+  term_x = x;
+  term_y = y;
 }
 
 static void guiMoveUp(uint8_t y)
 {
-  cliPrintf("\x1B[%dA", y);
+  guiPrintf("\x1B[%dA", y);
+  term_y = CLI_GUI_POS_NONE;
 }
 
 static void guiMoveDown(uint8_t y)
 {
-  cliPrintf("\x1B[%dB", y);
+  guiPrintf("\x1B[%dB", y);
+  term_y = CLI_GUI_POS_NONE;
 }
 
 static void move(uint8_t x, uint8_t y)
 {
-  if (cli_gui_cury != y || cli_gui_curx != x)
+  cli_gui_cury = y;
+  cli_gui_curx = x;
+
+  if (cli_gui_is_frame != true && (term_y != y || term_x != x))
   {
-    cli_gui_cury = y;
-    cli_gui_curx = x;
     guiMove(x, y);
   }
 }
@@ -151,34 +284,60 @@ static void moveDown(uint8_t y)
   guiMoveDown(y);
 }
 
-static void addCh_Or_InsCh (uint8_t ch, bool insert)
+static uint8_t guiCharset(uint8_t ch)
 {
-  static uint8_t  charset = 0xff;
-  static uint8_t  insert_mode = false;
+  return (ch >= 0x80 && ch <= 0x9F) ? CHARSET_G1:CHARSET_G0;
+}
 
-  if (ch >= 0x80 && ch <= 0x9F)
+// 문자 하나를 터미널로 보내고 커서 위치를 따라간다.
+static void guiPutCell(uint8_t ch)
+{
+  uint8_t charset = guiCharset(ch);
+
+  if (charset != term_charset)
+  {
+    guiPutch(charset == CHARSET_G1 ? '\016':'\017');
+    term_charset = charset;
+  }
+  if (charset == CHARSET_G1)
   {
-    if (charset != CHARSET_G1)
-    {
-      cliPutch('\016');         
-      charset = CHARSET_G1;
-    }
     ch -= 0x20;                 
   }
+  guiPutch(ch);
+
+  // 마지막 칸에 쓰면 줄바꿈 처리가 터미널마다 달라서 위치를 모르는 것으로 둔다.
+  if (term_x != CLI_GUI_POS_NONE && term_x + 1 < cli_gui_w)
+  {
+    term_x++;
+  }
   else
   {
-    if (charset != CHARSET_G0)
+    term_x = CLI_GUI_POS_NONE;
+  }
+}
+
+static void addCh_Or_InsCh (uint8_t ch, bool insert)
+{
+  static uint8_t  insert_mode = false;
+
+#if HW_CLI_GUI_FRAME == 1
+  if (cli_gui_is_frame == true && insert != true)
+  {
+    if (cli_gui_curx < cli_gui_w && cli_gui_cury < cli_gui_h)
     {
-      cliPutch('\017');         
-      charset = CHARSET_G0;
+      frame_back.ch[cli_gui_cury][cli_gui_curx]   = ch;
+      frame_back.attr[cli_gui_cury][cli_gui_curx] = cli_gui_attr;
     }
+    cli_gui_curx++;
+    return;
   }
+#endif
 
   if (insert)
   {
     if (! insert_mode)
     {
-      cliPrintf(SEQ_INSERT_MODE);
+      guiPrintf(SEQ_INSERT_MODE);
       insert_mode = true;
     }
   }
@@ -186,13 +345,17 @@ static void addCh_Or_InsCh (uint8_t ch, bool insert)
   {
     if (insert_mode)
     {
-      cliPrintf(SEQ_REPLACE_MODE);
+      guiPrintf(SEQ_REPLACE_MODE);
       insert_mode = false;
     }
   }
 
-  cliPutch(ch);
+  guiPutCell(ch);
   cli_gui_curx++;
+  if (insert)
+  {
+    term_x = CLI_GUI_POS_NONE;
+  }
 }
 
 static void addChar(uint8_t ch)
@@ -359,15 +522,15 @@ static void addStr(const char * str)
 
 static void showCursor(bool visibility)
 {
-    cliPrintf(SEQ_CURSOR_VIS);
+    guiPrintf(SEQ_CURSOR_VIS);
 
   if (visibility == false)
   {
-    cliPutch('l');
+    guiPutch('l');
   }
   else
   {
-    cliPutch('h');
+    guiPutch('h');
   }
 }
 
@@ -429,7 +592,7 @@ static void addPrintf(const char *fmt, ...)
   va_list arg;
   va_start (arg, fmt);
   
-  vsnprintf(line_buf, 1024, fmt, arg);
+  printVSnprintf(line_buf, sizeof(line_buf), fmt, arg);
   va_end (arg);
 
   addStr(line_buf);
@@ -440,7 +603,7 @@ static void movePrintf(uint8_t x, uint8_t y, const char *fmt, ...)
   va_list arg;
   va_start (arg, fmt);
   
-  vsnprintf(line_buf, 1024, fmt, arg);
+  printVSnprintf(line_buf, sizeof(line_buf), fmt, arg);
   va_end (arg);
 
   moveAddStr(x, y, line_buf);
@@ -454,7 +617,8 @@ static void setScrollArea(uint8_t top, uint8_t bottom)
 
 static void delChar(void)
 {
-  cliPrintf(SEQ_DELCH);
+  if (cli_gui_is_frame == true) invalidate();
+  guiPrintf(SEQ_DELCH);
 }
 
 static void shiftLeft(uint8_t x, uint8_t y, uint8_t ch)
@@ -511,40 +675,54 @@ static void guiSetScrollArea(uint_fast8_t top, uint_fast8_t bottom)
 {
   if (top == bottom)
   {
-    cliPrintf(SEQ_RESET_SCRREG); // reset scrolling region
+    guiPrintf(SEQ_RESET_SCRREG); // reset scrolling region
   }
   else
   {
-    cliPrintf("%s%d;%dr", SEQ_CSI, top + 1, bottom + 1);
+    guiPrintf("%s%d;%dr", SEQ_CSI, top + 1, bottom + 1);
   }
 }
 
 static void scroll(void)
 {
+    if (cli_gui_is_frame == true) invalidate();
     guiSetScrollArea (cli_gui_scrl_start, cli_gui_scrl_end);              // set scrolling region
     guiMove(0, cli_gui_scrl_end);                                         // goto to last line of scrolling region
-    cliPrintf(SEQ_NEXTLINE);                                              // next line
+    guiPrintf(SEQ_NEXTLINE);                                              // next line
     guiSetScrollArea (0, 0);                                              // reset scrolling region
     guiMove(cli_gui_curx, cli_gui_cury);                                  // restore position
 }
 
 static void insertLine(void)
 {
+    if (cli_gui_is_frame == true) invalidate();
     guiSetScrollArea(cli_gui_cury, cli_gui_scrl_end);                     // set scrolling region
     guiMove(0, cli_gui_cury);                                             // goto to current line
-    cliPrintf(SEQ_INSERTLINE);                                            // insert line
+    guiPrintf(SEQ_INSERTLINE);                                            // insert line
     guiSetScrollArea(0, 0);                                               // reset scrolling region
     guiMove(cli_gui_curx, cli_gui_cury);                                  // restore position
 }
 
 static void insChar(uint8_t ch)
 {
+  if (cli_gui_is_frame == true) invalidate();
   addCh_Or_InsCh(ch, true);
 }
 
 static void clearToEol(void)
 {
-  cliPrintf(SEQ_CLRTOEOL);
+#if HW_CLI_GUI_FRAME == 1
+  if (cli_gui_is_frame == true)
+  {
+    for (int x=cli_gui_curx; x<cli_gui_w && cli_gui_cury<cli_gui_h; x++)
+    {
+      frame_back.ch[cli_gui_cury][x]   = ' ';
+      frame_back.attr[cli_gui_cury][x] = cli_gui_attr;
+    }
+    return;
+  }
+#endif
+  guiPrintf(SEQ_CLRTOEOL);
 }
 
 static void message(const char * msg)
@@ -554,6 +732,190 @@ static void message(const char * msg)
   clearToEol();
 }
 
+// HW_CLI_GUI_FRAME 이 0 이면 frame 모드 없이 바로 그린다.
+static void setFrame(bool enable)
+{
+#if HW_CLI_GUI_FRAME == 1
+  if (enable == true && cli_gui_is_frame != true)
+  {
+    frame_back = frame_front;
+  }
+  cli_gui_is_frame = enable;
+#else
+  (void)enable;
+#endif
+}
+
+#if HW_CLI_GUI_FRAME == 1
+
+static uint32_t guiNumLen(uint32_t value)
+{
+  uint32_t len = 1;
+
+  while(value >= 10)
+  {
+    value /= 10;
+    len++;
+  }
+  return len;
+}
+
+enum
+{
+  GUI_MOVE_NONE,
+  GUI_MOVE_CUP,
+  GUI_MOVE_CUF,
+  GUI_MOVE_CR,
+  GUI_MOVE_BRIDGE,
+};
+
+// (x, y) 로 가는 가장 짧은 방법을 고른다.
+// bridge 는 커서와 x 사이의 바뀌지 않은 칸을 그대로 다시 보내는 방법이다.
+static uint32_t guiMoveCost(uint8_t x, uint8_t y, uint8_t *p_type)
+{
+  uint32_t best;
+  uint32_t cost;
+
+  *p_type = GUI_MOVE_CUP;
+  best    = 4 + guiNumLen(y + 1) + guiNumLen(x + 1);
+
+  if (term_y != y || term_x == CLI_GUI_POS_NONE)
+  {
+    return best;
+  }
+
+  if (x == term_x)
+  {
+    *p_type = GUI_MOVE_NONE;
+    return 0;
+  }
+
+  if (x > term_x)
+  {
+    uint8_t n = x - term_x;
+    bool    is_bridge = true;
+
+    cost = (n == 1) ? 3 : 3 + guiNumLen(n);
+    if (cost < best)
+    {
+      best    = cost;
+      *p_type = GUI_MOVE_CUF;
+    }
+
+    for (uint8_t i=term_x; i<x; i++)
+    {
+      if (frame_front.ch[y][i] == 0 ||
+          frame_front.attr[y][i] != term_attr ||
+          guiCharset(frame_front.ch[y][i]) != term_charset)
+      {
+        is_bridge = false;
+        break;
+      }
+    }
+    if (is_bridge == true && n < best)
+    {
+      best    = n;
+      *p_type = GUI_MOVE_BRIDGE;
+    }
+  }
+  else
+  {
+    cost = 1 + ((x == 0) ? 0 : ((x == 1) ? 3 : 3 + guiNumLen(x)));
+    if (cost < best)
+    {
+      best    = cost;
+      *p_type = GUI_MOVE_CR;
+    }
+  }
+
+  return best;
+}
+
+static void guiFlushMove(uint8_t x, uint8_t y, uint8_t type)
+{
+  switch(type)
+  {
+    case GUI_MOVE_CUP:
+      guiMove(x, y);
+      break;
+
+    case GUI_MOVE_CUF:
+      if (x - term_x == 1) guiPrintf("%sC", SEQ_CSI);
+      else                 guiPrintf("%s%dC", SEQ_CSI, x - term_x);
+      term_x = x;
+      break;
+
+    case GUI_MOVE_CR:
+      guiPutch('\r');
+      if (x == 1)     guiPrintf("%sC", SEQ_CSI);
+      else if (x > 1) guiPrintf("%s%dC", SEQ_CSI, x);
+      term_x = x;
+      break;
+
+    case GUI_MOVE_BRIDGE:
+      for (uint8_t i=term_x; i<x; i++)
+      {
+        guiPutCell(frame_front.ch[y][i]);
+      }
+      break;
+  }
+}
+
+// back 과 front 가 다른 칸만 보낸다. byte_max 를 넘기 전에 멈추고 남은 칸은 다음 flush 에서 보낸다.
+// byte_max 가 한 칸보다 작아도 매번 최소 한 칸은 보낸다. 0 이면 제한이 없다. 보낸 byte 수를 돌려준다.
+static uint32_t flush(uint32_t byte_max)
+{
+  uint32_t pre_bytes = cli_gui_tx_bytes;
+  char     attr_buf[32];
+  uint32_t attr_len;
+  uint32_t cost;
+  uint8_t  type;
+
+
+  for (uint8_t y=0; y<cli_gui_h; y++)
+  {
+    for (uint8_t x=0; x<cli_gui_w; x++)
+    {
+      uint8_t  ch   = frame_back.ch[y][x];
+      uint16_t attr = frame_back.attr[y][x];
+
+      if (ch == frame_front.ch[y][x] && attr == frame_front.attr[y][x])
+      {
+        continue;
+      }
+
+      cost     = guiMoveCost(x, y, &type);
+      attr_len = (attr != term_attr) ? guiAttrStr(attr, attr_buf) : 0;
+      cost    += attr_len + (guiCharset(ch) != term_charset ? 1:0) + 1;
+
+      if (byte_max > 0 && cli_gui_tx_bytes != pre_bytes && (cli_gui_tx_bytes - pre_bytes) + cost > byte_max)
+      {
+        return cli_gui_tx_bytes - pre_bytes;
+      }
+
+      guiFlushMove(x, y, type);
+      if (attr_len > 0)
+      {
+        guiWrite((uint8_t *)attr_buf, attr_len);
+        term_attr = attr;
+      }
+      guiPutCell(ch);
+
+      frame_front.ch[y][x]   = ch;
+      frame_front.attr[y][x] = attr;
+    }
+  }
+
+  return cli_gui_tx_bytes - pre_bytes;
+}
+#else
+static uint32_t flush(uint32_t byte_max)
+{
+  (void)byte_max;
+  return 0;
+}
+#endif
+
 cli_gui_api_t *cliGui(void)
 {
   static cli_gui_api_t cli_gui_api = 
@@ -586,9 +948,156 @@ cli_gui_api_t *cliGui(void)
     .drawBox = drawBox,
     .drawBoxLine = drawBoxLine,
     .eraseBox = eraseBox,
+
+    .setFrame = setFrame,
+    .flush = flush,
+    .invalidate = invalidate,
   };
 
   return &cli_gui_api;
 }
 
+#if CLI_USE(HW_CLI_GUI)
+// 숫자 몇 개와 막대 하나가 바뀌는 전형적인 상태 화면
+static void guiDrawDashboard(uint32_t frame_i, uint32_t uptime, uint32_t flush_bytes)
+{
+  cli_gui_api_t *p_gui = cliGui();
+  uint32_t bar_w = CLI_GUI_WIDTH - 6;
+  uint32_t bar_i = frame_i % (bar_w + 1);
+
+  p_gui->showTopLine("STM32WB55 BLE");
+
+  p_gui->drawBox(0, 3, CLI_GUI_WIDTH/2, 7, "System");
+  p_gui->movePrintf(2, 5, "uptime : %10d ms", uptime);
+  p_gui->movePrintf(2, 6, "frame  : %10d", frame_i);
+  p_gui->movePrintf(2, 7, "flush  : %10d bytes", flush_bytes);
+
+  p_gui->drawBox(CLI_GUI_WIDTH/2, 3, CLI_GUI_WIDTH/2, 7, "Link");
+  p_gui->movePrintf(CLI_GUI_WIDTH/2 + 2, 5, "rx     : %10d", frame_i * 37);
+  p_gui->movePrintf(CLI_GUI_WIDTH/2 + 2, 6, "tx     : %10d", frame_i * 113);
+  p_gui->movePrintf(CLI_GUI_WIDTH/2 + 2, 7, "rssi   : %10d dBm", -40 - (int)(frame_i % 20));
+
+  p_gui->drawBox(0, 11, CLI_GUI_WIDTH, 4, "Progress");
+  p_gui->move(2, 12);
+  p_gui->setAttr(F_GREEN);
+  for (uint32_t i=0; i<bar_w; i++)
+  {
+    p_gui->addChar(i < bar_i ? '#':'.');
+  }
+  p_gui->setAttr(A_NORMAL);
+  p_gui->movePrintf(2, 13, "%3d%%", bar_i * 100 / bar_w);
+
+  p_gui->showBottomLine("Ctrl-C : exit");
+}
+
+void cliGuiBench(cli_args_t *args)
+{
+  uint32_t frames = 100;
+  uint32_t pre_bytes;
+  uint32_t direct_bytes = 0;
+  uint32_t first_bytes  = 0;
+  uint32_t diff_bytes   = 0;
+  uint32_t budget;
+
+  if (args->argc == 1)
+  {
+    frames = constrain(args->getData(0), 2, 10000);
+  }
+
+  // 터미널로 보내지 않고 같은 화면을 두 방식으로 그려서 byte 수를 비교한다.
+  cli_gui_is_dry = true;
+
+  initScreen(CLI_GUI_WIDTH, CLI_GUI_HEIGHT);
+  for (uint32_t i=0; i<frames; i++)
+  {
+    pre_bytes = cli_gui_tx_bytes;
+    guiDrawDashboard(i, i * 100, 0);
+    direct_bytes += cli_gui_tx_bytes - pre_bytes;
+  }
+
+#if HW_CLI_GUI_FRAME == 1
+  initScreen(CLI_GUI_WIDTH, CLI_GUI_HEIGHT);
+  setFrame(true);
+  for (uint32_t i=0; i<frames; i++)
+  {
+    clear();
+    guiDrawDashboard(i, i * 100, 0);
+    pre_bytes = cli_gui_tx_bytes;
+    flush(0);
+    if (i == 0) first_bytes  = cli_gui_tx_bytes - pre_bytes;
+    else        diff_bytes  += cli_gui_tx_bytes - pre_bytes;
+  }
+  setFrame(false);
+#endif
+
+  cli_gui_is_dry = false;
+
+  direct_bytes /= frames;
+  diff_bytes   /= (frames - 1);
+  budget        = 115200 / 10 / 10;
+
+  cliPrintf("frames      : %d (%dx%d)\n", frames, CLI_GUI_WIDTH, CLI_GUI_HEIGHT);
+  cliPrintf("direct      : %d bytes/frame\n", direct_bytes);
+#if HW_CLI_GUI_FRAME == 1
+  cliPrintf("diff        : %d bytes/frame, first %d bytes\n", diff_bytes, first_bytes);
+  cliPrintf("saved       : %d bytes/frame (%d%%)\n",
+            direct_bytes - diff_bytes,
+            direct_bytes > 0 ? (direct_bytes - diff_bytes) * 100 / direct_bytes : 0);
+#else
+  (void)first_bytes;
+  (void)diff_bytes;
+  cliPrintf("diff        : HW_CLI_GUI_FRAME 0\n");
+#endif
+  cliPrintf("115200 10Hz : %d bytes/frame available\n", budget);
+}
+
+static bool cliGuiDemoJob(cli_job_t *p_job)
+{
+  cli_gui_api_t *p_gui = cliGui();
+
+  if (p_job->is_cancel == true)
+  {
+    p_gui->closeScreen();
+    return false;
+  }
+
+  // 10 Hz 로 다시 그린다.
+  if (millis() - p_job->arg[1] >= 100)
+  {
+    p_job->arg[1] = millis();
+
+    p_gui->clear();
+    guiDrawDashboard(p_job->arg[2], millis(), p_job->arg[3]);
+    p_job->arg[3] = p_gui->flush(p_job->arg[0]);
+    p_job->arg[2]++;
+  }
+
+  return true;
+}
+
+void cliGuiDemo(cli_args_t *args)
+{
+  static cli_job_t job;
+
+  if (cliJobIsIdle(&job, "gui demo") != true)
+  {
+    return;
+  }
+  job.arg[0] = HW_CLI_GUI_FLUSH_MAX;
+  job.arg[1] = millis();
+  job.arg[2] = 0;
+  job.arg[3] = 0;
+  if (args->argc == 1)
+  {
+    job.arg[0] = args->getData(0);
+  }
+
+  if (cliJobStart(&job, "gui demo", cliGuiDemoJob) == true)
+  {
+    cliGui()->initScreen(CLI_GUI_WIDTH, CLI_GUI_HEIGHT);
+    cliGui()->setFrame(true);
+  }
+}
+#endif
+
 #endif
\ No newline at end of file
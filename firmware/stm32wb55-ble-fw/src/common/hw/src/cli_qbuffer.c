@@ -0,0 +1,131 @@
+#include "cli_qbuffer.h"
+#include "qbuffer.h"
+
+
+#if CLI_USE(HW_QBUFFER)
+
+
+static void cliQbuffer(cli_args_t *args);
+
+
+
+
+bool cliQbufferInit(void)
+{
+  return cliAdd("qbuffer", cliQbuffer);
+}
+
+// write/read 를 반복한 처리량을 KB/s 로 돌려준다.
+static uint32_t cliQbufferBench(uint32_t size, uint32_t length, uint32_t total_bytes)
+{
+  static uint8_t   buf[4096];
+  static uint8_t   data[1024];
+  static qbuffer_t q;
+  uint32_t       chunk;
+  uint32_t       bytes = 0;
+  uint32_t       pre_cycles;
+  uint32_t       exe_cycles;
+
+
+  qbufferCreateBySize(&q, buf, size, length);
+  qbufferSetName(&q, "bench");
+
+  // 링 크기와 서로소가 되도록 잡아서 매번 다른 위치에서 wrap 되도록 한다.
+  chunk = (length * 3) / 8 + 1;
+  if (chunk * size > sizeof(data))
+  {
+    chunk = sizeof(data) / size;
+  }
+
+  pre_cycles = cycles();
+  while (bytes < total_bytes)
+  {
+    qbufferWrite(&q, data, chunk);
+    qbufferRead(&q, data, chunk);
+    bytes += chunk * size;
+  }
+  exe_cycles = cycles() - pre_cycles;
+
+  qbufferDelete(&q);
+
+  if (exe_cycles == 0)
+  {
+    return 0;
+  }
+  return (uint32_t)(((uint64_t)bytes * SystemCoreClock) / exe_cycles / 1024);
+}
+
+void cliQbuffer(cli_args_t *args)
+{
+  bool ret = false;
+
+
+  if (args->argc >= 1 && args->isStr(0, "bench") == true)
+  {
+    const uint32_t size_tbl[3] = {1, 4, 64};
+    uint32_t       total_bytes = 256 * 1024;
+
+    if (args->argc == 2)
+    {
+      total_bytes = (uint32_t)args->getData(1) * 1024;
+    }
+
+    cliPrintf("size  len    KB/s      len    KB/s\n");
+    for (int i=0; i<3; i++)
+    {
+      uint32_t len_pow2 = 4096 / size_tbl[i];
+      uint32_t len_norm = len_pow2 - (len_pow2 / 8) - 1;
+      uint32_t r_pow2;
+      uint32_t r_norm;
+
+      r_pow2 = cliQbufferBench(size_tbl[i], len_pow2, total_bytes);
+      r_norm = cliQbufferBench(size_tbl[i], len_norm, total_bytes);
+
+      cliPrintf("%-4d  %-5d  %-8d  %-5d  %-8d\n",
+        (int)size_tbl[i],
+        (int)len_pow2, (int)r_pow2,
+        (int)len_norm, (int)r_norm);
+    }
+    ret = true;
+  }
+
+  if (args->argc == 1 && args->isStr(0, "list") == true)
+  {
+    cliPrintf("no name       size  len    used   peak   in         out        drop\n");
+    for (uint32_t i=0; i<qbufferGetCount(); i++)
+    {
+      qbuffer_t *p_q = qbufferGetNode(i);
+
+      cliPrintf("%-2d %-10s %-4d  %-5d  %-5d  %-5d  %-9u  %-9u  %u%s\n",
+        (int)i,
+        p_q->p_name != NULL ? p_q->p_name : "-",
+        (int)p_q->size,
+        (int)p_q->len,
+        (int)qbufferAvailable(p_q),
+        (int)p_q->stat.peak,
+        (unsigned)p_q->stat.in_bytes,
+        (unsigned)p_q->stat.out_bytes,
+        (unsigned)p_q->stat.drop_bytes,
+        p_q->is_overwrite == true ? " (ovw)" : "");
+    }
+    ret = true;
+  }
+
+  if (args->argc == 1 && args->isStr(0, "clear") == true)
+  {
+    for (uint32_t i=0; i<qbufferGetCount(); i++)
+    {
+      qbufferClearStat(qbufferGetNode(i));
+    }
+    ret = true;
+  }
+
+  if (ret != true)
+  {
+    cliPrintf("qbuffer list\n");
+    cliPrintf("qbuffer clear\n");
+    cliPrintf("qbuffer bench [KB]\n");
+  }
+}
+
+#endif
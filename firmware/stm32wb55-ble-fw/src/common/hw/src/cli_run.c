@@ -0,0 +1,546 @@
+#include "cli_run.h"
+#include "cli.h"
+#include "fs.h"
+#include "print.h"
+
+
+#ifdef _USE_HW_CLI_RUN
+
+
+#define CLI_RUN_NAME_MAX      16
+#define CLI_RUN_VALUE_MAX     32
+#define CLI_RUN_FILE_MAX      32
+#define CLI_RUN_READ_MAX      32
+
+
+typedef struct
+{
+  char name[CLI_RUN_NAME_MAX];
+  char value[CLI_RUN_VALUE_MAX];
+} cli_run_var_t;
+
+typedef struct
+{
+  uint32_t offset;          // repeat 다음 줄의 파일 위치
+  uint32_t line_no;
+  uint32_t count;
+  uint32_t index;
+  int8_t   var_i;
+} cli_run_loop_t;
+
+// 파일은 CLI_RUN_READ_MAX 씩 읽으면서 한 줄씩 처리하고 전체를 RAM 에 올리지 않는다.
+typedef struct
+{
+  fs_t       file;
+  cli_job_t  job;
+  char       file_name[CLI_RUN_FILE_MAX];
+
+  bool       is_wait;
+  bool       is_stop_on_error;
+  bool       is_over;
+  uint32_t   line_no;
+  uint32_t   offset;
+  uint32_t   err_cnt;
+  uint8_t    skip_depth;
+
+  uint8_t    rd_buf[CLI_RUN_READ_MAX];
+  uint8_t    rd_len;
+  uint8_t    rd_index;
+  char       line[CLI_LINE_BUF_MAX];
+  char       exp_buf[CLI_LINE_BUF_MAX];
+
+  uint8_t        var_cnt;
+  cli_run_var_t  var[CLI_RUN_VAR_MAX];
+  uint8_t        loop_cnt;
+  cli_run_loop_t loop[CLI_RUN_LOOP_MAX];
+} cli_run_t;
+
+
+static bool cliRunJob(cli_job_t *p_job);
+static bool cliRunSetVar(cli_run_t *p_run, const char *p_name, const char *p_value);
+
+#if CLI_USE(HW_CLI_RUN)
+static void cliRun(cli_args_t *args);
+
+static const cli_item_t cli_item = CLI_ITEM("run", cliRun, 1, 10, "file [arg1 ... arg9]");
+#endif
+
+
+static cli_run_t cli_run;
+
+
+
+
+bool cliRunInit(void)
+{
+  cli_run.file.is_open = false;
+
+#if CLI_USE(HW_CLI_RUN)
+  cliAddItem(&cli_item);
+#endif
+  return true;
+}
+
+bool cliRunFile(const char *file_name)
+{
+  cli_run_t *p_run = &cli_run;
+
+
+  if (p_run->file.is_open == true)
+  {
+    cliPrintf("run : %s is running\n", p_run->file_name);
+    cliSetError();
+    return false;
+  }
+  if (fsIsInit() != true || fsIsExist(file_name) != true)
+  {
+    cliPrintf("run : %s not found\n", file_name);
+    cliSetError();
+    return false;
+  }
+  if (fsFileOpen(&p_run->file, file_name) != true)
+  {
+    cliPrintf("run : %s open fail\n", file_name);
+    cliSetError();
+    return false;
+  }
+
+  strncpy(p_run->file_name, file_name, CLI_RUN_FILE_MAX - 1);
+  p_run->file_name[CLI_RUN_FILE_MAX - 1] = 0;
+
+  p_run->is_wait          = false;
+  p_run->is_stop_on_error = true;
+  p_run->is_over          = false;
+  p_run->line_no          = 0;
+  p_run->offset           = 0;
+  p_run->err_cnt          = 0;
+  p_run->skip_depth       = 0;
+  p_run->rd_len           = 0;
+  p_run->rd_index         = 0;
+  p_run->var_cnt          = 0;
+  p_run->loop_cnt         = 0;
+
+  if (cliJobStart(&p_run->job, "run", cliRunJob) != true)
+  {
+    fsFileClose(&p_run->file);
+    return false;
+  }
+
+  return true;
+}
+
+bool cliRunBoot(void)
+{
+  bool ret = false;
+
+#ifdef HW_CLI_RUN_BOOT_FILE
+  if (fsIsInit() == true && fsIsExist(HW_CLI_RUN_BOOT_FILE) == true)
+  {
+    cliPrintf("\nrun %s\n", HW_CLI_RUN_BOOT_FILE);
+    ret = cliRunFile(HW_CLI_RUN_BOOT_FILE);
+  }
+#endif
+
+  return ret;
+}
+
+static bool cliRunGetLine(cli_run_t *p_run)
+{
+  uint32_t len     = 0;
+  bool     is_line = false;
+  uint8_t  rx_data;
+
+
+  p_run->is_over = false;
+
+  while(1)
+  {
+    if (p_run->rd_index >= p_run->rd_len)
+    {
+      int32_t rd_len;
+
+      rd_len = fsFileRead(&p_run->file, p_run->rd_buf, CLI_RUN_READ_MAX);
+      if (rd_len <= 0)
+      {
+        break;
+      }
+      p_run->rd_len   = rd_len;
+      p_run->rd_index = 0;
+    }
+
+    rx_data = p_run->rd_buf[p_run->rd_index++];
+    p_run->offset++;
+    is_line = true;
+
+    if (rx_data == '\n')
+    {
+      break;
+    }
+    if (rx_data == '\r')
+    {
+      continue;
+    }
+    if (len < CLI_LINE_BUF_MAX - 1)
+    {
+      p_run->line[len++] = rx_data;
+    }
+    else
+    {
+      p_run->is_over = true;
+    }
+  }
+  p_run->line[len] = 0;
+
+  if (is_line == true)
+  {
+    p_run->line_no++;
+  }
+
+  return is_line;
+}
+
+static bool cliRunSeek(cli_run_t *p_run, uint32_t offset)
+{
+  if (fsFileSeek(&p_run->file, offset) < 0)
+  {
+    return false;
+  }
+  p_run->offset   = offset;
+  p_run->rd_len   = 0;
+  p_run->rd_index = 0;
+
+  return true;
+}
+
+static int8_t cliRunFindVar(cli_run_t *p_run, const char *p_name, uint32_t length)
+{
+  for (int i=0; i<p_run->var_cnt; i++)
+  {
+    if (strlen(p_run->var[i].name) == length && strncmp(p_run->var[i].name, p_name, length) == 0)
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+bool cliRunSetVar(cli_run_t *p_run, const char *p_name, const char *p_value)
+{
+  int8_t var_i;
+
+  if (strlen(p_name) >= CLI_RUN_NAME_MAX)
+  {
+    return false;
+  }
+
+  var_i = cliRunFindVar(p_run, p_name, strlen(p_name));
+  if (var_i < 0)
+  {
+    if (p_run->var_cnt >= CLI_RUN_VAR_MAX)
+    {
+      return false;
+    }
+    var_i = p_run->var_cnt++;
+    strcpy(p_run->var[var_i].name, p_name);
+  }
+  strncpy(p_run->var[var_i].value, p_value, CLI_RUN_VALUE_MAX - 1);
+  p_run->var[var_i].value[CLI_RUN_VALUE_MAX - 1] = 0;
+
+  return true;
+}
+
+static bool cliRunIsNameChar(char ch)
+{
+  return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9') || ch == '_';
+}
+
+// $name, ${name} 을 값으로 바꾸고 $$ 는 $ 로 남긴다.
+static bool cliRunExpand(cli_run_t *p_run, const char *p_src)
+{
+  char    *p_dst = p_run->exp_buf;
+  uint32_t len   = 0;
+
+
+  while(*p_src != 0)
+  {
+    const char *p_value;
+
+    if (*p_src == '$' && p_src[1] == '$')
+    {
+      if (len + 1 >= CLI_LINE_BUF_MAX) return false;
+      p_dst[len++] = '$';
+      p_src += 2;
+      continue;
+    }
+
+    if (*p_src == '$')
+    {
+      const char *p_name;
+      uint32_t    name_len = 0;
+      bool        is_brace;
+      int8_t      var_i;
+
+      p_src++;
+      is_brace = (*p_src == '{');
+      if (is_brace) p_src++;
+
+      p_name = p_src;
+      while(cliRunIsNameChar(p_name[name_len])) name_len++;
+      p_src += name_len;
+
+      if (is_brace)
+      {
+        if (*p_src != '}') return false;
+        p_src++;
+      }
+
+      var_i = cliRunFindVar(p_run, p_name, name_len);
+      if (name_len == 0 || var_i < 0)
+      {
+        cliPrintf("undefined $%.*s\n", (int)name_len, p_name);
+        return false;
+      }
+      p_value = p_run->var[var_i].value;
+
+      while(*p_value != 0)
+      {
+        if (len + 1 >= CLI_LINE_BUF_MAX) return false;
+        p_dst[len++] = *p_value++;
+      }
+      continue;
+    }
+
+    if (len + 1 >= CLI_LINE_BUF_MAX) return false;
+    p_dst[len++] = *p_src++;
+  }
+  p_dst[len] = 0;
+
+  return true;
+}
+
+// 앞의 공백을 건너뛰고 단어 하나를 잘라서 돌려준다.
+static char *cliRunNextWord(char **pp_str)
+{
+  char *p_word;
+  char *p_str = *pp_str;
+
+  while(*p_str == ' ' || *p_str == '\t') p_str++;
+  p_word = p_str;
+  while(*p_str != 0 && *p_str != ' ' && *p_str != '\t') p_str++;
+  if (*p_str != 0)
+  {
+    *p_str++ = 0;
+  }
+  while(*p_str == ' ' || *p_str == '\t') p_str++;
+
+  *pp_str = p_str;
+  return p_word;
+}
+
+static bool cliRunLine(cli_run_t *p_run)
+{
+  char *p_line;
+  char *p_cmd;
+
+
+  if (p_run->is_over == true)
+  {
+    cliPrintf("line too long\n");
+    return false;
+  }
+
+  p_line = p_run->line;
+  while(*p_line == ' ' || *p_line == '\t') p_line++;
+  if (*p_line == 0 || *p_line == '#')
+  {
+    return true;
+  }
+
+  // 반복 횟수가 0 인 repeat 블럭은 짝이 맞는 end 까지 건너뛴다.
+  if (p_run->skip_depth > 0)
+  {
+    p_cmd = cliRunNextWord(&p_line);
+    if (strcmp(p_cmd, "repeat") == 0) p_run->skip_depth++;
+    if (strcmp(p_cmd, "end") == 0)    p_run->skip_depth--;
+    return true;
+  }
+
+  if (cliRunExpand(p_run, p_line) != true)
+  {
+    cliPrintf("expand fail\n");
+    return false;
+  }
+  p_line = p_run->exp_buf;
+  p_cmd  = cliRunNextWord(&p_line);
+
+  if (strcmp(p_cmd, "set") == 0)
+  {
+    char *p_name = cliRunNextWord(&p_line);
+
+    if (cliRunSetVar(p_run, p_name, p_line) != true)
+    {
+      cliPrintf("set fail : %s\n", p_name);
+      return false;
+    }
+    return true;
+  }
+
+  if (strcmp(p_cmd, "repeat") == 0)
+  {
+    cli_run_loop_t *p_loop;
+    uint32_t        count;
+    char           *p_name;
+
+    count  = strtoul(cliRunNextWord(&p_line), NULL, 0);
+    p_name = cliRunNextWord(&p_line);
+
+    if (count == 0)
+    {
+      p_run->skip_depth = 1;
+      return true;
+    }
+    if (p_run->loop_cnt >= CLI_RUN_LOOP_MAX)
+    {
+      cliPrintf("repeat depth over\n");
+      return false;
+    }
+
+    p_loop = &p_run->loop[p_run->loop_cnt];
+    p_loop->offset  = p_run->offset;
+    p_loop->line_no = p_run->line_no;
+    p_loop->count   = count;
+    p_loop->index   = 0;
+    p_loop->var_i   = -1;
+    if (p_name[0] != 0)
+    {
+      if (cliRunSetVar(p_run, p_name, "0") != true)
+      {
+        return false;
+      }
+      p_loop->var_i = cliRunFindVar(p_run, p_name, strlen(p_name));
+    }
+    p_run->loop_cnt++;
+    return true;
+  }
+
+  if (strcmp(p_cmd, "end") == 0)
+  {
+    cli_run_loop_t *p_loop;
+
+    if (p_run->loop_cnt == 0)
+    {
+      cliPrintf("end without repeat\n");
+      return false;
+    }
+
+    p_loop = &p_run->loop[p_run->loop_cnt - 1];
+    p_loop->index++;
+    if (p_loop->index < p_loop->count)
+    {
+      if (p_loop->var_i >= 0)
+      {
+        printSnprintf(p_run->var[p_loop->var_i].value, CLI_RUN_VALUE_MAX, "%d", (int)p_loop->index);
+      }
+      p_run->line_no = p_loop->line_no;
+      return cliRunSeek(p_run, p_loop->offset);
+    }
+    p_run->loop_cnt--;
+    return true;
+  }
+
+  if (strcmp(p_cmd, "echo") == 0)
+  {
+    cliPrintf("%s\n", p_line);
+    return true;
+  }
+
+  if (strcmp(p_cmd, "onerror") == 0)
+  {
+    p_run->is_stop_on_error = (strcmp(p_line, "continue") != 0);
+    return true;
+  }
+
+  // 나머지는 CLI 명령으로 실행한다. cliRunStr() 이 다시 나누므로 원래 줄을 넘긴다.
+  if (p_cmd + strlen(p_cmd) < p_line)
+  {
+    p_cmd[strlen(p_cmd)] = ' ';
+  }
+  cliPrintf("> %s", p_cmd);
+  return cliRunStr("%s", p_cmd);
+}
+
+bool cliRunJob(cli_job_t *p_job)
+{
+  cli_run_t *p_run = &cli_run;
+  bool       is_ok = true;
+
+
+  if (p_job->is_cancel == true)
+  {
+    fsFileClose(&p_run->file);
+    return false;
+  }
+
+  // 앞 줄의 명령이 job 이었으면 그 결과로 판단한다.
+  if (p_run->is_wait == true)
+  {
+    p_run->is_wait = false;
+    is_ok = p_job->child_ret;
+  }
+  else if (cliRunGetLine(p_run) == true)
+  {
+    is_ok = cliRunLine(p_run);
+    if (p_job->p_child != NULL)
+    {
+      p_run->is_wait = true;
+      return true;
+    }
+  }
+  else
+  {
+    if (p_run->loop_cnt > 0 || p_run->skip_depth > 0)
+    {
+      cliPrintf("%s : repeat without end\n", p_run->file_name);
+      p_run->err_cnt++;
+    }
+    p_job->ret = (p_run->err_cnt == 0);
+    fsFileClose(&p_run->file);
+    return false;
+  }
+
+  if (is_ok != true)
+  {
+    p_run->err_cnt++;
+    cliPrintf("%s:%d : error\n", p_run->file_name, (int)p_run->line_no);
+
+    if (p_run->is_stop_on_error == true)
+    {
+      p_job->ret = false;
+      fsFileClose(&p_run->file);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+#if CLI_USE(HW_CLI_RUN)
+void cliRun(cli_args_t *args)
+{
+  char arg_name[2] = "1";
+
+  if (cliRunFile(args->getStr(0)) != true)
+  {
+    return;
+  }
+
+  // 나머지 인자는 $1 ~ $9 로 쓴다.
+  for (int i=1; i<args->argc; i++)
+  {
+    arg_name[0] = '0' + i;
+    cliRunSetVar(&cli_run, arg_name, args->getStr(i));
+  }
+}
+#endif
+
+#endif
@@ -0,0 +1,43 @@
+#include "bsp.h"
+#include <time.h>
+
+
+uint32_t SystemCoreClock = 1000000000;
+
+static uint64_t start_ns = 0;
+
+
+
+
+static uint64_t bspGetNs(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+bool bspInit(void)
+{
+  start_ns = bspGetNs();
+  return true;
+}
+
+void delay(uint32_t time_ms)
+{
+  struct timespec ts;
+
+  ts.tv_sec  = time_ms / 1000;
+  ts.tv_nsec = (time_ms % 1000) * 1000000;
+  nanosleep(&ts, NULL);
+}
+
+uint32_t millis(void)
+{
+  return (uint32_t)((bspGetNs() - start_ns) / 1000000);
+}
+
+uint32_t cycles(void)
+{
+  return (uint32_t)(bspGetNs() - start_ns);
+}
@@ -0,0 +1,28 @@
+#ifndef BSP_H_
+#define BSP_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "def.h"
+#include "qspi_hal.h"
+
+
+// host 에는 cycle counter 가 없으므로 cycles() 는 ns 를 돌려주고
+// SystemCoreClock 을 1Ghz 로 두어서 cycles -> us 변환이 그대로 맞도록 한다.
+extern uint32_t SystemCoreClock;
+
+
+bool bspInit(void);
+
+void delay(uint32_t time_ms);
+uint32_t millis(void);
+uint32_t cycles(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef HW_DEF_H_
+#define HW_DEF_H_
+
+
+
+#include "bsp.h"
+
+
+// host (Linux) 빌드용 설정. CLI, qbuffer, util 과
+// qspi 드라이버(qspi_model.c 의 flash 모델 위에서)를 빌드한다.
+#define _DEF_FIRMWATRE_VERSION    "V240118R1-HOST"
+#define _DEF_BOARD_NAME           "STM32WB55-BLE-HOST"
+
+
+
+#define _USE_HW_UART
+#define      HW_UART_MAX_CH         2
+#define      HW_UART_CH_PTY         _DEF_UART1
+#define      HW_UART_CH_STDIO       _DEF_UART2
+#define      HW_UART_CH_CLI         HW_UART_CH_PTY
+
+#define _USE_HW_CLI
+#define      HW_CLI_CMD_LIST_MAX    32
+#define      HW_CLI_CMD_HASH_MAX    128
+#define      HW_CLI_CMD_NAME_MAX    16
+#define      HW_CLI_LINE_HIS_MAX    8
+#define      HW_CLI_LINE_BUF_MAX    64
+#define      HW_CLI_SESSION_MAX     2
+#define      HW_CLI_STAT_MAX        32
+
+#define _USE_HW_CLI_BIN
+#define      HW_CLI_BIN_DATA_MAX    256
+#define      HW_CLI_BIN_CMD_MAX     16
+
+#define _USE_HW_QSPI
+#define      HW_QSPI_FLASH_ADDR     0x90000000
+
+
+//-- USE CLI
+//
+#define _USE_CLI_HW_UART            1
+#define _USE_CLI_HW_QBUFFER         1
+#define _USE_CLI_HW_PRINT           1
+#define _USE_CLI_HW_CLI             1
+#define _USE_CLI_HW_QSPI            1
+
+
+#endif
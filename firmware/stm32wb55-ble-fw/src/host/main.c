@@ -0,0 +1,123 @@
+#include "hw_def.h"
+#include "qbuffer.h"
+#include "print.h"
+#include "uart.h"
+#include "cli.h"
+#include "cli_qbuffer.h"
+#include "qspi.h"
+
+#include <unistd.h>
+
+
+// host 빌드 진입점
+//   stm32wb55-ble-host              : pty 에 CLI 를 연다 (picocom, cli_bin.py 등으로 접속)
+//   stm32wb55-ble-host -s           : stdin/stdout 에도 CLI 를 연다
+//   stm32wb55-ble-host -c "cmd" ... : stdin/stdout 에서 명령을 차례로 실행하고 끝낸다.
+//                                     하나라도 실패하면 1 을 돌려준다.
+
+
+static void cliExit(cli_args_t *args);
+
+static volatile bool is_run = true;
+
+
+
+
+static bool hostRunCmd(const char *p_cmd)
+{
+  bool ret;
+
+  ret = cliRunStr("%s", p_cmd);
+
+  // job 으로 넘어간 명령은 끝날 때까지 돌리고 job 의 결과를 돌려준다.
+  while(cliMain() == true)
+  {
+  }
+  if (cliIsError() == true)
+  {
+    ret = false;
+  }
+  return ret;
+}
+
+int main(int argc, char **argv)
+{
+  bool is_stdio = false;
+  int  cmd_cnt  = 0;
+  int  opt;
+  int  ret = 0;
+
+
+  while((opt = getopt(argc, argv, "sc:h")) != -1)
+  {
+    switch(opt)
+    {
+      case 's':
+        is_stdio = true;
+        break;
+
+      case 'c':
+        cmd_cnt++;
+        break;
+
+      default:
+        fprintf(stderr, "usage : %s [-s] [-c cmd]...\n", argv[0]);
+        return 1;
+    }
+  }
+
+  bspInit();
+  cliInit();
+  qbufferInit();
+#if CLI_USE(HW_QBUFFER)
+  cliQbufferInit();
+#endif
+  printInit();
+  uartInit();
+  qspiInit();
+
+  cliAdd("exit", cliExit);
+
+  if (cmd_cnt > 0)
+  {
+    uartOpen(HW_UART_CH_STDIO, 115200);
+    cliOpen(HW_UART_CH_STDIO, 115200);
+
+    optind = 1;
+    while((opt = getopt(argc, argv, "sc:h")) != -1)
+    {
+      if (opt == 'c' && hostRunCmd(optarg) != true)
+      {
+        ret = 1;
+      }
+    }
+    uartPrintf(HW_UART_CH_STDIO, "\n");
+    uartDeInit();
+    return ret;
+  }
+
+  uartOpen(HW_UART_CH_PTY, 115200);
+  cliOpen(HW_UART_CH_PTY, 115200);
+  if (is_stdio == true)
+  {
+    uartOpen(HW_UART_CH_STDIO, 115200);
+    cliOpen(HW_UART_CH_STDIO, 115200);
+  }
+  cliLogo();
+
+  while(is_run == true)
+  {
+    if (cliMain() != true)
+    {
+      delay(1);
+    }
+  }
+  uartDeInit();
+
+  return 0;
+}
+
+void cliExit(cli_args_t *args)
+{
+  is_run = false;
+}
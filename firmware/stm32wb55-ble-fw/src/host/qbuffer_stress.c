@@ -0,0 +1,214 @@
+#include "hw_def.h"
+#include "qbuffer.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+
+// qbuffer SPSC stress
+//   producer thread 는 Reserve/Commit 과 Write 를, consumer thread 는 Peek/Consume 과 Read 를
+//   섞어서 쓰고 byte 순서와 개수를 확인한다. 길이를 마구 바꿔서 wrap 을 자주 넘도록 한다.
+//   2^n 길이(mask)와 아닌 길이, element size 1 과 4 를 모두 돌린다.
+//
+//   qbuffer_stress [MB]        설정마다 MB/8 씩 (기본 64), 실패하면 1 을 돌려준다.
+
+
+typedef struct
+{
+  qbuffer_t  q;
+  uint32_t   total;           // element 단위
+  uint32_t   size;
+
+  uint32_t   in_cnt;
+  uint32_t   out_cnt;
+  uint32_t   err_cnt;
+  uint32_t   err_index;
+  uint32_t   wrap_cnt;
+} stress_t;
+
+
+static uint8_t stressData(uint32_t index)
+{
+  // 2^n 과 맞지 않는 주기로 만들어서 같은 자리에 같은 값이 오지 않도록 한다.
+  return (uint8_t)(index % 251);
+}
+
+static uint32_t stressRand(uint32_t *p_seed)
+{
+  *p_seed = *p_seed * 1103515245 + 12345;
+  return (*p_seed >> 16) & 0x7FFF;
+}
+
+static void *stressProducer(void *p_arg)
+{
+  stress_t *p_st = (stress_t *)p_arg;
+  uint8_t   buf[256 * 4];
+  uint32_t  seed = 1;
+  uint32_t  byte_index = 0;
+
+
+  while(p_st->in_cnt < p_st->total)
+  {
+    uint32_t want = 1 + stressRand(&seed) % 200;
+    uint32_t len;
+
+    want = cmin(want, p_st->total - p_st->in_cnt);
+
+    if (stressRand(&seed) & 1)
+    {
+      uint8_t *p_data;
+
+      len = qbufferReserve(&p_st->q, &p_data, want);
+      for (uint32_t i=0; i<len * p_st->size; i++)
+      {
+        p_data[i] = stressData(byte_index + i);
+      }
+      if (len > 0)
+      {
+        if (&p_data[len * p_st->size] == &p_st->q.p_buf[p_st->q.len * p_st->size])
+        {
+          p_st->wrap_cnt++;
+        }
+        qbufferCommit(&p_st->q, len);
+      }
+    }
+    else
+    {
+      // Write 는 다 들어갈 자리가 있을 때만 쓴다. (overwrite 가 아니면 넘치는 만큼 실패)
+      len = cmin(want, p_st->q.len - 1 - qbufferAvailable(&p_st->q));
+      for (uint32_t i=0; i<len * p_st->size; i++)
+      {
+        buf[i] = stressData(byte_index + i);
+      }
+      if (len > 0 && qbufferWrite(&p_st->q, buf, len) != true)
+      {
+        p_st->err_cnt++;
+        break;
+      }
+    }
+
+    byte_index += len * p_st->size;
+    p_st->in_cnt += len;
+    if (len == 0)
+    {
+      sched_yield();
+    }
+  }
+
+  return NULL;
+}
+
+static void *stressConsumer(void *p_arg)
+{
+  stress_t *p_st = (stress_t *)p_arg;
+  uint8_t   buf[256 * 4];
+  uint32_t  seed = 2;
+  uint32_t  byte_index = 0;
+
+
+  while(p_st->out_cnt < p_st->total && p_st->err_cnt == 0)
+  {
+    uint32_t want = 1 + stressRand(&seed) % 200;
+    uint8_t *p_data;
+    uint32_t len;
+
+    if (stressRand(&seed) & 1)
+    {
+      len = qbufferPeek(&p_st->q, &p_data, want);
+    }
+    else
+    {
+      len = cmin(want, qbufferAvailable(&p_st->q));
+      if (len > 0 && qbufferRead(&p_st->q, buf, len) != true)
+      {
+        p_st->err_cnt++;
+        break;
+      }
+      p_data = buf;
+    }
+
+    for (uint32_t i=0; i<len * p_st->size; i++)
+    {
+      if (p_data[i] != stressData(byte_index + i))
+      {
+        if (p_st->err_cnt == 0)
+        {
+          p_st->err_index = byte_index + i;
+        }
+        p_st->err_cnt++;
+      }
+    }
+    if (p_data != buf)
+    {
+      qbufferConsume(&p_st->q, len);
+    }
+
+    byte_index += len * p_st->size;
+    p_st->out_cnt += len;
+    if (len == 0)
+    {
+      sched_yield();
+    }
+  }
+
+  return NULL;
+}
+
+static bool stressRun(uint32_t size, uint32_t length, uint32_t total_bytes)
+{
+  static uint8_t q_buf[4096 * 4];
+  stress_t  st;
+  pthread_t th_in;
+  pthread_t th_out;
+  bool      ret;
+
+
+  memset(&st, 0, sizeof(st));
+  st.size  = size;
+  st.total = total_bytes / size;
+  qbufferCreateBySize(&st.q, q_buf, size, length);
+
+  pthread_create(&th_in,  NULL, stressProducer, &st);
+  pthread_create(&th_out, NULL, stressConsumer, &st);
+  pthread_join(th_in,  NULL);
+  pthread_join(th_out, NULL);
+
+  ret = (st.err_cnt == 0 && st.in_cnt == st.total && st.out_cnt == st.total &&
+         qbufferAvailable(&st.q) == 0 &&
+         st.q.stat.in_bytes == st.q.stat.out_bytes);
+
+  printf("size %d, len %4d%s : in %u, out %u, wrap %u, err %u",
+         size, length, st.q.mask ? " (2^n)":"      ",
+         st.in_cnt, st.out_cnt, st.wrap_cnt, st.err_cnt);
+  if (st.err_cnt > 0)
+  {
+    printf(" (first at byte %u)", st.err_index);
+  }
+  printf(" : %s\n", ret ? "OK":"FAIL");
+
+  return ret;
+}
+
+int main(int argc, char **argv)
+{
+  const uint32_t len_tbl[] = {1024, 1000, 64, 61, 4096};
+  uint32_t total_mb = 64;
+  bool     ret = true;
+
+
+  if (argc > 1)
+  {
+    total_mb = strtoul(argv[1], NULL, 0);
+  }
+
+  for (uint32_t size=1; size<=4; size+=3)
+  {
+    for (uint32_t i=0; i<sizeof(len_tbl)/sizeof(len_tbl[0]); i++)
+    {
+      ret &= stressRun(size, len_tbl[i], total_mb * 1024 * 1024 / 8);
+    }
+  }
+
+  printf("qbuffer_stress : %s\n", ret ? "OK":"FAIL");
+  return ret ? 0:1;
+}
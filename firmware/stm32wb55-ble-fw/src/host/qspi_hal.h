@@ -0,0 +1,251 @@
+#ifndef QSPI_HAL_H_
+#define QSPI_HAL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "def.h"
+
+
+// host 빌드에서 qspi.c 를 그대로 쓰기 위해 STM32 HAL 의 QSPI 부분만 흉내낸다.
+// 뒤에는 qspi_model.c 의 W25Q128 모델이 붙고, 인터럽트는 별도 thread 에서 부른다.
+
+
+typedef enum
+{
+  HAL_OK       = 0x00,
+  HAL_ERROR    = 0x01,
+  HAL_BUSY     = 0x02,
+  HAL_TIMEOUT  = 0x03
+} HAL_StatusTypeDef;
+
+typedef enum
+{
+  HAL_QSPI_STATE_RESET             = 0x00,
+  HAL_QSPI_STATE_READY             = 0x01,
+  HAL_QSPI_STATE_BUSY              = 0x02,
+  HAL_QSPI_STATE_BUSY_INDIRECT_TX  = 0x12,
+  HAL_QSPI_STATE_BUSY_INDIRECT_RX  = 0x22,
+  HAL_QSPI_STATE_BUSY_AUTO_POLLING = 0x42,
+  HAL_QSPI_STATE_BUSY_MEM_MAPPED   = 0x82,
+  HAL_QSPI_STATE_ABORT             = 0x08,
+  HAL_QSPI_STATE_ERROR             = 0x04
+} HAL_QSPI_StateTypeDef;
+
+typedef enum
+{
+  DMA1_Channel3_IRQn = 13,
+  QUADSPI_IRQn       = 50,
+} IRQn_Type;
+
+typedef struct
+{
+  uint32_t CR;
+  uint32_t DCR;
+} QUADSPI_TypeDef;
+
+typedef struct
+{
+  uint32_t CCR;
+} DMA_Channel_TypeDef;
+
+typedef struct
+{
+  uint32_t MODER;
+} GPIO_TypeDef;
+
+typedef struct
+{
+  uint32_t Request;
+  uint32_t Direction;
+  uint32_t PeriphInc;
+  uint32_t MemInc;
+  uint32_t PeriphDataAlignment;
+  uint32_t MemDataAlignment;
+  uint32_t Mode;
+  uint32_t Priority;
+} DMA_InitTypeDef;
+
+typedef struct
+{
+  DMA_Channel_TypeDef *Instance;
+  DMA_InitTypeDef      Init;
+  void                *Parent;
+} DMA_HandleTypeDef;
+
+typedef struct
+{
+  uint32_t ClockPrescaler;
+  uint32_t FifoThreshold;
+  uint32_t SampleShifting;
+  uint32_t FlashSize;
+  uint32_t ChipSelectHighTime;
+  uint32_t ClockMode;
+} QSPI_InitTypeDef;
+
+typedef struct
+{
+  QUADSPI_TypeDef      *Instance;
+  QSPI_InitTypeDef      Init;
+  DMA_HandleTypeDef    *hdma;
+  volatile HAL_QSPI_StateTypeDef State;
+} QSPI_HandleTypeDef;
+
+typedef struct
+{
+  uint32_t Instruction;
+  uint32_t Address;
+  uint32_t AlternateBytes;
+  uint32_t AddressSize;
+  uint32_t AlternateBytesSize;
+  uint32_t DummyCycles;
+  uint32_t InstructionMode;
+  uint32_t AddressMode;
+  uint32_t AlternateByteMode;
+  uint32_t DataMode;
+  uint32_t NbData;
+  uint32_t DdrMode;
+  uint32_t DdrHoldHalfCycle;
+  uint32_t SIOOMode;
+} QSPI_CommandTypeDef;
+
+typedef struct
+{
+  uint32_t Match;
+  uint32_t Mask;
+  uint32_t Interval;
+  uint32_t StatusBytesSize;
+  uint32_t MatchMode;
+  uint32_t AutomaticStop;
+} QSPI_AutoPollingTypeDef;
+
+typedef struct
+{
+  uint32_t TimeOutPeriod;
+  uint32_t TimeOutActivation;
+} QSPI_MemoryMappedTypeDef;
+
+typedef struct
+{
+  uint32_t Pin;
+  uint32_t Mode;
+  uint32_t Pull;
+  uint32_t Speed;
+  uint32_t Alternate;
+} GPIO_InitTypeDef;
+
+
+extern QUADSPI_TypeDef     host_quadspi;
+extern DMA_Channel_TypeDef host_dma1_ch3;
+extern GPIO_TypeDef        host_gpioa;
+extern GPIO_TypeDef        host_gpiob;
+
+#define QUADSPI                         (&host_quadspi)
+#define DMA1_Channel3                   (&host_dma1_ch3)
+#define GPIOA                           (&host_gpioa)
+#define GPIOB                           (&host_gpiob)
+
+#define HAL_QSPI_TIMEOUT_DEFAULT_VALUE  5000U
+
+#define QSPI_INSTRUCTION_NONE           0
+#define QSPI_INSTRUCTION_1_LINE         1
+#define QSPI_ADDRESS_NONE               0
+#define QSPI_ADDRESS_1_LINE             1
+#define QSPI_ADDRESS_4_LINES            3
+#define QSPI_ADDRESS_24_BITS            2
+#define QSPI_ALTERNATE_BYTES_NONE       0
+#define QSPI_ALTERNATE_BYTES_4_LINES    3
+#define QSPI_ALTERNATE_BYTES_8_BITS     0
+#define QSPI_DATA_NONE                  0
+#define QSPI_DATA_1_LINE                1
+#define QSPI_DATA_4_LINES               3
+#define QSPI_DDR_MODE_DISABLE           0
+#define QSPI_SIOO_INST_EVERY_CMD        0
+#define QSPI_SIOO_INST_ONLY_FIRST_CMD   1
+#define QSPI_SAMPLE_SHIFTING_HALFCYCLE  1
+#define QSPI_CLOCK_MODE_0               0
+#define QSPI_CS_HIGH_TIME_2_CYCLE       (1 << 8)
+#define QSPI_CS_HIGH_TIME_5_CYCLE       (4 << 8)
+#define QUADSPI_DCR_CSHT                (7 << 8)
+#define QSPI_MATCH_MODE_AND             0
+#define QSPI_AUTOMATIC_STOP_ENABLE      1
+#define QSPI_TIMEOUT_COUNTER_DISABLE    0
+#define QSPI_FLAG_SM                    (1 << 3)
+
+#define DMA_REQUEST_QUADSPI             20
+#define DMA_PERIPH_TO_MEMORY            0
+#define DMA_PINC_DISABLE                0
+#define DMA_MINC_ENABLE                 1
+#define DMA_PDATAALIGN_BYTE             0
+#define DMA_MDATAALIGN_BYTE             0
+#define DMA_NORMAL                      0
+#define DMA_PRIORITY_HIGH               2
+
+#define GPIO_PIN_2                      (1 << 2)
+#define GPIO_PIN_3                      (1 << 3)
+#define GPIO_PIN_6                      (1 << 6)
+#define GPIO_PIN_7                      (1 << 7)
+#define GPIO_PIN_8                      (1 << 8)
+#define GPIO_PIN_9                      (1 << 9)
+#define GPIO_MODE_AF_PP                 2
+#define GPIO_NOPULL                     0
+#define GPIO_SPEED_FREQ_VERY_HIGH       3
+#define GPIO_AF10_QUADSPI               10
+
+#define MODIFY_REG(REG, CLEARMASK, SETMASK)   ((REG) = (((REG) & (~(CLEARMASK))) | (SETMASK)))
+#define POSITION_VAL(VAL)                     (__builtin_ctz(VAL))
+
+#define __HAL_LINKDMA(HANDLE, FIELD, DMA)     do { (HANDLE)->FIELD = &(DMA); (DMA).Parent = (HANDLE); } while(0)
+#define __HAL_QSPI_CLEAR_FLAG(HANDLE, FLAG)
+#define __HAL_RCC_QSPI_CLK_ENABLE()
+#define __HAL_RCC_QSPI_CLK_DISABLE()
+#define __HAL_RCC_GPIOA_CLK_ENABLE()
+#define __HAL_RCC_GPIOB_CLK_ENABLE()
+#define __HAL_RCC_DMA1_CLK_ENABLE()
+#define __HAL_RCC_DMAMUX1_CLK_ENABLE()
+
+
+void __disable_irq(void);
+void __enable_irq(void);
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t primask);
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority);
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn);
+void HAL_NVIC_ClearPendingIRQ(IRQn_Type IRQn);
+void Error_Handler(void);
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init);
+void HAL_GPIO_DeInit(GPIO_TypeDef *GPIOx, uint32_t GPIO_Pin);
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma);
+HAL_StatusTypeDef HAL_DMA_DeInit(DMA_HandleTypeDef *hdma);
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma);
+
+HAL_StatusTypeDef HAL_QSPI_Init(QSPI_HandleTypeDef *hqspi);
+HAL_StatusTypeDef HAL_QSPI_DeInit(QSPI_HandleTypeDef *hqspi);
+HAL_StatusTypeDef HAL_QSPI_Command(QSPI_HandleTypeDef *hqspi, QSPI_CommandTypeDef *cmd, uint32_t Timeout);
+HAL_StatusTypeDef HAL_QSPI_Transmit(QSPI_HandleTypeDef *hqspi, uint8_t *pData, uint32_t Timeout);
+HAL_StatusTypeDef HAL_QSPI_Receive(QSPI_HandleTypeDef *hqspi, uint8_t *pData, uint32_t Timeout);
+HAL_StatusTypeDef HAL_QSPI_Transmit_DMA(QSPI_HandleTypeDef *hqspi, uint8_t *pData);
+HAL_StatusTypeDef HAL_QSPI_Receive_DMA(QSPI_HandleTypeDef *hqspi, uint8_t *pData);
+HAL_StatusTypeDef HAL_QSPI_AutoPolling(QSPI_HandleTypeDef *hqspi, QSPI_CommandTypeDef *cmd, QSPI_AutoPollingTypeDef *cfg, uint32_t Timeout);
+HAL_StatusTypeDef HAL_QSPI_AutoPolling_IT(QSPI_HandleTypeDef *hqspi, QSPI_CommandTypeDef *cmd, QSPI_AutoPollingTypeDef *cfg);
+HAL_StatusTypeDef HAL_QSPI_MemoryMapped(QSPI_HandleTypeDef *hqspi, QSPI_CommandTypeDef *cmd, QSPI_MemoryMappedTypeDef *cfg);
+HAL_StatusTypeDef HAL_QSPI_Abort(QSPI_HandleTypeDef *hqspi);
+HAL_QSPI_StateTypeDef HAL_QSPI_GetState(QSPI_HandleTypeDef *hqspi);
+void HAL_QSPI_IRQHandler(QSPI_HandleTypeDef *hqspi);
+
+void HAL_QSPI_ErrorCallback(QSPI_HandleTypeDef *hqspi);
+void HAL_QSPI_RxCpltCallback(QSPI_HandleTypeDef *hqspi);
+void HAL_QSPI_TxCpltCallback(QSPI_HandleTypeDef *hqspi);
+void HAL_QSPI_StatusMatchCallback(QSPI_HandleTypeDef *hqspi);
+void HAL_QSPI_MspInit(QSPI_HandleTypeDef *hqspi);
+void HAL_QSPI_MspDeInit(QSPI_HandleTypeDef *hqspi);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
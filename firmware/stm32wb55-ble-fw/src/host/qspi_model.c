@@ -0,0 +1,737 @@
+#define _GNU_SOURCE
+#include "hw_def.h"
+#include "cli.h"
+#include "qspi/w25q128fv.h"
+
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+
+// W25Q128JV 모델
+//   - program/erase 는 typ 시간 동안 WIP 를 세우고 끝날 때 메모리에 반영한다.
+//     지우는 중인 영역은 0x00 으로 채워서 중간에 읽으면 틀린 값이 나오도록 한다.
+//   - suspend(0x75) 는 tSUS 후에 WIP=0, SUS=1 이 되고 resume(0x7A) 하면 남은 시간만큼 다시 busy.
+//   - datasheet 가 금지하는 접근은 고치지 않고 세어서 "qspi-model" 명령으로 보여준다.
+//   - memory mapped 이면 같은 메모리를 HW_QSPI_FLASH_ADDR 에 읽기 전용으로 보여주고
+//     아니면 PROT_NONE 으로 막아서, 나간 뒤에 창을 읽으면 바로 SIGSEGV 가 난다.
+//     continuous read mode 는 reset(0x66, 0x99) 으로만 풀린다.
+//   - 인터럽트(DMA 완료, status match)는 isr thread 가 부른다.
+//     __disable_irq(), HAL_NVIC_DisableIRQ(QUADSPI_IRQn) 는 이 thread 를 막는 lock 이다.
+
+
+#define MODEL_FLASH_SIZE        W25Q128FV_FLASH_SIZE
+#define MODEL_SUSPEND_NS        (W25Q128FV_SUSPEND_MAX_US * 1000ULL)
+#define MODEL_PROG_NS           (400 * 1000ULL)
+#define MODEL_ISR_PERIOD_US     20
+
+#define MODEL_SR1_WIP           0x01
+#define MODEL_SR1_WEL           0x02
+
+
+typedef enum
+{
+  MODEL_OP_NONE,
+  MODEL_OP_PROG,
+  MODEL_OP_ERASE,
+} model_op_t;
+
+typedef struct
+{
+  uint8_t  cmd;
+  uint32_t size;
+  uint32_t typ_ms;
+} model_erase_t;
+
+typedef struct
+{
+  uint8_t *mem;
+  uint8_t *window;
+  bool     is_cont;           // continuous read mode (M7-0 = 0x2x)
+  bool     wel;
+  uint8_t  sr2;
+
+  uint8_t  op;
+  uint32_t op_addr;
+  uint32_t op_len;
+  uint8_t  prog_buf[W25Q128FV_PAGE_SIZE];
+  uint64_t busy_ns;           // op 가 끝나는 시각
+  bool     is_suspend;
+  uint64_t suspend_ns;        // suspend 가 완료되는 시각
+  uint64_t remain_ns;
+  uint64_t resume_ns;
+
+  QSPI_CommandTypeDef     cmd;
+  QSPI_AutoPollingTypeDef poll;
+  bool     is_poll;
+  bool     is_rx_cplt;
+  bool     is_tx_cplt;
+
+  uint32_t cnt_prog;
+  uint32_t cnt_erase;
+  uint32_t cnt_suspend;
+  uint32_t err_busy;          // WIP=1 일 때 read/program/erase
+  uint32_t err_range;         // suspend 된 program/erase 범위를 읽음
+  uint32_t err_wel;           // WEL 없이 program/erase
+  uint32_t err_gap;           // resume 후 tSUS 안에 다시 suspend
+  uint32_t err_cont;          // continuous read mode 를 풀지 않고 보낸 명령
+} model_t;
+
+
+QUADSPI_TypeDef     host_quadspi;
+DMA_Channel_TypeDef host_dma1_ch3;
+GPIO_TypeDef        host_gpioa;
+GPIO_TypeDef        host_gpiob;
+
+static const model_erase_t erase_tbl[] =
+{
+  {SUBSECTOR_ERASE_CMD, W25Q128FV_SUBSECTOR_SIZE, 45},
+  {BLOCK_32K_ERASE_CMD, W25Q128FV_BLOCK_32K_SIZE, 120},
+  {SECTOR_ERASE_CMD,    W25Q128FV_SECTOR_SIZE,    150},
+  {BULK_ERASE_CMD,      W25Q128FV_FLASH_SIZE,     40000},
+};
+
+static model_t model;
+static QSPI_HandleTypeDef *p_hqspi = NULL;
+static pthread_mutex_t model_lock;
+static pthread_mutex_t irq_lock;
+static pthread_t       isr_thread;
+static bool            is_init = false;
+
+static void modelInit(void);
+static void cliModel(cli_args_t *args);
+
+
+
+
+static uint64_t modelGetNs(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void modelUpdate(uint64_t now)
+{
+  if (model.op == MODEL_OP_NONE || model.is_suspend == true || now < model.busy_ns)
+  {
+    return;
+  }
+
+  if (model.op == MODEL_OP_ERASE)
+  {
+    memset(&model.mem[model.op_addr], 0xFF, model.op_len);
+  }
+  else
+  {
+    for (uint32_t i=0; i<model.op_len; i++)
+    {
+      model.mem[model.op_addr + i] &= model.prog_buf[i];
+    }
+  }
+  model.op  = MODEL_OP_NONE;
+  model.wel = false;
+}
+
+static bool modelIsBusy(uint64_t now)
+{
+  modelUpdate(now);
+
+  if (model.is_suspend == true)
+  {
+    return now < model.suspend_ns;
+  }
+  return model.op != MODEL_OP_NONE;
+}
+
+static uint8_t modelReadSr1(uint64_t now)
+{
+  uint8_t reg = 0;
+
+  if (modelIsBusy(now) == true) reg |= MODEL_SR1_WIP;
+  if (model.wel == true)        reg |= MODEL_SR1_WEL;
+
+  return reg;
+}
+
+static uint8_t modelReadSr2(uint64_t now)
+{
+  uint8_t reg = model.sr2;
+
+  if (model.is_suspend == true && now >= model.suspend_ns)
+  {
+    reg |= W25Q128FV_SR2_SUS;
+  }
+  return reg;
+}
+
+static bool modelCanStart(uint64_t now)
+{
+  if (modelIsBusy(now) == true || model.is_suspend == true)
+  {
+    model.err_busy++;
+    return false;
+  }
+  if (model.wel != true)
+  {
+    model.err_wel++;
+    return false;
+  }
+  return true;
+}
+
+static void modelErase(uint8_t cmd, uint32_t addr, uint64_t now)
+{
+  const model_erase_t *p_erase = NULL;
+
+  for (int i=0; i<(int)(sizeof(erase_tbl)/sizeof(model_erase_t)); i++)
+  {
+    if (erase_tbl[i].cmd == cmd)
+    {
+      p_erase = &erase_tbl[i];
+    }
+  }
+  if (p_erase == NULL || modelCanStart(now) != true)
+  {
+    return;
+  }
+
+  model.op      = MODEL_OP_ERASE;
+  model.op_addr = addr & ~(p_erase->size - 1) & (MODEL_FLASH_SIZE - 1);
+  model.op_len  = p_erase->size;
+  model.busy_ns = now + p_erase->typ_ms * 1000000ULL;
+  memset(&model.mem[model.op_addr], 0x00, model.op_len);
+  model.cnt_erase++;
+}
+
+static void modelProgram(uint32_t addr, const uint8_t *p_data, uint32_t length, uint64_t now)
+{
+  if (modelCanStart(now) != true)
+  {
+    return;
+  }
+
+  // page 를 넘으면 page 처음으로 돌아가는 것은 드라이버가 나누어 쓰므로 흉내내지 않는다.
+  length = cmin(length, W25Q128FV_PAGE_SIZE - (addr % W25Q128FV_PAGE_SIZE));
+
+  model.op      = MODEL_OP_PROG;
+  model.op_addr = addr & (MODEL_FLASH_SIZE - 1);
+  model.op_len  = length;
+  model.busy_ns = now + MODEL_PROG_NS;
+  memcpy(model.prog_buf, p_data, length);
+  model.cnt_prog++;
+}
+
+static void modelSuspend(uint64_t now)
+{
+  if (model.op == MODEL_OP_NONE || model.is_suspend == true)
+  {
+    return;
+  }
+  if (now - model.resume_ns < MODEL_SUSPEND_NS)
+  {
+    model.err_gap++;
+  }
+
+  model.is_suspend = true;
+  model.suspend_ns = now + MODEL_SUSPEND_NS;
+  model.remain_ns  = model.busy_ns - now;
+  model.cnt_suspend++;
+}
+
+static void modelResume(uint64_t now)
+{
+  if (model.is_suspend != true)
+  {
+    return;
+  }
+  model.is_suspend = false;
+  model.busy_ns    = now + model.remain_ns;
+  model.resume_ns  = now;
+}
+
+static void modelRead(uint32_t addr, uint8_t *p_data, uint32_t length, uint64_t now)
+{
+  if (modelIsBusy(now) == true)
+  {
+    model.err_busy++;
+    memset(p_data, 0xEE, length);
+    return;
+  }
+
+  if (model.is_suspend == true &&
+      addr < model.op_addr + model.op_len && model.op_addr < addr + length)
+  {
+    model.err_range++;
+  }
+
+  for (uint32_t i=0; i<length; i++)
+  {
+    p_data[i] = model.mem[(addr + i) & (MODEL_FLASH_SIZE - 1)];
+  }
+}
+
+// 명령 + data 단계를 한번에 실행한다. DMA 도 시작할 때 다 옮기고 완료만 isr 에서 알린다.
+static void modelExecute(QSPI_CommandTypeDef *cmd, uint8_t *p_data)
+{
+  uint64_t now = modelGetNs();
+
+  if (model.is_cont == true)
+  {
+    if (cmd->Instruction != RESET_ENABLE_CMD && cmd->Instruction != RESET_MEMORY_CMD)
+    {
+      model.err_cont++;
+    }
+  }
+
+  switch(cmd->Instruction)
+  {
+    case WRITE_ENABLE_CMD:
+      if (modelIsBusy(now) != true)
+      {
+        model.wel = true;
+      }
+      break;
+
+    case WRITE_DISABLE_CMD:
+      model.wel = false;
+      break;
+
+    case READ_STATUS_REG_CMD:
+      p_data[0] = modelReadSr1(now);
+      break;
+
+    case READ_STATUS_REG2_CMD:
+      p_data[0] = modelReadSr2(now);
+      break;
+
+    case WRITE_STATUS_REG2_CMD:
+      if (modelCanStart(now) == true)
+      {
+        model.sr2 = p_data[0] & ~W25Q128FV_SR2_SUS;
+        model.wel = false;
+      }
+      break;
+
+    case READ_FLAG_STATUS_REG_CMD:
+      p_data[0] = modelIsBusy(now) ? 0x00:W25Q128FV_FSR_READY;
+      break;
+
+    case READ_ID_CMD:
+      memset(p_data, 0, cmd->NbData);
+      p_data[0] = 0xEF;
+      p_data[1] = 0x40;
+      p_data[2] = 0x18;
+      break;
+
+    case QUAD_INOUT_FAST_READ_CMD:
+      modelRead(cmd->Address, p_data, cmd->NbData, now);
+      break;
+
+    case QUAD_IN_FAST_PROG_CMD:
+      modelProgram(cmd->Address, p_data, cmd->NbData, now);
+      break;
+
+    case SUBSECTOR_ERASE_CMD:
+    case BLOCK_32K_ERASE_CMD:
+    case SECTOR_ERASE_CMD:
+    case BULK_ERASE_CMD:
+      modelErase(cmd->Instruction, cmd->Address, now);
+      break;
+
+    case PROG_ERASE_SUSPEND_CMD:
+      modelSuspend(now);
+      break;
+
+    case PROG_ERASE_RESUME_CMD:
+      modelResume(now);
+      break;
+
+    case RESET_MEMORY_CMD:
+      model.is_cont    = false;
+      model.op         = MODEL_OP_NONE;
+      model.is_suspend = false;
+      model.wel        = false;
+      break;
+
+    default:
+      break;
+  }
+}
+
+static void *modelIsrThread(void *p_arg)
+{
+  while(1)
+  {
+    QSPI_HandleTypeDef *hqspi = p_hqspi;
+    bool is_rx;
+    bool is_tx;
+    bool is_match = false;
+
+    pthread_mutex_lock(&irq_lock);
+    pthread_mutex_lock(&model_lock);
+    is_rx = model.is_rx_cplt;
+    is_tx = model.is_tx_cplt;
+    model.is_rx_cplt = false;
+    model.is_tx_cplt = false;
+    if (model.is_poll == true)
+    {
+      uint8_t reg;
+
+      modelExecute(&model.cmd, &reg);
+      if ((reg & model.poll.Mask) == model.poll.Match)
+      {
+        model.is_poll = false;
+        is_match = true;
+      }
+    }
+    if (is_rx || is_tx || is_match)
+    {
+      hqspi->State = HAL_QSPI_STATE_READY;
+    }
+    pthread_mutex_unlock(&model_lock);
+
+    if (is_rx)    HAL_QSPI_RxCpltCallback(hqspi);
+    if (is_tx)    HAL_QSPI_TxCpltCallback(hqspi);
+    if (is_match) HAL_QSPI_StatusMatchCallback(hqspi);
+    pthread_mutex_unlock(&irq_lock);
+
+    usleep(MODEL_ISR_PERIOD_US);
+  }
+  return NULL;
+}
+
+void modelInit(void)
+{
+  pthread_mutexattr_t attr;
+
+  pthread_mutexattr_init(&attr);
+  pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+  pthread_mutex_init(&irq_lock, &attr);
+  pthread_mutex_init(&model_lock, &attr);
+
+  int fd;
+
+  // 같은 내용을 모델용(RW)과 memory mapped 창(RO/NONE) 두 곳에 매핑한다.
+  fd = memfd_create("qspi-model", 0);
+  if (fd < 0 || ftruncate(fd, MODEL_FLASH_SIZE) != 0)
+  {
+    perror("qspi-model");
+    exit(1);
+  }
+  model.mem    = mmap(NULL, MODEL_FLASH_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  model.window = mmap((void *)(uintptr_t)HW_QSPI_FLASH_ADDR, MODEL_FLASH_SIZE, PROT_NONE,
+                      MAP_SHARED | MAP_FIXED_NOREPLACE, fd, 0);
+  if (model.mem == MAP_FAILED || model.window != (void *)(uintptr_t)HW_QSPI_FLASH_ADDR)
+  {
+    perror("qspi-model mmap");
+    exit(1);
+  }
+  close(fd);
+
+  memset(model.mem, 0xFF, MODEL_FLASH_SIZE);
+  pthread_create(&isr_thread, NULL, modelIsrThread, NULL);
+
+  cliAdd("qspi-model", cliModel);
+  is_init = true;
+}
+
+
+// PRIMASK 는 이 thread 가 irq_lock 을 잡은 깊이로 둔다.
+static __thread uint32_t irq_depth = 0;
+
+void __disable_irq(void)
+{
+  pthread_mutex_lock(&irq_lock);
+  irq_depth++;
+}
+
+void __enable_irq(void)
+{
+  if (irq_depth > 0)
+  {
+    irq_depth--;
+    pthread_mutex_unlock(&irq_lock);
+  }
+}
+
+uint32_t __get_PRIMASK(void)
+{
+  return irq_depth;
+}
+
+void __set_PRIMASK(uint32_t primask)
+{
+  while(irq_depth > primask)
+  {
+    __enable_irq();
+  }
+}
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority)
+{
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+  if (IRQn == QUADSPI_IRQn) pthread_mutex_unlock(&irq_lock);
+}
+
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+  if (IRQn == QUADSPI_IRQn) pthread_mutex_lock(&irq_lock);
+}
+
+void HAL_NVIC_ClearPendingIRQ(IRQn_Type IRQn)
+{
+}
+
+void Error_Handler(void)
+{
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init)
+{
+}
+
+void HAL_GPIO_DeInit(GPIO_TypeDef *GPIOx, uint32_t GPIO_Pin)
+{
+}
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma)
+{
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_DeInit(DMA_HandleTypeDef *hdma)
+{
+  return HAL_OK;
+}
+
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma)
+{
+}
+
+void HAL_QSPI_IRQHandler(QSPI_HandleTypeDef *hqspi)
+{
+}
+
+HAL_StatusTypeDef HAL_QSPI_Init(QSPI_HandleTypeDef *hqspi)
+{
+  if (is_init != true)
+  {
+    modelInit();
+  }
+  p_hqspi = hqspi;
+  hqspi->State = HAL_QSPI_STATE_READY;
+
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_QSPI_DeInit(QSPI_HandleTypeDef *hqspi)
+{
+  HAL_QSPI_Abort(hqspi);
+  hqspi->State = HAL_QSPI_STATE_RESET;
+
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_QSPI_Command(QSPI_HandleTypeDef *hqspi, QSPI_CommandTypeDef *cmd, uint32_t Timeout)
+{
+  HAL_StatusTypeDef ret = HAL_OK;
+
+  pthread_mutex_lock(&model_lock);
+  if (hqspi->State != HAL_QSPI_STATE_READY)
+  {
+    ret = HAL_BUSY;
+  }
+  else
+  {
+    model.cmd = *cmd;
+    if (cmd->DataMode == QSPI_DATA_NONE)
+    {
+      modelExecute(&model.cmd, NULL);
+    }
+  }
+  pthread_mutex_unlock(&model_lock);
+
+  return ret;
+}
+
+static HAL_StatusTypeDef modelData(QSPI_HandleTypeDef *hqspi, uint8_t *pData, HAL_QSPI_StateTypeDef state)
+{
+  HAL_StatusTypeDef ret = HAL_OK;
+
+  pthread_mutex_lock(&model_lock);
+  if (hqspi->State != HAL_QSPI_STATE_READY)
+  {
+    ret = HAL_BUSY;
+  }
+  else
+  {
+    modelExecute(&model.cmd, pData);
+    if (state == HAL_QSPI_STATE_BUSY_INDIRECT_RX) model.is_rx_cplt = true;
+    if (state == HAL_QSPI_STATE_BUSY_INDIRECT_TX) model.is_tx_cplt = true;
+    hqspi->State = state;
+  }
+  pthread_mutex_unlock(&model_lock);
+
+  return ret;
+}
+
+HAL_StatusTypeDef HAL_QSPI_Transmit(QSPI_HandleTypeDef *hqspi, uint8_t *pData, uint32_t Timeout)
+{
+  return modelData(hqspi, pData, HAL_QSPI_STATE_READY);
+}
+
+HAL_StatusTypeDef HAL_QSPI_Receive(QSPI_HandleTypeDef *hqspi, uint8_t *pData, uint32_t Timeout)
+{
+  return modelData(hqspi, pData, HAL_QSPI_STATE_READY);
+}
+
+HAL_StatusTypeDef HAL_QSPI_Transmit_DMA(QSPI_HandleTypeDef *hqspi, uint8_t *pData)
+{
+  return modelData(hqspi, pData, HAL_QSPI_STATE_BUSY_INDIRECT_TX);
+}
+
+HAL_StatusTypeDef HAL_QSPI_Receive_DMA(QSPI_HandleTypeDef *hqspi, uint8_t *pData)
+{
+  return modelData(hqspi, pData, HAL_QSPI_STATE_BUSY_INDIRECT_RX);
+}
+
+HAL_StatusTypeDef HAL_QSPI_AutoPolling(QSPI_HandleTypeDef *hqspi, QSPI_CommandTypeDef *cmd, QSPI_AutoPollingTypeDef *cfg, uint32_t Timeout)
+{
+  uint32_t pre_time = millis();
+  uint8_t  reg;
+
+  if (hqspi->State != HAL_QSPI_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  while(1)
+  {
+    pthread_mutex_lock(&model_lock);
+    modelExecute(cmd, &reg);
+    pthread_mutex_unlock(&model_lock);
+
+    if ((reg & cfg->Mask) == cfg->Match)
+    {
+      return HAL_OK;
+    }
+    if (millis() - pre_time > Timeout)
+    {
+      return HAL_TIMEOUT;
+    }
+  }
+}
+
+HAL_StatusTypeDef HAL_QSPI_AutoPolling_IT(QSPI_HandleTypeDef *hqspi, QSPI_CommandTypeDef *cmd, QSPI_AutoPollingTypeDef *cfg)
+{
+  HAL_StatusTypeDef ret = HAL_OK;
+
+  pthread_mutex_lock(&model_lock);
+  if (hqspi->State != HAL_QSPI_STATE_READY)
+  {
+    ret = HAL_BUSY;
+  }
+  else
+  {
+    model.cmd     = *cmd;
+    model.poll    = *cfg;
+    model.is_poll = true;
+    hqspi->State  = HAL_QSPI_STATE_BUSY_AUTO_POLLING;
+  }
+  pthread_mutex_unlock(&model_lock);
+
+  return ret;
+}
+
+HAL_StatusTypeDef HAL_QSPI_MemoryMapped(QSPI_HandleTypeDef *hqspi, QSPI_CommandTypeDef *cmd, QSPI_MemoryMappedTypeDef *cfg)
+{
+  HAL_StatusTypeDef ret = HAL_OK;
+
+  pthread_mutex_lock(&model_lock);
+  if (hqspi->State != HAL_QSPI_STATE_READY)
+  {
+    ret = HAL_BUSY;
+  }
+  else
+  {
+    if (modelIsBusy(modelGetNs()) == true || model.is_suspend == true)
+    {
+      model.err_busy++;
+    }
+    if (cmd->AlternateByteMode != QSPI_ALTERNATE_BYTES_NONE && (cmd->AlternateBytes & 0x30) == 0x20)
+    {
+      model.is_cont = true;
+    }
+    mprotect(model.window, MODEL_FLASH_SIZE, PROT_READ);
+    hqspi->State = HAL_QSPI_STATE_BUSY_MEM_MAPPED;
+  }
+  pthread_mutex_unlock(&model_lock);
+
+  return ret;
+}
+
+HAL_StatusTypeDef HAL_QSPI_Abort(QSPI_HandleTypeDef *hqspi)
+{
+  pthread_mutex_lock(&model_lock);
+  model.is_poll    = false;
+  model.is_rx_cplt = false;
+  model.is_tx_cplt = false;
+  if (hqspi->State == HAL_QSPI_STATE_BUSY_MEM_MAPPED)
+  {
+    mprotect(model.window, MODEL_FLASH_SIZE, PROT_NONE);
+  }
+  hqspi->State     = HAL_QSPI_STATE_READY;
+  pthread_mutex_unlock(&model_lock);
+
+  return HAL_OK;
+}
+
+HAL_QSPI_StateTypeDef HAL_QSPI_GetState(QSPI_HandleTypeDef *hqspi)
+{
+  return hqspi->State;
+}
+
+
+void cliModel(cli_args_t *args)
+{
+  bool ret = false;
+
+  if (args->argc == 1 && args->isStr(0, "info"))
+  {
+    pthread_mutex_lock(&model_lock);
+    cliPrintf("prog      : %d\n", model.cnt_prog);
+    cliPrintf("erase     : %d\n", model.cnt_erase);
+    cliPrintf("suspend   : %d\n", model.cnt_suspend);
+    cliPrintf("err busy  : %d\n", model.err_busy);
+    cliPrintf("err range : %d\n", model.err_range);
+    cliPrintf("err wel   : %d\n", model.err_wel);
+    cliPrintf("err gap   : %d\n", model.err_gap);
+    cliPrintf("err cont  : %d\n", model.err_cont);
+    pthread_mutex_unlock(&model_lock);
+    ret = true;
+  }
+
+  if (args->argc == 1 && args->isStr(0, "check"))
+  {
+    uint32_t err;
+
+    pthread_mutex_lock(&model_lock);
+    err = model.err_busy + model.err_range + model.err_wel + model.err_gap + model.err_cont;
+    pthread_mutex_unlock(&model_lock);
+
+    cliPrintf("qspi-model : %s, %d errors\n", err == 0 ? "OK":"Fail", err);
+    ret = true;
+  }
+
+  if (ret == false)
+  {
+    cliPrintf("qspi-model info\n");
+    cliPrintf("qspi-model check\n");
+  }
+}
@@ -0,0 +1,525 @@
+#define _GNU_SOURCE
+#include "uart.h"
+#include "qbuffer.h"
+#include "print.h"
+#include "cli.h"
+
+#include <fcntl.h>
+#include <errno.h>
+#include <unistd.h>
+#include <termios.h>
+
+
+// POSIX backend
+//   HW_UART_CH_PTY   : pseudo-terminal, 열릴 때 slave 경로를 stderr 로 알려준다.
+//   HW_UART_CH_STDIO : stdin / stdout
+
+
+#define UART_RX_BUF_LENGTH      4096
+
+
+typedef struct
+{
+  bool     is_open;
+  int      fd_rx;
+  int      fd_tx;
+  int      fd_slave;      // client 가 없을 때도 pty 가 닫히지 않도록 잡아 둔다.
+  uint32_t baud;
+
+  uint32_t rx_cnt;
+  uint32_t tx_cnt;
+  uint32_t rx_overrun;
+
+  bool            is_tty;
+  struct termios  tty_save;
+
+  qbuffer_t qbuffer;
+  uint8_t   rx_buf[UART_RX_BUF_LENGTH];
+} uart_tbl_t;
+
+typedef struct
+{
+  uint8_t  ch;
+  uint32_t sent_len;
+} uart_print_t;
+
+
+#if CLI_USE(HW_UART)
+static void cliUart(cli_args_t *args);
+#endif
+
+static bool       is_init = false;
+static uart_tbl_t uart_tbl[UART_MAX_CH];
+
+
+
+
+bool uartInit(void)
+{
+  for (int i=0; i<UART_MAX_CH; i++)
+  {
+    uart_tbl[i].is_open    = false;
+    uart_tbl[i].fd_rx      = -1;
+    uart_tbl[i].fd_tx      = -1;
+    uart_tbl[i].fd_slave   = -1;
+    uart_tbl[i].baud       = 115200;
+    uart_tbl[i].rx_cnt     = 0;
+    uart_tbl[i].tx_cnt     = 0;
+    uart_tbl[i].rx_overrun = 0;
+    uart_tbl[i].is_tty     = false;
+  }
+
+  is_init = true;
+
+#if CLI_USE(HW_UART)
+  cliAdd("uart", cliUart);
+#endif
+  return true;
+}
+
+bool uartDeInit(void)
+{
+  for (int i=0; i<UART_MAX_CH; i++)
+  {
+    uartClose(i);
+  }
+  is_init = false;
+
+  return true;
+}
+
+bool uartIsInit(void)
+{
+  return is_init;
+}
+
+static bool uartOpenPty(uart_tbl_t *p_uart)
+{
+  struct termios tty;
+  int fd;
+
+  fd = posix_openpt(O_RDWR | O_NOCTTY);
+  if (fd < 0 || grantpt(fd) != 0 || unlockpt(fd) != 0)
+  {
+    return false;
+  }
+
+  p_uart->fd_slave = open(ptsname(fd), O_RDWR | O_NOCTTY);
+  if (p_uart->fd_slave >= 0 && tcgetattr(p_uart->fd_slave, &tty) == 0)
+  {
+    cfmakeraw(&tty);
+    tcsetattr(p_uart->fd_slave, TCSANOW, &tty);
+  }
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+  p_uart->fd_rx = fd;
+  p_uart->fd_tx = fd;
+
+  fprintf(stderr, "pty : %s\n", ptsname(fd));
+  return true;
+}
+
+static bool uartOpenStdio(uart_tbl_t *p_uart)
+{
+  p_uart->fd_rx  = STDIN_FILENO;
+  p_uart->fd_tx  = STDOUT_FILENO;
+  p_uart->is_tty = isatty(STDIN_FILENO);
+
+  // 한 글자씩 받고 echo 는 CLI 가 하도록 한다. Ctrl-C 도 CLI 로 넘긴다.
+  if (p_uart->is_tty == true)
+  {
+    struct termios tty;
+
+    tcgetattr(STDIN_FILENO, &p_uart->tty_save);
+    tty = p_uart->tty_save;
+    tty.c_lflag &= ~(ICANON | ECHO | ISIG | IEXTEN);
+    tty.c_iflag &= ~(ICRNL | IXON);
+    tty.c_cc[VMIN]  = 0;
+    tty.c_cc[VTIME] = 0;
+    tcsetattr(STDIN_FILENO, TCSANOW, &tty);
+  }
+  fcntl(STDIN_FILENO, F_SETFL, fcntl(STDIN_FILENO, F_GETFL) | O_NONBLOCK);
+
+  return true;
+}
+
+bool uartOpen(uint8_t ch, uint32_t baud)
+{
+  bool ret = false;
+  uart_tbl_t *p_uart;
+
+
+  if (ch >= UART_MAX_CH) return false;
+
+  p_uart = &uart_tbl[ch];
+  if (p_uart->is_open == true)
+  {
+    p_uart->baud = baud;
+    return true;
+  }
+
+  switch(ch)
+  {
+    case HW_UART_CH_PTY:
+      ret = uartOpenPty(p_uart);
+      break;
+
+    case HW_UART_CH_STDIO:
+      ret = uartOpenStdio(p_uart);
+      break;
+  }
+
+  if (ret == true)
+  {
+    qbufferCreate(&p_uart->qbuffer, p_uart->rx_buf, UART_RX_BUF_LENGTH);
+    qbufferSetName(&p_uart->qbuffer, ch == HW_UART_CH_PTY ? "pty rx":"stdio rx");
+    p_uart->baud    = baud;
+    p_uart->is_open = true;
+  }
+
+  return ret;
+}
+
+bool uartIsOpen(uint8_t ch)
+{
+  if (ch >= UART_MAX_CH) return false;
+
+  return uart_tbl[ch].is_open;
+}
+
+bool uartIsConnected(uint8_t ch)
+{
+  return uartIsOpen(ch);
+}
+
+bool uartClose(uint8_t ch)
+{
+  uart_tbl_t *p_uart;
+
+  if (ch >= UART_MAX_CH) return false;
+
+  p_uart = &uart_tbl[ch];
+  if (p_uart->is_open != true)
+  {
+    return true;
+  }
+
+  if (p_uart->is_tty == true)
+  {
+    tcsetattr(p_uart->fd_rx, TCSANOW, &p_uart->tty_save);
+  }
+  if (ch == HW_UART_CH_PTY)
+  {
+    close(p_uart->fd_rx);
+    if (p_uart->fd_slave >= 0) close(p_uart->fd_slave);
+  }
+  p_uart->is_open = false;
+
+  return true;
+}
+
+static void uartUpdateRx(uart_tbl_t *p_uart)
+{
+  uint8_t *p_data;
+  uint32_t length;
+  ssize_t  rx_len;
+
+  if (p_uart->is_open != true)
+  {
+    return;
+  }
+
+  length = qbufferReserve(&p_uart->qbuffer, &p_data, UART_RX_BUF_LENGTH);
+  if (length == 0)
+  {
+    p_uart->rx_overrun++;
+    return;
+  }
+
+  rx_len = read(p_uart->fd_rx, p_data, length);
+  if (rx_len > 0)
+  {
+    qbufferCommit(&p_uart->qbuffer, rx_len);
+    p_uart->rx_cnt += rx_len;
+  }
+}
+
+uint32_t uartAvailable(uint8_t ch)
+{
+  if (ch >= UART_MAX_CH) return 0;
+
+  uartUpdateRx(&uart_tbl[ch]);
+  return qbufferAvailable(&uart_tbl[ch].qbuffer);
+}
+
+bool uartFlush(uint8_t ch)
+{
+  if (ch >= UART_MAX_CH) return false;
+
+  uartUpdateRx(&uart_tbl[ch]);
+  qbufferFlush(&uart_tbl[ch].qbuffer);
+  return true;
+}
+
+uint8_t uartRead(uint8_t ch)
+{
+  uint8_t ret = 0;
+
+  if (ch >= UART_MAX_CH) return 0;
+
+  qbufferRead(&uart_tbl[ch].qbuffer, &ret, 1);
+  return ret;
+}
+
+uint32_t uartReadBlock(uint8_t ch, uint8_t *p_data, uint32_t length)
+{
+  uint32_t rx_len;
+
+  // cmin() 은 인자를 두 번 평가하므로 읽는 사이 늘어난 길이로 넘치지 않게 먼저 받아 둔다.
+  rx_len = uartAvailable(ch);
+  rx_len = cmin(rx_len, length);
+  if (rx_len > 0)
+  {
+    qbufferRead(&uart_tbl[ch].qbuffer, p_data, rx_len);
+  }
+  return rx_len;
+}
+
+bool uartPeekSpan(uint8_t ch, uint8_t **pp_data, uint32_t *p_length)
+{
+  uint32_t length = 0;
+
+  if (ch < UART_MAX_CH)
+  {
+    uartUpdateRx(&uart_tbl[ch]);
+    length = qbufferPeek(&uart_tbl[ch].qbuffer, pp_data, uart_tbl[ch].qbuffer.len);
+  }
+  *p_length = length;
+
+  return length > 0 ? true:false;
+}
+
+bool uartConsume(uint8_t ch, uint32_t length)
+{
+  if (ch >= UART_MAX_CH) return false;
+
+  qbufferConsume(&uart_tbl[ch].qbuffer, length);
+  return true;
+}
+
+bool uartAttachRxEvent(uint8_t ch, void (*p_func)(uint8_t ch, uint32_t event))
+{
+  // host 는 polling 으로 처리한다.
+  return false;
+}
+
+uint32_t uartWrite(uint8_t ch, uint8_t *p_data, uint32_t length)
+{
+  uart_tbl_t *p_uart;
+  uint32_t    sent = 0;
+
+  if (ch >= UART_MAX_CH) return 0;
+
+  p_uart = &uart_tbl[ch];
+  if (p_uart->is_open != true)
+  {
+    return 0;
+  }
+
+  while(sent < length)
+  {
+    ssize_t tx_len;
+
+    tx_len = write(p_uart->fd_tx, &p_data[sent], length - sent);
+    if (tx_len > 0)
+    {
+      sent += tx_len;
+    }
+    else if (tx_len < 0 && errno == EAGAIN)
+    {
+      delay(1);
+    }
+    else
+    {
+      break;
+    }
+  }
+  p_uart->tx_cnt += sent;
+
+  return sent;
+}
+
+uint32_t uartWriteEx(uint8_t ch, uint8_t *p_data, uint32_t length, uart_tx_policy_t policy)
+{
+  return uartWrite(ch, p_data, length);
+}
+
+bool uartSetTxPolicy(uint8_t ch, uart_tx_policy_t policy)
+{
+  return ch < UART_MAX_CH;
+}
+
+bool uartFlushTx(uint8_t ch)
+{
+  return ch < UART_MAX_CH;
+}
+
+static void uartPrintOut(void *p_arg, const uint8_t *p_data, uint32_t length)
+{
+  uart_print_t *p_print = (uart_print_t *)p_arg;
+
+  p_print->sent_len += uartWrite(p_print->ch, (uint8_t *)p_data, length);
+}
+
+uint32_t uartVPrintf(uint8_t ch, const char *fmt, va_list arg)
+{
+  uart_print_t print;
+
+
+  print.ch       = ch;
+  print.sent_len = 0;
+  printFormat(uartPrintOut, &print, fmt, arg);
+
+  return print.sent_len;
+}
+
+uint32_t uartPrintf(uint8_t ch, const char *fmt, ...)
+{
+  va_list args;
+  uint32_t ret;
+
+  va_start(args, fmt);
+  ret = uartVPrintf(ch, fmt, args);
+  va_end(args);
+
+  return ret;
+}
+
+uint32_t uartGetBaud(uint8_t ch)
+{
+  if (ch >= UART_MAX_CH) return 0;
+
+  return uart_tbl[ch].baud;
+}
+
+uint32_t uartGetRxCnt(uint8_t ch)
+{
+  if (ch >= UART_MAX_CH) return 0;
+
+  return uart_tbl[ch].rx_cnt;
+}
+
+uint32_t uartGetTxCnt(uint8_t ch)
+{
+  if (ch >= UART_MAX_CH) return 0;
+
+  return uart_tbl[ch].tx_cnt;
+}
+
+uint32_t uartGetRxOverrun(uint8_t ch)
+{
+  if (ch >= UART_MAX_CH) return 0;
+
+  return uart_tbl[ch].rx_overrun;
+}
+
+#if CLI_USE(HW_UART)
+// target 의 'uart speed-test' 와 같은 방식으로 byte/block/span 수신 비용을 비교한다.
+void cliUart(cli_args_t *args)
+{
+  bool ret = false;
+
+
+  if (args->argc == 1 && args->isStr(0, "info"))
+  {
+    for (int i=0; i<UART_MAX_CH; i++)
+    {
+      cliPrintf("_DEF_UART%d : %s, rx %d, overrun %d\n", i+1,
+                i == HW_UART_CH_PTY ? "pty":"stdio", uartGetRxCnt(i), uartGetRxOverrun(i));
+    }
+    ret = true;
+  }
+
+  if (args->argc >= 3 && args->isStr(0, "speed-test"))
+  {
+    uint8_t  uart_ch;
+    uint8_t  mode = 0;
+    uint32_t sec  = 5;
+    uint32_t pre_time;
+    uint32_t pre_cycles;
+    uint64_t rx_cycles = 0;
+    uint32_t rx_bytes  = 0;
+    uint32_t rx_sum    = 0;
+    uint8_t  rx_buf[128];
+
+    uart_ch = constrain(args->getData(1), 1, UART_MAX_CH) - 1;
+
+    if (args->isStr(2, "block")) mode = 1;
+    if (args->isStr(2, "span"))  mode = 2;
+    if (args->argc == 4)
+    {
+      sec = constrain(args->getData(3), 1, 60);
+    }
+
+    cliPrintf("send data to _DEF_UART%d for %d sec\n", uart_ch + 1, sec);
+    uartFlush(uart_ch);
+
+    pre_time = millis();
+    while(millis()-pre_time < sec * 1000)
+    {
+      pre_cycles = cycles();
+      if (mode == 0)
+      {
+        while(uartAvailable(uart_ch) > 0)
+        {
+          rx_sum += uartRead(uart_ch);
+          rx_bytes++;
+        }
+      }
+      else if (mode == 1)
+      {
+        uint32_t rx_len;
+
+        rx_len = uartReadBlock(uart_ch, rx_buf, sizeof(rx_buf));
+        for (int i=0; i<rx_len; i++)
+        {
+          rx_sum += rx_buf[i];
+        }
+        rx_bytes += rx_len;
+      }
+      else
+      {
+        uint8_t *p_data;
+        uint32_t rx_len;
+
+        if (uartPeekSpan(uart_ch, &p_data, &rx_len) == true)
+        {
+          for (int i=0; i<rx_len; i++)
+          {
+            rx_sum += p_data[i];
+          }
+          uartConsume(uart_ch, rx_len);
+          rx_bytes += rx_len;
+        }
+      }
+      rx_cycles += cycles() - pre_cycles;
+    }
+    uartFlush(uart_ch);
+
+    cliPrintf("rx bytes   : %d\n", rx_bytes);
+    cliPrintf("rx speed   : %d KB/s\n", rx_bytes / sec / 1024);
+    cliPrintf("rx sum     : 0x%X\n", rx_sum);
+    if (rx_bytes > 0)
+    {
+      cliPrintf("cycle/byte : %d.%02d\n", (int)(rx_cycles / rx_bytes), (int)(rx_cycles * 100 / rx_bytes % 100));
+    }
+    ret = true;
+  }
+
+  if (ret == false)
+  {
+    cliPrintf("uart info\n");
+    cliPrintf("uart speed-test ch[1~%d] byte:block:span [sec]\n", HW_UART_MAX_CH);
+  }
+}
+#endif
@@ -3,6 +3,7 @@
 
 #ifdef _USE_HW_BUTTON
 #include "gpio.h"
+#include "log.h"
 #include "cli.h"
 #include "swtimer.h"
 
@@ -83,11 +84,11 @@ bool buttonInit(void)
   {
     swtimerSet(timer_ch, 10, LOOP_TIME, buttonISR, NULL);
     swtimerStart(timer_ch);
-    logPrintf("[OK] buttonInit()\n");
+    logI(BUTTON, "[OK] buttonInit()\n");
   }
   else
   {
-    logPrintf("[NG] buttonInit()\n     swtimerGetHandle()\n");
+    logE(BUTTON, "[NG] buttonInit()\n     swtimerGetHandle()\n");
   }
 
 #if CLI_USE(HW_BUTTON)
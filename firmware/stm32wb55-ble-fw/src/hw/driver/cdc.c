@@ -51,6 +51,21 @@ uint8_t cdcRead(void)
   return cdcIfRead();
 }
 
+uint32_t cdcReadBlock(uint8_t *p_data, uint32_t length)
+{
+  return cdcIfReadBlock(p_data, length);
+}
+
+uint32_t cdcPeekSpan(uint8_t **pp_data)
+{
+  return cdcIfPeekSpan(pp_data);
+}
+
+void cdcConsume(uint32_t length)
+{
+  cdcIfConsume(length);
+}
+
 uint32_t cdcWrite(uint8_t *p_data, uint32_t length)
 {
   return cdcIfWrite(p_data, length);
@@ -66,4 +81,9 @@ uint8_t cdcGetType(void)
   return cdcIfGetType();
 }
 
+bool cdcAttachRxEvent(void (*p_func)(void))
+{
+  return cdcIfAttachRxEvent(p_func);
+}
+
 #endif
@@ -3,6 +3,7 @@
 
 #ifdef _USE_HW_EEPROM
 #include "i2c.h"
+#include "log.h"
 #include "cli.h"
 
 
@@ -35,18 +36,18 @@ bool eepromInit()
     ret = eepromValid(0x00);
   }
 
-  logPrintf("[%s] eepromInit()\n", ret ? "OK":"NG");
+  logI(EEPROM, "[%s] eepromInit()\n", ret ? "OK":"NG");
   if (ret == true)
   {
-    logPrintf("     found : 0x%02X\n", i2c_addr);
+    logI(EEPROM, "     found : 0x%02X\n", i2c_addr);
     if (eepromGetLength() >= 1024)
-      logPrintf("     size  : %dKB\n", eepromGetLength()/1024);
+      logI(EEPROM, "     size  : %dKB\n", eepromGetLength()/1024);
     else
-      logPrintf("     size  : %dB\n", eepromGetLength());
+      logI(EEPROM, "     size  : %dB\n", eepromGetLength());
   }
   else
   {
-    logPrintf("     empty\n");
+    logW(EEPROM, "     empty\n");
   }
 
 #if CLI_USE(HW_EEPROM)
@@ -4,6 +4,7 @@
 
 
 #ifdef _USE_HW_FLASH
+#include "log.h"
 #include "cli.h"
 
 
@@ -27,7 +28,7 @@ static void cliFlash(cli_args_t *args);
 bool flashInit(void)
 {
 
-  logPrintf("[OK] flashInit()\n");
+  logI(FLASH, "[OK] flashInit()\n");
 
 #if CLI_USE(HW_FLASH)
   cliAdd("flash", cliFlash);
@@ -5,6 +5,7 @@
 #ifdef _USE_HW_FS
 #include "littlefs/lfs.h"
 #include "qspi.h"
+#include "log.h"
 #include "cli.h"
 
 
@@ -74,7 +75,24 @@ const struct lfs_config cfg =
 
 
 #if CLI_USE(HW_FS)
-static void cliCmd(cli_args_t *args);
+static void cliFsInfo(cli_args_t *args);
+static void cliFsList(cli_args_t *args);
+static void cliFsFormat(cli_args_t *args);
+static void cliFsDel(cli_args_t *args);
+static void cliFsTest(cli_args_t *args);
+static void cliFsSetName(cli_args_t *args);
+
+static const cli_item_t cli_sub_tbl[] =
+{
+  CLI_ITEM("info",     cliFsInfo,    0, 0, ""),
+  CLI_ITEM("list",     cliFsList,    0, 0, ""),
+  CLI_ITEM("format",   cliFsFormat,  0, 0, ""),
+  CLI_ITEM("del",      cliFsDel,     1, 1, "[filename]"),
+  CLI_ITEM("test",     cliFsTest,    0, 0, ""),
+  CLI_ITEM("set_name", cliFsSetName, 1, 1, "name_str"),
+};
+
+static const cli_item_t cli_item = CLI_GROUP("fs", cli_sub_tbl, "");
 #endif
 
 
@@ -92,8 +110,8 @@ bool fsInit(void)
   mutex_lock = osMutexCreate (osMutex(mutex_lock));
 #endif
 
-  logPrintf("[  ] fsInit()\n");
-  logPrintf("     lfs %d.%d\n", LFS_VERSION_MAJOR, LFS_VERSION_MINOR);
+  logI(FS, "[  ] fsInit()\n");
+  logD(FS, "     lfs %d.%d\n", LFS_VERSION_MAJOR, LFS_VERSION_MINOR);
 
   // mount the filesystem
   err = lfs_mount(&lfs, &cfg);
@@ -105,29 +123,29 @@ bool fsInit(void)
     err = lfs_format(&lfs, &cfg);
     if (err == LFS_ERR_OK)
     {
-      logPrintf("     lfs formated\r\n");
+      logW(FS, "     lfs formated\r\n");
     }
     else
     {
-      logPrintf("     lfs format - Fail\r\n");
+      logE(FS, "     lfs format - Fail\r\n");
     }
     err = lfs_mount(&lfs, &cfg);
   }
 
   if (err == LFS_ERR_OK)
   {
-    logPrintf("     lfs mounted\r\n");
+    logI(FS, "     lfs mounted\r\n");
   }
   else
   {
-    logPrintf("     lfs mount - Fail\r\n");
+    logE(FS, "     lfs mount - Fail\r\n");
     ret = false;
   }
 
 
 
 #if CLI_USE(HW_FS)
-  cliAdd("fs", cliCmd);
+  cliAddItem(&cli_item);
 #endif
 
   is_init = ret;
@@ -144,14 +162,14 @@ bool fsInit(void)
 
         fsFileRead(&fs, (uint8_t *)bd_name, 128);
 
-        logPrintf("     bd_name - %s\r\n", bd_name);
+        logD(FS, "     bd_name - %s\r\n", bd_name);
 
         fsFileClose(&fs);
       }
     }
   }
 
-  logPrintf("[%s] fsInit()\n", ret ? "OK" : "NG");
+  logI(FS, "[%s] fsInit()\n", ret ? "OK" : "NG");
 
   return ret;
 }
@@ -449,111 +467,86 @@ static int fsDeviceUnlock(const struct lfs_config *c)
 
 int lfs_ls(lfs_t *lfs, const char *path);
 
-void cliCmd(cli_args_t *args)
+void cliFsInfo(cli_args_t *args)
 {
-  bool ret = false;
-
-  if (args->argc == 1 && args->isStr(0, "info") == true)
+  cliPrintf("fs init   : %d\n", is_init);
+  if (is_init == true)
   {
-    cliPrintf("fs init   : %d\n", is_init);
-    if (is_init == true)
-    {
-      cliPrintf("fs size   : %d KB / %d KB\n", lfs_fs_size(&lfs)*4096/1024, FS_MAX_SIZE/1024);
-      cliPrintf("fs free   : %d KB\n", fsGetFree() / 1024);
-      cliPrintf("fs used   : %d KB\n", (fsGetSize() - fsGetFree()) / 1024);
-    }
-    ret = true;
+    cliPrintf("fs size   : %d KB / %d KB\n", lfs_fs_size(&lfs)*4096/1024, FS_MAX_SIZE/1024);
+    cliPrintf("fs free   : %d KB\n", fsGetFree() / 1024);
+    cliPrintf("fs used   : %d KB\n", (fsGetSize() - fsGetFree()) / 1024);
   }
+}
 
-  if(args->argc == 1 && args->isStr(0, "list") == true)
+void cliFsList(cli_args_t *args)
+{
+  lfs_ls(&lfs, "/");
+}
+
+void cliFsFormat(cli_args_t *args)
+{
+  cliPrintf("format...");
+  if(lfs_format(&lfs, &cfg) > 0)
   {
-    lfs_ls(&lfs, "/");
-    ret = true;
+    cliPrintf("Fail\n");
   }
-
-  if(args->argc == 1 && args->isStr(0, "format") == true)
+  else
   {
-    cliPrintf("format...");
-    if(lfs_format(&lfs, &cfg) > 0)
-    {
-      cliPrintf("Fail\n");
-    }
-    else
-    {
-      cliPrintf("OK\n");
-    }
-    ret = true;
+    cliPrintf("OK\n");
   }
+}
 
-  if(args->argc == 2 && args->isStr(0, "del") == true)
-  {
-    char *file_name;
+void cliFsDel(cli_args_t *args)
+{
+  char *file_name;
 
-    file_name = args->getStr(1);
+  file_name = args->getStr(0);
 
-    cliPrintf("del [%s]...", file_name);
-    if (fsFileDel(file_name) == true)
-    {
-      cliPrintf("OK\n");
-    }
-    else
-    {
-      cliPrintf("Fail\n");
-    }
-    ret = true;
+  cliPrintf("del [%s]...", file_name);
+  if (fsFileDel(file_name) == true)
+  {
+    cliPrintf("OK\n");
   }
-
-
-  if (args->argc == 1 && args->isStr(0, "test") == true)
+  else
   {
-    // read current count
-    uint32_t boot_count = 0;
-    lfs_file_t file;
-
-    lfs_file_open(&lfs, &file, "boot_count", LFS_O_RDWR | LFS_O_CREAT);
-    lfs_file_read(&lfs, &file, &boot_count, sizeof(boot_count));
-
-    // update boot count
-    boot_count += 1;
-    lfs_file_rewind(&lfs, &file);
-    lfs_file_write(&lfs, &file, &boot_count, sizeof(boot_count));
-
-    // remember the storage is not updated until the file is closed successfully
-    lfs_file_close(&lfs, &file);
+    cliPrintf("Fail\n");
+  }
+}
 
-    cliPrintf("boot_count : %d\n", boot_count);
+void cliFsTest(cli_args_t *args)
+{
+  // read current count
+  uint32_t boot_count = 0;
+  lfs_file_t file;
 
-    ret = true;
-  }
+  lfs_file_open(&lfs, &file, "boot_count", LFS_O_RDWR | LFS_O_CREAT);
+  lfs_file_read(&lfs, &file, &boot_count, sizeof(boot_count));
 
-  if (args->argc == 2 && args->isStr(0, "set_name") == true)
-  {
-    char *name;
-    fs_t fs;
+  // update boot count
+  boot_count += 1;
+  lfs_file_rewind(&lfs, &file);
+  lfs_file_write(&lfs, &file, &boot_count, sizeof(boot_count));
 
-    name = args->getStr(1);
+  // remember the storage is not updated until the file is closed successfully
+  lfs_file_close(&lfs, &file);
 
-    if (fsFileOpen(&fs, "bd_name") == true)
-    {
-      fsFileWrite(&fs, (uint8_t *)name, strlen(name) + 1);
-      fsFileClose(&fs);
+  cliPrintf("boot_count : %d\n", boot_count);
+}
 
-      cliPrintf("bd_name : %s\n", name);
-    }
+void cliFsSetName(cli_args_t *args)
+{
+  char *name;
+  fs_t fs;
 
-    ret = true;
-  }
+  name = args->getStr(0);
 
-  if (ret == false)
+  if (fsFileOpen(&fs, "bd_name") == true)
   {
-    cliPrintf("fs info \n");
-    cliPrintf("fs list \n");
-    cliPrintf("fs format \n");
-    cliPrintf("fs del [filename] \n");
-    cliPrintf("fs test \n");
-    cliPrintf("fs set_name name_str \n");
-  }
+    fsFileWrite(&fs, (uint8_t *)name, strlen(name) + 1);
+    fsFileClose(&fs);
 
+    cliPrintf("bd_name : %s\n", name);
+  }
 }
 
 int lfs_ls(lfs_t *lfs, const char *path)
@@ -4,9 +4,15 @@
 
 #ifdef _USE_HW_LOG
 #include "uart.h"
+#include "qbuffer.h"
+#include "print.h"
 #ifdef _USE_HW_CLI
 #include "cli.h"
 #endif
+#ifdef _USE_HW_WPAN
+#include "app_conf.h"
+#include "stm32_seq.h"
+#endif
 
 #ifdef _USE_HW_RTOS
 #define lock()      xSemaphoreTake(mutex_lock, portMAX_DELAY);
@@ -14,13 +20,99 @@
 #endif
 
 
+#define LOG_DEFER_REC_MAX       64
+#define LOG_DEFER_TASK_REC_MAX  16
+
+#define LOG_FRAME_SYNC1         0xA5
+#define LOG_FRAME_SYNC2         0x5A
+
+#define LOG_RAM_MAGIC           0x4C4F4752    // "LOGR"
+
+
+typedef struct
+{
+  const char *fmt;
+  uint32_t    time;
+  uint16_t    seq;
+  uint8_t     argc;
+  uint8_t     rsv;
+  uint32_t    arg[LOG_DEFER_ARG_MAX];
+} log_rec_t;
+
+// warm reset 후에도 남도록 .noinit 에 두고 magic 과 index 보수값으로 유효성을 본다.
+typedef struct
+{
+  uint32_t magic;
+  uint32_t boot_cnt;
+  uint32_t in;        // 지금까지 쓴 byte 수 (free running)
+  uint32_t in_inv;
+  uint8_t  buf[LOG_LIST_BUF_MAX];
+} log_ram_t;
+
+
+#if CLI_USE(HW_LOG)
+static void cliLog(cli_args_t *args);
+#endif
+#ifdef _USE_HW_WPAN
+static void logDeferTask(void);
+#endif
+
+
 static bool is_init = false;
 static bool is_enable = true;
 static bool is_open = false;
+static bool is_defer = false;
+static bool is_boot = true;
 
 static uint8_t  log_ch = LOG_CH;
 static uint32_t log_baud = 57600;
 
+static qbuffer_t         defer_q;
+static log_rec_t         defer_buf[LOG_DEFER_REC_MAX];
+static uint16_t          defer_seq = 0;
+static uint32_t          defer_drop = 0;
+static volatile bool     defer_task_req = false;
+
+static log_ram_t log_ram __attribute__((section(".noinit")));
+static uint32_t  log_boot_begin = 0;
+
+// 컴파일에 남은 호출만 runtime 레벨로 다시 거른다.
+static uint8_t log_level[LOG_MOD_MAX] =
+{
+  [LOG_MOD_SYS]    = HW_LOG_LEVEL_SYS,
+  [LOG_MOD_FS]     = HW_LOG_LEVEL_FS,
+  [LOG_MOD_QSPI]   = HW_LOG_LEVEL_QSPI,
+  [LOG_MOD_EEPROM] = HW_LOG_LEVEL_EEPROM,
+  [LOG_MOD_FLASH]  = HW_LOG_LEVEL_FLASH,
+  [LOG_MOD_NVS]    = HW_LOG_LEVEL_NVS,
+  [LOG_MOD_BUTTON] = HW_LOG_LEVEL_BUTTON,
+  [LOG_MOD_USB]    = HW_LOG_LEVEL_USB,
+  [LOG_MOD_BLE]    = HW_LOG_LEVEL_BLE,
+};
+
+static const char *log_mod_name[LOG_MOD_MAX] =
+{
+  [LOG_MOD_SYS]    = "sys",
+  [LOG_MOD_FS]     = "fs",
+  [LOG_MOD_QSPI]   = "qspi",
+  [LOG_MOD_EEPROM] = "eeprom",
+  [LOG_MOD_FLASH]  = "flash",
+  [LOG_MOD_NVS]    = "nvs",
+  [LOG_MOD_BUTTON] = "button",
+  [LOG_MOD_USB]    = "usb",
+  [LOG_MOD_BLE]    = "ble",
+};
+
+static const char *log_level_name[] =
+{
+  "none",
+  "error",
+  "warn",
+  "info",
+  "debug",
+  "trace",
+};
+
 #ifdef _USE_HW_RTOS
 static SemaphoreHandle_t mutex_lock;
 #endif
@@ -28,25 +120,173 @@ static SemaphoreHandle_t mutex_lock;
 
 
 
+static void logRamInit(void)
+{
+  if (log_ram.magic != LOG_RAM_MAGIC || log_ram.in != ~log_ram.in_inv)
+  {
+    log_ram.magic    = LOG_RAM_MAGIC;
+    log_ram.boot_cnt = 0;
+    log_ram.in       = 0;
+    log_ram.in_inv   = ~0;
+  }
+  log_ram.boot_cnt++;
+  log_boot_begin = log_ram.in;
+}
+
+static void logRamWrite(const uint8_t *p_data, uint32_t length)
+{
+  uint32_t primask;
+  uint32_t index;
+  uint32_t wr_len;
+
+
+  if (length > LOG_LIST_BUF_MAX)
+  {
+    p_data += length - LOG_LIST_BUF_MAX;
+    length  = LOG_LIST_BUF_MAX;
+  }
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+
+  index  = log_ram.in % LOG_LIST_BUF_MAX;
+  wr_len = constrain(length, 0, LOG_LIST_BUF_MAX - index);
+  memcpy(&log_ram.buf[index], p_data, wr_len);
+  memcpy(&log_ram.buf[0], &p_data[wr_len], length - wr_len);
+
+  log_ram.in    += length;
+  log_ram.in_inv = ~log_ram.in;
+
+  __set_PRIMASK(primask);
+}
+
+static void logWrite(const uint8_t *p_data, uint32_t length)
+{
+  logRamWrite(p_data, length);
+
+  if (is_open == true && is_enable == true)
+  {
+    // 부팅 중에는 터미널이 없어도 막히지 않도록 log 출력만 넘치면 버린다.
+    // 같은 uart 의 CLI 출력은 채널 정책을 그대로 따른다.
+    if (is_boot == true)
+      uartWriteEx(log_ch, (uint8_t *)p_data, length, UART_TX_POLICY_DROP);
+    else
+      uartWrite(log_ch, (uint8_t *)p_data, length);
+  }
+}
+
+static void logPrintOut(void *p_arg, const uint8_t *p_data, uint32_t length)
+{
+  logWrite(p_data, length);
+}
+
+static void logVPrintf(const char *fmt, va_list arg)
+{
+  printFormat(logPrintOut, NULL, fmt, arg);
+}
+
 bool logInit(void)
 {
+  logRamInit();
+
+  qbufferCreateBySize(&defer_q, (uint8_t *)defer_buf, sizeof(log_rec_t), LOG_DEFER_REC_MAX);
+  qbufferSetName(&defer_q, "log defer");
+
+#ifdef _USE_HW_WPAN
+  UTIL_SEQ_RegTask(1<<CFG_TASK_LOG_ID, UTIL_SEQ_RFU, logDeferTask);
+#endif
+
   is_init = true;
+
+#if CLI_USE(HW_LOG)
+  cliAdd("log", cliLog);
+#endif
   return true;
 }
 
+void logEnable(void)
+{
+  is_enable = true;
+}
 
+void logDisable(void)
+{
+  is_enable = false;
+}
 
 bool logOpen(uint8_t ch, uint32_t baud)
 {
   log_ch   = ch;
   log_baud = baud;
-  is_open  = true;
 
   is_open = uartOpen(ch, baud);
 
+  // 열리기 전에 ram 버퍼에만 남은 부팅 로그를 먼저 내보낸다.
+  if (is_open == true && is_enable == true)
+  {
+    logReplay(ch);
+  }
+
   return is_open;
 }
 
+void logBoot(uint8_t enable)
+{
+  is_boot = enable ? true:false;
+}
+
+// 이번 부팅에서 ram 버퍼에 남은 로그를 ch 로 다시 보낸다.
+// 부팅 중 버려진 줄도 ram 버퍼에는 남아 있으므로 나중에 붙은 console 에서 볼 수 있다.
+void logReplay(uint8_t ch)
+{
+  uint8_t  buf[64];
+  uint32_t offset = 0;
+  uint32_t len;
+
+
+  while((len = logReadBuf(false, offset, buf, sizeof(buf))) > 0)
+  {
+    if (is_boot == true)
+      uartWriteEx(ch, buf, len, UART_TX_POLICY_DROP);
+    else
+      uartWrite(ch, buf, len);
+    offset += len;
+  }
+}
+
+uint32_t logGetBootCount(void)
+{
+  return log_ram.boot_cnt;
+}
+
+uint32_t logReadBuf(bool is_all, uint32_t offset, uint8_t *p_data, uint32_t length)
+{
+  uint32_t begin;
+  uint32_t end;
+  uint32_t index;
+  uint32_t rd_len;
+
+
+  end   = log_ram.in;
+  begin = is_all ? 0:log_boot_begin;
+  if (end - begin > LOG_LIST_BUF_MAX || begin > end)
+  {
+    begin = end > LOG_LIST_BUF_MAX ? end - LOG_LIST_BUF_MAX:0;
+  }
+
+  if (offset >= end - begin) return 0;
+
+  index  = begin + offset;
+  length = constrain(length, 0, end - index);
+
+  for (rd_len=0; rd_len<length; rd_len++)
+  {
+    p_data[rd_len] = log_ram.buf[(index + rd_len) % LOG_LIST_BUF_MAX];
+  }
+
+  return rd_len;
+}
+
 void logPrintf(const char *fmt, ...)
 {
 #ifdef _USE_HW_RTOS
@@ -57,17 +297,330 @@ void logPrintf(const char *fmt, ...)
 
   if (is_init != true) return;
 
-  if (is_open == true && is_enable == true)
+  va_start(arg, fmt);
+  logVPrintf(fmt, arg);
+  va_end(arg);
+
+#ifdef _USE_HW_RTOS
+  unLock();
+#endif
+}
+
+void logLevelPrintf(log_mod_t mod, uint8_t level, const char *fmt, ...)
+{
+  va_list arg;
+
+  if (is_init != true) return;
+  if (mod >= LOG_MOD_MAX || level > log_level[mod]) return;
+
+  va_start(arg, fmt);
+  logVPrintf(fmt, arg);
+  va_end(arg);
+}
+
+bool logSetLevel(log_mod_t mod, uint8_t level)
+{
+  if (mod >= LOG_MOD_MAX || level > LOG_LEVEL_TRACE)
+    return false;
+
+  log_level[mod] = level;
+  return true;
+}
+
+uint8_t logGetLevel(log_mod_t mod)
+{
+  if (mod >= LOG_MOD_MAX)
+    return LOG_LEVEL_NONE;
+
+  return log_level[mod];
+}
+
+bool logSetDefer(bool enable)
+{
+#ifdef _USE_HW_WPAN
+  is_defer = enable;
+#else
+  // 레코드를 내보낼 sequencer 가 없으면 지원하지 않는다.
+  is_defer = false;
+#endif
+  return is_defer == enable;
+}
+
+bool logIsDefer(void)
+{
+  return is_defer;
+}
+
+void logDeferPrintf(const char *fmt, uint32_t argc, ...)
+{
+  va_list    arg;
+  log_rec_t *p_rec;
+  uint32_t   primask;
+
+
+  if (is_init != true) return;
+
+  va_start(arg, argc);
+
+  if (is_defer != true)
   {
-    va_start(arg, fmt);
-    uartVPrintf(log_ch, fmt, arg);
+    logVPrintf(fmt, arg);
     va_end(arg);
+    return;
   }
 
-#ifdef _USE_HW_RTOS
-  unLock();
+  if (is_open != true || is_enable != true)
+  {
+    va_end(arg);
+    return;
+  }
+
+  if (argc > LOG_DEFER_ARG_MAX)
+  {
+    argc = LOG_DEFER_ARG_MAX;
+  }
+
+  // ISR 에서도 호출되므로 slot 하나를 잡고 채우는 동안만 인터럽트를 막는다.
+  primask = __get_PRIMASK();
+  __disable_irq();
+
+  if (qbufferReserve(&defer_q, (uint8_t **)&p_rec, 1) > 0)
+  {
+    p_rec->fmt  = fmt;
+    p_rec->time = cycles();
+    p_rec->seq  = defer_seq;
+    p_rec->argc = argc;
+    for (uint32_t i=0; i<argc; i++)
+    {
+      p_rec->arg[i] = va_arg(arg, uint32_t);
+    }
+    qbufferCommit(&defer_q, 1);
+  }
+  else
+  {
+    defer_q.stat.drop_bytes += sizeof(log_rec_t);
+    defer_drop++;
+  }
+  defer_seq++;
+
+  __set_PRIMASK(primask);
+
+  va_end(arg);
+
+#ifdef _USE_HW_WPAN
+  if (defer_task_req != true)
+  {
+    defer_task_req = true;
+    UTIL_SEQ_SetTask(1<<CFG_TASK_LOG_ID, CFG_SCH_PRIO_1);
+  }
 #endif
 }
 
+static uint32_t logDeferFrame(log_rec_t *p_rec, uint8_t *p_buf)
+{
+  uint32_t idx = 0;
+  uint8_t  sum = 0;
+
+
+  // [0xA5 0x5A len] [fmt:4 time:4 seq:2 argc:1 arg:4*argc] [sum]
+  p_buf[idx++] = LOG_FRAME_SYNC1;
+  p_buf[idx++] = LOG_FRAME_SYNC2;
+  p_buf[idx++] = 11 + p_rec->argc * 4;
+
+  memcpy(&p_buf[idx], &p_rec->fmt, 4);  idx += 4;
+  memcpy(&p_buf[idx], &p_rec->time, 4); idx += 4;
+  memcpy(&p_buf[idx], &p_rec->seq, 2);  idx += 2;
+  p_buf[idx++] = p_rec->argc;
+  memcpy(&p_buf[idx], p_rec->arg, p_rec->argc * 4);
+  idx += p_rec->argc * 4;
 
-#endif
\ No newline at end of file
+  for (uint32_t i=3; i<idx; i++)
+  {
+    sum += p_buf[i];
+  }
+  p_buf[idx++] = sum;
+
+  return idx;
+}
+
+bool logDeferProcess(uint32_t max_cnt)
+{
+  log_rec_t *p_rec;
+  uint8_t    frame[3 + sizeof(log_rec_t) + 1];
+  uint32_t   frame_len;
+  uint32_t   cnt = 0;
+
+
+  while(cnt < max_cnt && qbufferPeek(&defer_q, (uint8_t **)&p_rec, 1) > 0)
+  {
+    frame_len = logDeferFrame(p_rec, frame);
+    qbufferConsume(&defer_q, 1);
+
+    uartWrite(log_ch, frame, frame_len);
+    cnt++;
+  }
+
+  return qbufferAvailable(&defer_q) > 0 ? true:false;
+}
+
+#ifdef _USE_HW_WPAN
+void logDeferTask(void)
+{
+  defer_task_req = false;
+
+  if (logDeferProcess(LOG_DEFER_TASK_REC_MAX) == true)
+  {
+    defer_task_req = true;
+    UTIL_SEQ_SetTask(1<<CFG_TASK_LOG_ID, CFG_SCH_PRIO_1);
+  }
+}
+#endif
+
+
+#if CLI_USE(HW_LOG)
+void cliLog(cli_args_t *args)
+{
+  bool ret = false;
+
+
+  if (args->argc == 1 && args->isStr(0, "info"))
+  {
+    cliPrintf("log ch      : _DEF_UART%d\n", log_ch + 1);
+    cliPrintf("boot mode   : %s\n", is_boot ? "on":"off");
+    cliPrintf("boot count  : %d\n", log_ram.boot_cnt);
+    cliPrintf("ram buf     : %d/%d\n", constrain(log_ram.in, 0, LOG_LIST_BUF_MAX), LOG_LIST_BUF_MAX);
+    cliPrintf("ram total   : %d\n", log_ram.in);
+    cliPrintf("defer mode  : %s\n", is_defer ? "on":"off");
+    cliPrintf("defer used  : %d/%d\n", qbufferAvailable(&defer_q), LOG_DEFER_REC_MAX - 1);
+    cliPrintf("defer peak  : %d\n", defer_q.stat.peak);
+    cliPrintf("defer drop  : %d\n", defer_drop);
+    ret = true;
+  }
+
+  if (args->argc == 1 && (args->isStr(0, "boot") || args->isStr(0, "list")))
+  {
+    uint8_t  buf[64];
+    uint32_t offset = 0;
+    uint32_t len;
+    bool     is_all = args->isStr(0, "list");
+
+    while((len = logReadBuf(is_all, offset, buf, sizeof(buf))) > 0)
+    {
+      cliWrite(buf, len);
+      offset += len;
+    }
+    ret = true;
+  }
+
+  if (args->argc == 1 && args->isStr(0, "level"))
+  {
+    const uint8_t build_level[LOG_MOD_MAX] =
+    {
+      HW_LOG_LEVEL_SYS, HW_LOG_LEVEL_FS, HW_LOG_LEVEL_QSPI,
+      HW_LOG_LEVEL_EEPROM, HW_LOG_LEVEL_FLASH, HW_LOG_LEVEL_NVS,
+      HW_LOG_LEVEL_BUTTON, HW_LOG_LEVEL_USB, HW_LOG_LEVEL_BLE,
+    };
+
+    cliPrintf("module   level   build\n");
+    for (int i=0; i<LOG_MOD_MAX; i++)
+    {
+      cliPrintf("%-8s %-7s %s\n",
+                log_mod_name[i],
+                log_level_name[log_level[i]],
+                log_level_name[build_level[i]]);
+    }
+    ret = true;
+  }
+
+  if (args->argc == 3 && args->isStr(0, "level"))
+  {
+    int mod;
+    int level;
+
+    for (mod=0; mod<LOG_MOD_MAX; mod++)
+    {
+      if (args->isStr(1, log_mod_name[mod]) || args->isStr(1, "all"))
+        break;
+    }
+    for (level=0; level<=LOG_LEVEL_TRACE; level++)
+    {
+      if (args->isStr(2, log_level_name[level]))
+        break;
+    }
+
+    if (mod < LOG_MOD_MAX && level <= LOG_LEVEL_TRACE)
+    {
+      if (args->isStr(1, "all"))
+      {
+        for (mod=0; mod<LOG_MOD_MAX; mod++)
+          logSetLevel(mod, level);
+      }
+      else
+      {
+        logSetLevel(mod, level);
+      }
+    }
+    else
+    {
+      cliPrintf("invalid module or level\n");
+    }
+    ret = true;
+  }
+
+  if (args->argc == 2 && args->isStr(0, "defer"))
+  {
+    bool enable;
+
+    enable = args->isStr(1, "on");
+    if (logSetDefer(enable) != true)
+    {
+      cliPrintf("defer mode not supported\n");
+    }
+    ret = true;
+  }
+
+  if (args->argc == 1 && args->isStr(0, "bench"))
+  {
+    uint32_t pre_cycles;
+    uint32_t exe_cycles;
+    bool     pre_defer = is_defer;
+    const uint32_t cnt = 32;
+
+    if (logSetDefer(true) == true)
+    {
+      pre_cycles = cycles();
+      for (uint32_t i=0; i<cnt; i++)
+      {
+        logDefer("bench %d 0x%X %d\n", i, pre_cycles, i * 3);
+      }
+      exe_cycles = cycles() - pre_cycles;
+      cliPrintf("defer  : %d cycles/call\n", exe_cycles / cnt);
+    }
+    logSetDefer(false);
+
+    uartFlushTx(log_ch);
+    pre_cycles = cycles();
+    for (uint32_t i=0; i<cnt; i++)
+    {
+      logPrintf("bench %d 0x%X %d\n", i, pre_cycles, i * 3);
+    }
+    exe_cycles = cycles() - pre_cycles;
+    cliPrintf("\ntext   : %d cycles/call\n", exe_cycles / cnt);
+
+    logSetDefer(pre_defer);
+    ret = true;
+  }
+
+  if (ret == false)
+  {
+    cliPrintf("log info\n");
+    cliPrintf("log boot\n");
+    cliPrintf("log list\n");
+    cliPrintf("log level [all|sys|fs|qspi|eeprom|flash|nvs|button|usb|ble] [none~trace]\n");
+    cliPrintf("log defer on:off\n");
+    cliPrintf("log bench\n");
+  }
+}
+#endif
+
+#endif
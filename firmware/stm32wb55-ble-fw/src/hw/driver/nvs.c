@@ -3,6 +3,7 @@
 
 #ifdef _USE_HW_NVS
 #include "fs.h"
+#include "log.h"
 
 static bool is_init = false;
 static fs_t nvs_fs;
@@ -21,7 +22,7 @@ bool nvsInit(void)
 
   ret = is_init;
 
-  logPrintf("[%s] nvsInit()\n", ret ? "OK" : "NG");
+  logI(NVS, "[%s] nvsInit()\n", ret ? "OK" : "NG");
 
   return ret;
 }
@@ -0,0 +1,441 @@
+#include "prof.h"
+
+
+
+#ifdef _USE_HW_PROF
+#include "qbuffer.h"
+#include "print.h"
+#include "cli.h"
+#include "cli_gui.h"
+#ifdef _USE_HW_WPAN
+#include "app_conf.h"
+#endif
+
+
+#define PROF_TOP_MS_DEF       1000
+
+
+#if CLI_USE(HW_PROF)
+static void cliProfInfo(cli_args_t *args);
+static void cliProfClear(cli_args_t *args);
+static void cliProfBench(cli_args_t *args);
+static void cliTop(cli_args_t *args);
+
+static const cli_item_t cli_sub_tbl[] =
+{
+  CLI_ITEM("info",  cliProfInfo,  0, 0, ""),
+  CLI_ITEM("clear", cliProfClear, 0, 0, ""),
+  CLI_ITEM("bench", cliProfBench, 0, 0, ""),
+};
+
+static const cli_item_t cli_item     = CLI_GROUP("prof", cli_sub_tbl, "");
+static const cli_item_t cli_item_top = CLI_ITEM("top", cliTop, 0, 1, "[ms]");
+#endif
+
+
+volatile uint32_t prof_isr_cycles  = 0;     // 모든 ISR 의 자기 시간 합
+volatile uint32_t prof_task_cycles = 0;     // 모든 task 의 자기 시간 합
+
+static prof_cnt_t task_cnt[PROF_TASK_MAX];
+static prof_cnt_t isr_cnt[PROF_ISR_MAX];
+
+static const char *task_name[PROF_TASK_MAX] =
+{
+#ifdef _USE_HW_WPAN
+  [CFG_TASK_ADV_UPDATE_ID]            = "ADV_UPDATE",
+  [CFG_TASK_MEAS_REQ_ID]              = "MEAS_REQ",
+  [CFG_TASK_HCI_ASYNCH_EVT_ID]        = "HCI_ASYNCH_EVT",
+  [CFG_TASK_SYSTEM_HCI_ASYNCH_EVT_ID] = "SHCI_ASYNCH_EVT",
+  [CFG_TASK_LOG_ID]                   = "LOG",
+#endif
+  [PROF_TASK_CLI]                     = "cli",
+};
+
+static const char *isr_name[PROF_ISR_MAX] =
+{
+  [PROF_ISR_USB]   = "USB_LP",
+  [PROF_ISR_IPCC]  = "IPCC_C1",
+  [PROF_ISR_TIM17] = "TIM17",
+  [PROF_ISR_QSPI]  = "QUADSPI",
+};
+
+
+
+
+bool profInit(void)
+{
+  profClear();
+
+#if CLI_USE(HW_PROF)
+  cliAddItem(&cli_item);
+  cliAddItem(&cli_item_top);
+#endif
+  return true;
+}
+
+static void profAdd(prof_cnt_t *p_cnt, uint32_t exe)
+{
+  p_cnt->count++;
+  p_cnt->cycles += exe;
+  if (exe > p_cnt->max_cycles)
+  {
+    p_cnt->max_cycles = exe;
+  }
+}
+
+// 끝 시각과 누적값을 같은 시점에 읽도록 잠깐 인터럽트를 막는다.
+static void profTaskEndCnt(prof_cnt_t *p_cnt, prof_mark_t *p_mark)
+{
+  uint32_t primask_bit;
+  uint32_t exe;
+  uint32_t nested;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  exe    = DWT->CYCCNT - p_mark->start;
+  nested = (prof_isr_cycles - p_mark->isr) + (prof_task_cycles - p_mark->task);
+  exe    = exe > nested ? exe - nested : 0;
+
+  prof_task_cycles += exe;
+  if (p_cnt != NULL)
+  {
+    profAdd(p_cnt, exe);
+  }
+
+  __set_PRIMASK(primask_bit);
+}
+
+static void profIsrEndCnt(prof_cnt_t *p_cnt, prof_mark_t *p_mark)
+{
+  uint32_t primask_bit;
+  uint32_t exe;
+  uint32_t nested;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+
+  exe    = DWT->CYCCNT - p_mark->start;
+  nested = prof_isr_cycles - p_mark->isr;
+  exe    = exe > nested ? exe - nested : 0;
+
+  prof_isr_cycles += exe;
+  if (p_cnt != NULL)
+  {
+    profAdd(p_cnt, exe);
+  }
+
+  __set_PRIMASK(primask_bit);
+}
+
+void profTaskEnd(uint32_t id, prof_mark_t *p_mark)
+{
+  profTaskEndCnt(id < PROF_TASK_MAX ? &task_cnt[id] : NULL, p_mark);
+}
+
+void profIsrEnd(uint32_t id, prof_mark_t *p_mark)
+{
+  profIsrEndCnt(id < PROF_ISR_MAX ? &isr_cnt[id] : NULL, p_mark);
+}
+
+void profClear(void)
+{
+  uint32_t primask_bit;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  memset(task_cnt, 0, sizeof(task_cnt));
+  memset(isr_cnt, 0, sizeof(isr_cnt));
+  __set_PRIMASK(primask_bit);
+}
+
+bool profGetTask(uint32_t id, prof_cnt_t *p_cnt)
+{
+  uint32_t primask_bit;
+
+  if (id >= PROF_TASK_MAX) return false;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  *p_cnt = task_cnt[id];
+  __set_PRIMASK(primask_bit);
+
+  return true;
+}
+
+bool profGetIsr(uint32_t id, prof_cnt_t *p_cnt)
+{
+  uint32_t primask_bit;
+
+  if (id >= PROF_ISR_MAX) return false;
+
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  *p_cnt = isr_cnt[id];
+  __set_PRIMASK(primask_bit);
+
+  return true;
+}
+
+
+
+#if CLI_USE(HW_PROF)
+typedef struct
+{
+  uint32_t    pre_cycles;
+  prof_cnt_t  pre_task[PROF_TASK_MAX];
+  prof_cnt_t  pre_isr[PROF_ISR_MAX];
+} prof_top_t;
+
+static prof_top_t prof_top;
+
+
+static uint32_t profCyclesToUs(uint32_t cycles)
+{
+  return cycles / (SystemCoreClock / 1000000);
+}
+
+static void profSnapshot(void)
+{
+  for (uint32_t i=0; i<PROF_TASK_MAX; i++)
+  {
+    profGetTask(i, &prof_top.pre_task[i]);
+  }
+  for (uint32_t i=0; i<PROF_ISR_MAX; i++)
+  {
+    profGetIsr(i, &prof_top.pre_isr[i]);
+  }
+  prof_top.pre_cycles = DWT->CYCCNT;
+}
+
+// 직전 화면 이후의 차이로 한 줄을 그리고 사용한 cycle 을 돌려준다.
+static uint32_t profTopLine(uint8_t y, const char *p_name, prof_cnt_t *p_cur, prof_cnt_t *p_pre, uint32_t window, uint32_t ms)
+{
+  cli_gui_api_t *p_gui = cliGui();
+  uint32_t d_cnt;
+  uint32_t d_cyc;
+  uint32_t cpu;
+
+  d_cnt = p_cur->count - p_pre->count;
+  d_cyc = p_cur->cycles - p_pre->cycles;
+  cpu   = (uint32_t)((uint64_t)d_cyc * 1000 / window);
+
+  p_gui->movePrintf(2, y, "%-15s %6d %3d.%d %6d %6d",
+                    p_name,
+                    d_cnt * 1000 / ms,
+                    cpu / 10, cpu % 10,
+                    d_cnt > 0 ? profCyclesToUs(d_cyc / d_cnt) : 0,
+                    profCyclesToUs(p_cur->max_cycles));
+  return d_cyc;
+}
+
+static void profDrawTop(uint32_t ms)
+{
+  cli_gui_api_t *p_gui = cliGui();
+  prof_cnt_t cur;
+  uint32_t   window;
+  uint32_t   busy = 0;
+  uint32_t   idle;
+  uint8_t    y;
+  const uint8_t cpu_w = 46;
+  const uint8_t box_y = 3;
+  const uint8_t box_h = CLI_GUI_HEIGHT - 6;
+  const uint8_t end_y = box_y + box_h - 2;    // 마지막 내부 줄
+
+
+  window = DWT->CYCCNT - prof_top.pre_cycles;
+  if (window == 0) window = 1;
+
+  p_gui->showTopLine("top");
+  p_gui->setAttr(A_BOLD | F_WHITE | B_BLUE);
+  p_gui->movePrintf(CLI_GUI_WIDTH - 24, 1, "%4d ms, up %6d s", ms, millis() / 1000);
+  p_gui->setAttr(A_NORMAL);
+
+  p_gui->drawBox(0, box_y, cpu_w, box_h, "CPU1");
+  p_gui->movePrintf(2, box_y + 1, "%-15s %6s %5s %6s %6s", "name", "cnt/s", "cpu%", "avg us", "max us");
+
+  y = box_y + 2;
+  for (uint32_t i=0; i<PROF_TASK_MAX; i++)
+  {
+    profGetTask(i, &cur);
+    if (task_name[i] == NULL && cur.count == 0)
+    {
+      continue;
+    }
+    if (y < end_y)
+    {
+      char name[16];
+
+      if (task_name[i] == NULL)
+      {
+        printSnprintf(name, sizeof(name), "task %d", (int)i);
+      }
+      busy += profTopLine(y++, task_name[i] != NULL ? task_name[i] : name, &cur, &prof_top.pre_task[i], window, ms);
+    }
+  }
+  for (uint32_t i=0; i<PROF_ISR_MAX; i++)
+  {
+    profGetIsr(i, &cur);
+    if (y < end_y)
+    {
+      busy += profTopLine(y++, isr_name[i], &cur, &prof_top.pre_isr[i], window, ms);
+    }
+  }
+
+  // 재지 않는 ISR 과 superloop polling 은 idle 에 들어간다.
+  idle = window > busy ? window - busy : 0;
+  idle = (uint32_t)((uint64_t)idle * 1000 / window);
+  p_gui->setAttr(A_BOLD);
+  p_gui->movePrintf(2, end_y, "%-15s %6s %3d.%d", "idle", "", idle / 10, idle % 10);
+  p_gui->setAttr(A_NORMAL);
+
+  p_gui->drawBox(cpu_w, box_y, CLI_GUI_WIDTH - cpu_w, box_h, "qbuffer");
+  p_gui->movePrintf(cpu_w + 2, box_y + 1, "%-10s %4s %5s %4s %4s", "name", "used", "len", "use%", "peak");
+  y = box_y + 2;
+  for (uint32_t i=0; i<qbufferGetCount() && y <= end_y; i++)
+  {
+    qbuffer_t *p_q = qbufferGetNode(i);
+    uint32_t   used = qbufferAvailable(p_q);
+
+    if (used * 4 >= p_q->len * 3) p_gui->setAttr(F_RED);
+    p_gui->movePrintf(cpu_w + 2, y++, "%-10s %4d %5d %3d%% %3d%%",
+                      p_q->p_name != NULL ? p_q->p_name : "-",
+                      used,
+                      p_q->len,
+                      used * 100 / p_q->len,
+                      p_q->stat.peak * 100 / p_q->len);
+    p_gui->setAttr(A_NORMAL);
+  }
+
+  p_gui->showBottomLine("Ctrl-C : exit");
+}
+
+static bool cliTopJob(cli_job_t *p_job)
+{
+  cli_gui_api_t *p_gui = cliGui();
+
+  if (p_job->is_cancel == true)
+  {
+    p_gui->closeScreen();
+    return false;
+  }
+
+  if (millis() - p_job->arg[1] >= p_job->arg[0])
+  {
+    p_job->arg[1] = millis();
+
+    p_gui->clear();
+    profDrawTop(p_job->arg[0]);
+    p_gui->flush(HW_CLI_GUI_FLUSH_MAX);
+    profSnapshot();
+  }
+
+  return true;
+}
+
+void cliTop(cli_args_t *args)
+{
+  static cli_job_t job;
+
+  if (cliJobIsIdle(&job, "top") != true)
+  {
+    return;
+  }
+  // 32bit cycle 누적값이 한 화면 사이에 wrap 되지 않도록 10초로 제한한다.
+  job.arg[0] = PROF_TOP_MS_DEF;
+  job.arg[1] = millis();
+  if (args->argc == 1)
+  {
+    job.arg[0] = constrain(args->getData(0), 100, 10000);
+  }
+
+  if (cliJobStart(&job, "top", cliTopJob) == true)
+  {
+    profSnapshot();
+    cliGui()->initScreen(CLI_GUI_WIDTH, CLI_GUI_HEIGHT);
+    cliGui()->setFrame(true);
+  }
+}
+
+void cliProfInfo(cli_args_t *args)
+{
+  prof_cnt_t cur;
+
+  cliPrintf("name             count       max us\n");
+  for (uint32_t i=0; i<PROF_TASK_MAX; i++)
+  {
+    profGetTask(i, &cur);
+    if (task_name[i] == NULL && cur.count == 0)
+    {
+      continue;
+    }
+    cliPrintf("%-15s  %-10u  %d\n",
+              task_name[i] != NULL ? task_name[i] : "-",
+              (unsigned)cur.count,
+              profCyclesToUs(cur.max_cycles));
+  }
+  for (uint32_t i=0; i<PROF_ISR_MAX; i++)
+  {
+    profGetIsr(i, &cur);
+    cliPrintf("%-15s  %-10u  %d\n", isr_name[i], (unsigned)cur.count, profCyclesToUs(cur.max_cycles));
+  }
+}
+
+void cliProfClear(cli_args_t *args)
+{
+  profClear();
+  cliPrintf("prof clear\n");
+}
+
+// 측정 자체에 드는 비용 (begin + end 한 쌍)
+// 샘플은 bench 전용 slot 에 쌓고, 전역 합에 더해진 만큼은 끝나고 다시 뺀다.
+void cliProfBench(cli_args_t *args)
+{
+  const uint32_t count = 1000;
+  prof_cnt_t  bench_task = {0};
+  prof_cnt_t  bench_isr  = {0};
+  prof_mark_t mark;
+  uint32_t    primask_bit;
+  uint32_t    pre_cycles;
+  uint32_t    task_cycles;
+  uint32_t    isr_cycles;
+
+
+  pre_cycles = DWT->CYCCNT;
+  for (volatile uint32_t i=0; i<count; i++)
+  {
+    profMarkBegin(&mark);
+    profTaskEndCnt(&bench_task, &mark);
+  }
+  task_cycles = DWT->CYCCNT - pre_cycles;
+
+  pre_cycles = DWT->CYCCNT;
+  for (volatile uint32_t i=0; i<count; i++)
+  {
+    profMarkBegin(&mark);
+    profIsrEndCnt(&bench_isr, &mark);
+  }
+  isr_cycles = DWT->CYCCNT - pre_cycles;
+
+  // 바깥 cli task 가 bench 시간을 중첩 구간으로 빼지 않도록 되돌린다.
+  primask_bit = __get_PRIMASK();
+  __disable_irq();
+  prof_task_cycles -= bench_task.cycles;
+  prof_isr_cycles  -= bench_isr.cycles;
+  __set_PRIMASK(primask_bit);
+
+  pre_cycles = DWT->CYCCNT;
+  for (volatile uint32_t i=0; i<count; i++)
+  {
+  }
+  pre_cycles = DWT->CYCCNT - pre_cycles;
+
+  task_cycles = (task_cycles - pre_cycles) / count;
+  isr_cycles  = (isr_cycles  - pre_cycles) / count;
+
+  cliPrintf("task begin/end : %d cycles, %d ns\n", task_cycles, task_cycles * 1000 / (SystemCoreClock / 1000000));
+  cliPrintf("isr  begin/end : %d cycles, %d ns\n", isr_cycles, isr_cycles * 1000 / (SystemCoreClock / 1000000));
+}
+#endif
+
+#endif
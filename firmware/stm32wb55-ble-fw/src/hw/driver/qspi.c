@@ -3,7 +3,10 @@
 
 #ifdef _USE_HW_QSPI
 #include "qspi/w25q128fv.h"
+#include "log.h"
 #include "cli.h"
+#include "cli_bin.h"
+#include "prof.h"
 
 
 /* QSPI Error codes */
@@ -18,6 +21,77 @@
 /* QSPI Base Address */
 #define QSPI_BASE_ADDRESS          HW_QSPI_FLASH_ADDR
 
+// 이보다 짧은 read 는 DMA 설정 비용이 더 크므로 polling 으로 읽는다.
+#define QSPI_DMA_MIN_LENGTH        32
+#define QSPI_DMA_MAX_LENGTH        0x8000      // DMA CNDTR 는 16bit
+
+// resume 후 이 시간 안에는 다시 suspend 하지 않는다.
+// read 가 계속 들어와도 erase 가 조금씩은 진행되도록 한다. (datasheet 는 tSUS 이상)
+#define QSPI_RESUME_GAP_US         100
+
+
+typedef enum
+{
+  QSPI_OP_NONE,
+  QSPI_OP_READ,
+  QSPI_OP_WRITE,
+  QSPI_OP_ERASE,
+} qspi_op_type_t;
+
+typedef enum
+{
+  QSPI_PHASE_XFER,        // 명령/DMA 전송 중
+  QSPI_PHASE_WAIT,        // flash 안에서 program/erase 중, WIP auto polling
+} qspi_op_phase_t;
+
+typedef struct
+{
+  volatile bool is_busy;
+  volatile bool is_cancel;
+  volatile bool ret;
+  uint8_t       type;
+  volatile uint8_t phase;
+
+  uint32_t  addr;
+  uint8_t  *p_data;
+  uint32_t  length;
+  uint32_t  done;
+  uint32_t  cur_len;
+  uint32_t  erase_max;    // 이 크기보다 큰 erase 명령은 쓰지 않는다.
+
+  void    (*p_func)(void *p_arg, bool ret);
+  void     *p_arg;
+} qspi_op_t;
+
+typedef struct
+{
+  uint8_t  cmd;
+  uint32_t size;
+  uint32_t typ_ms;
+  uint32_t max_ms;
+} qspi_erase_t;
+
+typedef struct
+{
+  uint32_t suspend_cnt;
+  uint32_t wait_cnt;        // 범위가 겹쳐서 끝날 때까지 기다린 read
+  uint32_t lat_max_us;      // suspend 해서 읽은 read 의 최대 지연
+  uint32_t resume_cycles;
+} qspi_sus_t;
+
+typedef struct
+{
+  volatile bool is_enable;  // qspiSetXipMode() 로 요청한 상태, program/erase 가 끝나면 다시 들어간다.
+  uint32_t exit_cnt;
+  uint32_t exit_us_max;
+  uint32_t exit_us_sum;
+  uint32_t enter_cnt;
+  uint32_t enter_us_max;
+  uint32_t enter_us_sum;
+} qspi_xip_t;
+
+#define QSPI_ERASE_TBL_MAX   (sizeof(erase_tbl)/sizeof(erase_tbl[0]))
+
 
 /* QSPI Info */
 typedef struct {
@@ -46,13 +120,73 @@ uint8_t BSP_QSPI_Config(void);
 uint8_t BSP_QSPI_Reset(void);
 uint8_t BSP_QSPI_Abort(void);
 
+static uint8_t QSPI_ReadStart(qspi_op_t *p_op);
+static uint8_t QSPI_WriteStart(qspi_op_t *p_op);
+static uint8_t QSPI_EraseStart(qspi_op_t *p_op);
+static void    QSPI_OpDone(qspi_op_t *p_op, bool ret);
+static void    qspiOpAbort(void);
+static bool    qspiXipExit(void);
+static void    qspiXipRestore(void);
+static uint8_t QSPI_SendCmd(QSPI_HandleTypeDef *hqspi, uint8_t cmd);
+static uint8_t QSPI_ResetMemory          (QSPI_HandleTypeDef *hqspi);
+static uint8_t QSPI_WriteEnable          (QSPI_HandleTypeDef *hqspi);
+static uint8_t QSPI_AutoPollingMemReady(QSPI_HandleTypeDef *hqspi, uint32_t Timeout);
+static uint8_t QSPI_AutoPollingMemReadyIT(QSPI_HandleTypeDef *hqspi);
+static uint8_t QSPI_ReadStatus(QSPI_HandleTypeDef *hqspi, uint8_t cmd, uint8_t *p_data);
+static uint8_t QSPI_WriteStatus(QSPI_HandleTypeDef *hqspi, uint8_t cmd, uint8_t data);
+static void    qspiErasePlanTime(uint32_t addr, uint32_t length, uint32_t erase_max,
+                                 uint32_t *p_count, uint32_t *p_typ_ms, uint32_t *p_max_ms);
+
 #if CLI_USE(HW_QSPI)
-static void cliCmd(cli_args_t *args);
+static void cliQspiInfo(cli_args_t *args);
+static void cliQspiTest(cli_args_t *args);
+static void cliQspiXip(cli_args_t *args);
+static void cliQspiRead(cli_args_t *args);
+static void cliQspiErase(cli_args_t *args);
+static void cliQspiEraseBench(cli_args_t *args);
+static void cliQspiSuspendTest(cli_args_t *args);
+static void cliQspiWrite(cli_args_t *args);
+static void cliQspiSpeedTest(cli_args_t *args);
+static void cliQspiCheck(cli_args_t *args);
+
+static const cli_item_t cli_sub_tbl[] =
+{
+  CLI_ITEM("info",       cliQspiInfo,      0, 0, ""),
+  CLI_ITEM("xip",        cliQspiXip,       1, 1, "on:off"),
+  CLI_ITEM("test",       cliQspiTest,      0, 0, ""),
+  CLI_ITEM("speed-test", cliQspiSpeedTest, 0, 0, ""),
+  CLI_ITEM("check",      cliQspiCheck,     2, 2, "[addr] [length]"),
+  CLI_ITEM("read",       cliQspiRead,      2, 2, "[addr] [length]"),
+  CLI_ITEM("erase",      cliQspiErase,     2, 2, "[addr] [length]"),
+  CLI_ITEM("erase-bench",cliQspiEraseBench,2, 2, "[addr] [length]"),
+  CLI_ITEM("suspend-test",cliQspiSuspendTest,1,1, "[addr]"),
+  CLI_ITEM("write",      cliQspiWrite,     2, 2, "[addr] [data]"),
+};
+
+static const cli_item_t cli_item = CLI_GROUP("qspi", cli_sub_tbl, "");
+#endif
+#ifdef _USE_HW_CLI_BIN
+#define QSPI_BIN_CMD_READ     0x0100
+
+static cli_bin_status_t cliBinQspiRead(cli_bin_t *p_bin);
 #endif
 
 
+// W25Q128JV datasheet 기준, 큰 것부터
+static const qspi_erase_t erase_tbl[] =
+{
+  {BULK_ERASE_CMD,      W25Q128FV_FLASH_SIZE,     40000, W25Q128FV_BULK_ERASE_MAX_TIME     },
+  {SECTOR_ERASE_CMD,    W25Q128FV_SECTOR_SIZE,      150, W25Q128FV_SECTOR_ERASE_MAX_TIME   },
+  {BLOCK_32K_ERASE_CMD, W25Q128FV_BLOCK_32K_SIZE,   120, W25Q128FV_BLOCK_32K_ERASE_MAX_TIME},
+  {SUBSECTOR_ERASE_CMD, W25Q128FV_SUBSECTOR_SIZE,    45, W25Q128FV_SUBSECTOR_ERASE_MAX_TIME},
+};
+
 static bool is_init = false;
 static QSPI_HandleTypeDef hqspi;
+static DMA_HandleTypeDef  hdma_qspi;
+static qspi_op_t          qspi_op;
+static qspi_sus_t         qspi_sus;
+static qspi_xip_t         qspi_xip;
 
 
 
@@ -79,27 +213,30 @@ bool qspiInit(void)
   {
     if (info.device_id[0] == 0xEF && info.device_id[1] == 0x40 && info.device_id[2] == 0x18)
     {
-      logPrintf("[OK] qspiInit()\n");
-      logPrintf("     W25Q128JV Found\r\n");
+      logI(QSPI, "[OK] qspiInit()\n");
+      logI(QSPI, "     W25Q128JV Found\r\n");
       ret = true;
     }
     else
     {
-      logPrintf("[OK] qspiInit()\n");
-      logPrintf("     W25Q128JV Not Found %X %X %X\r\n", info.device_id[0], info.device_id[1], info.device_id[2]);
+      logI(QSPI, "[OK] qspiInit()\n");
+      logW(QSPI, "     W25Q128JV Not Found %X %X %X\r\n", info.device_id[0], info.device_id[1], info.device_id[2]);
       ret = false;
     }
   }
   else
   {
-    logPrintf("[NG] qspiInit()\n");
+    logE(QSPI, "[NG] qspiInit()\n");
     ret = false;
   }
 
   is_init = ret;
 
 #if CLI_USE(HW_QSPI)
-  cliAdd("qspi", cliCmd);
+  cliAddItem(&cli_item);
+#endif
+#ifdef _USE_HW_CLI_BIN
+  cliBinAdd(QSPI_BIN_CMD_READ, "qspi read", cliBinQspiRead);
 #endif
   return ret;
 }
@@ -139,62 +276,421 @@ bool qspiIsInit(void)
   return is_init;
 }
 
+static bool qspiWaitDone(uint32_t timeout)
+{
+  uint32_t pre_time;
+
+  pre_time = millis();
+  while(qspi_op.is_busy == true)
+  {
+    if (millis()-pre_time >= timeout)
+    {
+      qspi_op.ret = false;
+      qspiOpAbort();
+      logE(QSPI, "qspiWaitDone() timeout\n");
+      break;
+    }
+  }
+
+  return qspi_op.ret;
+}
+
+// 다른 곳에서 건 async 작업이 끝나기를 기다린다. 멈추지는 않는다.
+static bool qspiWaitIdle(void)
+{
+  uint32_t pre_time;
+  uint32_t timeout = 100;
+  uint32_t remain;
+  uint32_t count;
+  uint32_t typ_ms;
+  uint32_t max_ms = 0;
+
+  // 남은 길이로 qspiRead()/qspiWrite()/erase plan 과 같은 기준의 시간을 잡는다.
+  remain = qspi_op.length - qspi_op.done;
+  switch(qspi_op.type)
+  {
+    case QSPI_OP_ERASE:
+      qspiErasePlanTime(qspi_op.addr + qspi_op.done, remain, qspi_op.erase_max,
+                        &count, &typ_ms, &max_ms);
+      break;
+
+    case QSPI_OP_WRITE:
+      max_ms = (remain/W25Q128FV_PAGE_SIZE + 2) * 3;
+      break;
+
+    case QSPI_OP_READ:
+      max_ms = remain/1024;
+      break;
+
+    default:
+      break;
+  }
+  timeout += max_ms;
+
+  pre_time = millis();
+  while(qspi_op.is_busy == true)
+  {
+    if (millis()-pre_time >= timeout)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// XIP 로 들어가 있으면 0x90000000 창에서 복사하고 아니면 indirect 로 읽는다.
+static bool qspiReadDirect(uint32_t addr, uint8_t *p_data, uint32_t length)
+{
+  if (qspiGetXipMode() == true)
+  {
+    memcpy(p_data, (void *)(uintptr_t)(QSPI_BASE_ADDRESS + addr), length);
+    return true;
+  }
+
+  return BSP_QSPI_Read(p_data, addr, length) == QSPI_OK;
+}
+
+static bool qspiIsOverlap(uint32_t addr, uint32_t length)
+{
+  return (addr < qspi_op.addr + qspi_op.length) && (qspi_op.addr < addr + length);
+}
+
+// program/erase 가 flash 안에서 진행 중이면 suspend(0x75) 하고 읽은 다음 resume(0x7A) 한다.
+// 그 동안은 QSPI 인터럽트를 막아서 op 의 상태가 바뀌지 않도록 한다.
+static bool qspiReadSuspend(uint32_t addr, uint8_t *p_data, uint32_t length)
+{
+  bool     ret = false;
+  bool     is_suspend = false;
+  uint8_t  reg;
+  uint32_t pre_cycles;
+  uint32_t lat_us;
+
+
+  pre_cycles = cycles();
+  while((cycles() - qspi_sus.resume_cycles) / (SystemCoreClock / 1000000) < QSPI_RESUME_GAP_US)
+  {
+  }
+
+  while(1)
+  {
+    HAL_NVIC_DisableIRQ(QUADSPI_IRQn);
+    if (qspi_op.is_busy != true || qspi_op.phase == QSPI_PHASE_WAIT)
+    {
+      break;
+    }
+    // page 전송이 끝나기를 기다린다.
+    HAL_NVIC_EnableIRQ(QUADSPI_IRQn);
+  }
+
+  if (qspi_op.is_busy != true)
+  {
+    HAL_NVIC_EnableIRQ(QUADSPI_IRQn);
+    return qspiReadDirect(addr, p_data, length);
+  }
+
+  // 막기 직전에 match 된 것은 버리고 resume 후에 다시 건 polling 으로 받는다.
+  BSP_QSPI_Abort();
+  __HAL_QSPI_CLEAR_FLAG(&hqspi, QSPI_FLAG_SM);
+  HAL_NVIC_ClearPendingIRQ(QUADSPI_IRQn);
+
+  if (QSPI_SendCmd(&hqspi, PROG_ERASE_SUSPEND_CMD) == QSPI_OK)
+  {
+    if (QSPI_AutoPollingMemReady(&hqspi, 2) == QSPI_OK &&
+        QSPI_ReadStatus(&hqspi, READ_STATUS_REG2_CMD, &reg) == QSPI_OK)
+    {
+      // suspend 전에 이미 끝났으면 SUS 가 0 이다.
+      is_suspend = (reg & W25Q128FV_SR2_SUS) ? true:false;
+      ret = BSP_QSPI_Read(p_data, addr, length) == QSPI_OK;
+    }
+    else
+    {
+      // 상태를 모르면 resume 을 보낸다. suspend 가 아니면 flash 가 무시한다.
+      is_suspend = true;
+    }
+  }
+
+  if (is_suspend == true)
+  {
+    if (QSPI_SendCmd(&hqspi, PROG_ERASE_RESUME_CMD) != QSPI_OK)
+    {
+      ret = false;
+    }
+    qspi_sus.resume_cycles = cycles();
+    qspi_sus.suspend_cnt++;
+  }
+
+  // 끝났으면 바로 match 되어서 다음 단계로 넘어간다.
+  if (QSPI_AutoPollingMemReadyIT(&hqspi) != QSPI_OK)
+  {
+    QSPI_OpDone(&qspi_op, false);
+  }
+  HAL_NVIC_EnableIRQ(QUADSPI_IRQn);
+
+  lat_us = (cycles() - pre_cycles) / (SystemCoreClock / 1000000);
+  qspi_sus.lat_max_us = cmax(qspi_sus.lat_max_us, lat_us);
+
+  return ret;
+}
+
 bool qspiRead(uint32_t addr, uint8_t *p_data, uint32_t length)
 {
-  uint8_t ret;
+  if (addr >= qspiGetLength())
+  {
+    return false;
+  }
+
+  if (qspi_op.is_busy == true)
+  {
+    // 지우거나 쓰는 중인 범위를 읽으면 끝난 결과를 읽도록 기다린다.
+    if ((qspi_op.type == QSPI_OP_ERASE || qspi_op.type == QSPI_OP_WRITE) && qspiIsOverlap(addr, length) != true)
+    {
+      if (qspiReadSuspend(addr, p_data, length) == true)
+      {
+        return true;
+      }
+      // suspend 로 읽지 못했으면 끝나기를 기다렸다가 읽는다.
+    }
+    qspi_sus.wait_cnt++;
+    if (qspiWaitIdle() != true)
+    {
+      return false;
+    }
+  }
+
+  // program/erase 가 끝나면서 XIP 로 돌아갔을 수 있으므로 기다린 다음에 본다.
+  if (length >= QSPI_DMA_MIN_LENGTH && qspiGetXipMode() != true)
+  {
+    if (qspiReadAsync(addr, p_data, length, NULL, NULL) != true)
+    {
+      return false;
+    }
+    return qspiWaitDone(100 + length/1024);
+  }
+
+  return qspiReadDirect(addr, p_data, length);
+}
 
+bool qspiWrite(uint32_t addr, uint8_t *p_data, uint32_t length)
+{
   if (addr >= qspiGetLength())
+    return false;
+
+  if (qspiWaitIdle() != true)
+    return false;
+
+  if (qspiWriteAsync(addr, p_data, length, NULL, NULL) != true)
   {
     return false;
   }
 
-  if (qspiGetXipMode())
+  // page program 최대 3ms
+  return qspiWaitDone(100 + (length/W25Q128FV_PAGE_SIZE + 2) * 3);
+}
+
+static bool qspiOpBegin(uint8_t type, uint32_t addr, uint8_t *p_data, uint32_t length, void (*p_func)(void *p_arg, bool ret), void *p_arg)
+{
+  uint32_t primask;
+
+  if (is_init != true || length == 0 || addr + length > qspiGetLength())
   {
-    memcpy(p_data, (void *)addr, length);
-    return true;
+    return false;
   }
 
-  ret = BSP_QSPI_Read(p_data, addr, length);
+  primask = __get_PRIMASK();
+  __disable_irq();
+  if (qspi_op.is_busy == true)
+  {
+    __set_PRIMASK(primask);
+    return false;
+  }
+  qspi_op.is_busy = true;
+  __set_PRIMASK(primask);
 
-  if (ret == QSPI_OK)
+  if (qspiXipExit() != true)
+  {
+    qspi_op.is_busy = false;
+    return false;
+  }
+
+  qspi_op.ret       = false;
+  qspi_op.is_cancel = false;
+  qspi_op.phase     = QSPI_PHASE_XFER;
+  qspi_op.type      = type;
+  qspi_op.addr    = addr;
+  qspi_op.p_data  = p_data;
+  qspi_op.length  = length;
+  qspi_op.done    = 0;
+  qspi_op.p_func  = p_func;
+  qspi_op.p_arg   = p_arg;
+
+  return true;
+}
+
+// 끝나면 QSPI 인터럽트 안에서 p_func(p_arg, ret) 가 불린다.
+// XIP 로 들어가 있으면 바로 복사하고 부른 쪽에서 p_func 를 부른다.
+bool qspiReadAsync(uint32_t addr, uint8_t *p_data, uint32_t length, void (*p_func)(void *p_arg, bool ret), void *p_arg)
+{
+  if (qspiGetXipMode() == true && qspi_op.is_busy != true)
   {
+    if (length == 0 || addr + length > qspiGetLength())
+    {
+      return false;
+    }
+    memcpy(p_data, (void *)(uintptr_t)(QSPI_BASE_ADDRESS + addr), length);
+    qspi_op.ret = true;
+    if (p_func != NULL)
+    {
+      p_func(p_arg, true);
+    }
     return true;
   }
-  else
+  if (qspiOpBegin(QSPI_OP_READ, addr, p_data, length, p_func, p_arg) != true)
+  {
+    return false;
+  }
+
+  if (QSPI_ReadStart(&qspi_op) != QSPI_OK)
   {
+    qspiOpAbort();
     return false;
   }
+
+  return true;
 }
 
-bool qspiWrite(uint32_t addr, uint8_t *p_data, uint32_t length)
+bool qspiWriteAsync(uint32_t addr, uint8_t *p_data, uint32_t length, void (*p_func)(void *p_arg, bool ret), void *p_arg)
 {
-  uint8_t ret;
+  if (qspiOpBegin(QSPI_OP_WRITE, addr, p_data, length, p_func, p_arg) != true)
+  {
+    return false;
+  }
 
-  if (addr >= qspiGetLength())
+  if (QSPI_WriteStart(&qspi_op) != QSPI_OK)
+  {
+    qspiOpAbort();
     return false;
-  if (qspiGetXipMode() == true)
+  }
+
+  return true;
+}
+
+// addr 에서 remain 을 지울 때 다음에 쓸 명령을 고른다.
+// 정렬이 맞고 범위 안에 들어가는 것 중에 가장 큰 것을 쓰는데,
+// 작은 명령 여러 번으로 지우는 것보다 시간 모델상 느리면 (chip erase) 건너뛴다.
+static const qspi_erase_t *qspiErasePlan(uint32_t addr, uint32_t remain, uint32_t erase_max)
+{
+  uint32_t i;
+
+  for (i=0; i<QSPI_ERASE_TBL_MAX-1; i++)
+  {
+    const qspi_erase_t *p_cur  = &erase_tbl[i];
+    const qspi_erase_t *p_next = &erase_tbl[i+1];
+
+    if (p_cur->size > erase_max || (addr % p_cur->size) != 0 || remain < p_cur->size)
+    {
+      continue;
+    }
+    if (p_cur->typ_ms < (p_cur->size / p_next->size) * p_next->typ_ms)
+    {
+      return p_cur;
+    }
+  }
+
+  return &erase_tbl[QSPI_ERASE_TBL_MAX-1];
+}
+
+static void qspiErasePlanTime(uint32_t addr, uint32_t length, uint32_t erase_max,
+                              uint32_t *p_count, uint32_t *p_typ_ms, uint32_t *p_max_ms)
+{
+  const qspi_erase_t *p_erase;
+  uint32_t done = 0;
+
+  *p_count  = 0;
+  *p_typ_ms = 0;
+  *p_max_ms = 0;
+
+  while(done < length)
+  {
+    p_erase = qspiErasePlan(addr + done, length - done, erase_max);
+    done += p_erase->size;
+
+    *p_count  += 1;
+    *p_typ_ms += p_erase->typ_ms;
+    *p_max_ms += p_erase->max_ms;
+  }
+}
+
+// 4KB 단위로 넓혀서 지운다. 한 번 지울 때마다 status match 인터럽트로 다음 것을 건다.
+static bool qspiEraseRangeAsync(uint32_t addr, uint32_t length, uint32_t erase_max, void (*p_func)(void *p_arg, bool ret), void *p_arg)
+{
+  uint32_t begin;
+  uint32_t end;
+
+  if (length == 0)
+  {
     return false;
+  }
 
-  ret = BSP_QSPI_Write(p_data, addr, length);
+  begin = addr / W25Q128FV_SUBSECTOR_SIZE;
+  end   = (addr + length - 1) / W25Q128FV_SUBSECTOR_SIZE;
 
-  if (ret == QSPI_OK)
+  if (qspiOpBegin(QSPI_OP_ERASE,
+                  begin * W25Q128FV_SUBSECTOR_SIZE,
+                  NULL,
+                  (end - begin + 1) * W25Q128FV_SUBSECTOR_SIZE,
+                  p_func, p_arg) != true)
   {
-    return true;
+    return false;
   }
-  else
+  qspi_op.erase_max = erase_max;
+
+  if (QSPI_EraseStart(&qspi_op) != QSPI_OK)
   {
+    qspiOpAbort();
     return false;
   }
+
+  return true;
+}
+
+bool qspiEraseAsync(uint32_t addr, uint32_t length, void (*p_func)(void *p_arg, bool ret), void *p_arg)
+{
+  return qspiEraseRangeAsync(addr, length, W25Q128FV_FLASH_SIZE, p_func, p_arg);
+}
+
+bool qspiIsBusy(void)
+{
+  return qspi_op.is_busy;
+}
+
+bool qspiGetProgress(uint32_t *p_done, uint32_t *p_length)
+{
+  *p_done   = qspi_op.done;
+  *p_length = qspi_op.length;
+
+  return qspi_op.is_busy;
+}
+
+// 진행 중인 명령은 끝까지 가고 그 다음 것부터 멈춘다.
+bool qspiCancel(void)
+{
+  qspi_op.is_cancel = true;
+  return qspi_op.is_busy;
 }
 
 bool qspiEraseBlock(uint32_t block_addr)
 {
   uint8_t ret;
 
-  if (qspiGetXipMode() == true)
+  if (qspiWaitIdle() != true)
+    return false;
+
+  if (qspiXipExit() != true)
     return false;
 
   ret = BSP_QSPI_Erase_Block(block_addr);
+  qspiXipRestore();
 
   if (ret == QSPI_OK)
   {
@@ -211,10 +707,14 @@ bool qspiEraseSector(uint32_t sector_addr)
   uint8_t ret;
 
 
-  if (qspiGetXipMode() == true)
+  if (qspiWaitIdle() != true)
+    return false;
+
+  if (qspiXipExit() != true)
     return false;
 
   ret = BSP_QSPI_Erase_Sector(sector_addr);
+  qspiXipRestore();
   if (ret == QSPI_OK)
   {
     return true;
@@ -227,20 +727,13 @@ bool qspiEraseSector(uint32_t sector_addr)
 
 bool qspiErase(uint32_t addr, uint32_t length)
 {
-  bool ret = false;
   uint32_t flash_length;
-  uint32_t block_size;
-  uint32_t block_begin;
-  uint32_t block_end;
-  uint32_t i;
+  uint32_t count;
+  uint32_t typ_ms;
+  uint32_t max_ms;
 
 
-  if (qspiGetXipMode() == true)
-    return false;
-
   flash_length = W25Q128FV_FLASH_SIZE;
-  block_size   = W25Q128FV_SECTOR_SIZE;
-
 
   if ((addr > flash_length) || ((addr+length) > flash_length))
   {
@@ -251,31 +744,33 @@ bool qspiErase(uint32_t addr, uint32_t length)
     return false;
   }
 
+  if (qspiWaitIdle() != true)
+  {
+    return false;
+  }
 
-  block_begin = addr / block_size;
-  block_end   = (addr + length - 1) / block_size;
-
-
-  for (i=block_begin; i<=block_end; i++)
+  if (qspiEraseAsync(addr, length, NULL, NULL) != true)
   {
-    ret = qspiEraseSector(block_size*i);
-    if (ret == false)
-    {
-      break;
-    }
+    return false;
   }
 
-  return ret;
+  qspiErasePlanTime(qspi_op.addr, qspi_op.length, W25Q128FV_FLASH_SIZE, &count, &typ_ms, &max_ms);
+
+  return qspiWaitDone(max_ms);
 }
 
 bool qspiEraseChip(void)
 {
   uint8_t ret;
 
-  if (qspiGetXipMode() == true)
+  if (qspiWaitIdle() != true)
+    return false;
+
+  if (qspiXipExit() != true)
     return false;
 
   ret = BSP_QSPI_Erase_Chip();
+  qspiXipRestore();
 
   if (ret == QSPI_OK)
   {
@@ -335,43 +830,86 @@ bool qspiEnableMemoryMappedMode(void)
   }
 }
 
+// program/erase 중이면 끝난 다음에 XIP 로 들어간다.
 bool qspiSetXipMode(bool enable)
 {
-  uint8_t ret = true;
+  bool ret;
+
+  qspi_xip.is_enable = enable;
 
   if (enable)
   {
-    if (qspiGetXipMode() == false)
-    {
-      ret = qspiEnableMemoryMappedMode();
-    }
+    qspiXipRestore();
+    ret = qspiGetXipMode() || qspi_op.is_busy;
   }
   else
   {
-    if (qspiGetXipMode() == true)
-    {
-      ret = qspiReset();
-    }
+    ret = qspiXipExit();
   }
 
   return ret;
 }
 
-bool qspiGetXipMode(void)
+// memory mapped 를 끝내고 continuous read mode 도 풀어야 하므로 flash reset 까지 한다.
+static bool qspiXipExit(void)
 {
-  bool ret = false;
+  bool     ret;
+  uint32_t pre_cycles;
+  uint32_t exe_us;
 
-  if (HAL_QSPI_GetState(&hqspi) == HAL_QSPI_STATE_BUSY_MEM_MAPPED)
+  if (qspiGetXipMode() != true)
   {
-    ret = true;
+    return true;
   }
 
+  pre_cycles = cycles();
+  ret = BSP_QSPI_Reset() == QSPI_OK;
+  exe_us = (cycles() - pre_cycles) / (SystemCoreClock / 1000000);
+
+  qspi_xip.exit_cnt++;
+  qspi_xip.exit_us_sum += exe_us;
+  qspi_xip.exit_us_max  = cmax(qspi_xip.exit_us_max, exe_us);
+
   return ret;
 }
 
-uint32_t qspiGetAddr(void)
+// QSPI 인터럽트 안에서도 불린다.
+static void qspiXipRestore(void)
 {
-  return QSPI_BASE_ADDRESS;
+  uint32_t pre_cycles;
+  uint32_t exe_us;
+
+  if (qspi_xip.is_enable != true || qspi_op.is_busy == true || qspiGetXipMode() == true)
+  {
+    return;
+  }
+
+  pre_cycles = cycles();
+  if (BSP_QSPI_EnableMemoryMappedMode() == QSPI_OK)
+  {
+    exe_us = (cycles() - pre_cycles) / (SystemCoreClock / 1000000);
+
+    qspi_xip.enter_cnt++;
+    qspi_xip.enter_us_sum += exe_us;
+    qspi_xip.enter_us_max  = cmax(qspi_xip.enter_us_max, exe_us);
+  }
+}
+
+bool qspiGetXipMode(void)
+{
+  bool ret = false;
+
+  if (HAL_QSPI_GetState(&hqspi) == HAL_QSPI_STATE_BUSY_MEM_MAPPED)
+  {
+    ret = true;
+  }
+
+  return ret;
+}
+
+uint32_t qspiGetAddr(void)
+{
+  return QSPI_BASE_ADDRESS;
 }
 
 uint32_t qspiGetLength(void)
@@ -384,12 +922,6 @@ uint32_t qspiGetLength(void)
 
 
 
-static uint8_t QSPI_ResetMemory          (QSPI_HandleTypeDef *hqspi);
-static uint8_t QSPI_WriteEnable          (QSPI_HandleTypeDef *hqspi);
-static uint8_t QSPI_AutoPollingMemReady(QSPI_HandleTypeDef *hqspi, uint32_t Timeout);
-static uint8_t QSPI_ReadStatus(QSPI_HandleTypeDef *hqspi, uint8_t cmd, uint8_t *p_data);
-static uint8_t QSPI_WriteStatus(QSPI_HandleTypeDef *hqspi, uint8_t cmd, uint8_t data);
-
 
 /**
   * @brief  Initializes the QSPI interface.
@@ -417,20 +949,20 @@ uint8_t BSP_QSPI_Init(void)
 
   if (HAL_QSPI_Init(&hqspi) != HAL_OK)
   {
-    logPrintf("HAL_QSPI_Init() fail\n");
+    logE(QSPI, "HAL_QSPI_Init() fail\n");
     return QSPI_ERROR;
   }
 
   /* QSPI memory reset */
   if (QSPI_ResetMemory(&hqspi) != QSPI_OK)
   {
-    logPrintf("QSPI_ResetMemory() fail\n");
+    logE(QSPI, "QSPI_ResetMemory() fail\n");
     return QSPI_NOT_SUPPORTED;
   }
 
   if (BSP_QSPI_Config() != QSPI_OK)
   {
-    logPrintf("QSPI_Config() fail\n");
+    logE(QSPI, "QSPI_Config() fail\n");
     return QSPI_NOT_SUPPORTED;
   }
 
@@ -833,6 +1365,220 @@ uint8_t BSP_QSPI_EnableMemoryMappedMode(void)
   return QSPI_OK;
 }
 
+static uint8_t QSPI_ReadStart(qspi_op_t *p_op)
+{
+  QSPI_CommandTypeDef s_command;
+
+  p_op->cur_len = cmin(p_op->length - p_op->done, QSPI_DMA_MAX_LENGTH);
+
+  s_command.InstructionMode   = QSPI_INSTRUCTION_1_LINE;
+  s_command.Instruction       = QUAD_INOUT_FAST_READ_CMD;
+  s_command.AddressMode       = QSPI_ADDRESS_4_LINES;
+  s_command.AddressSize       = QSPI_ADDRESS_24_BITS;
+  s_command.Address           = p_op->addr + p_op->done;
+  s_command.AlternateByteMode = QSPI_ALTERNATE_BYTES_4_LINES;
+  s_command.AlternateBytesSize= QSPI_ALTERNATE_BYTES_8_BITS;
+  s_command.AlternateBytes    = 0;
+  s_command.DataMode          = QSPI_DATA_4_LINES;
+  s_command.DummyCycles       = W25Q128FV_DUMMY_CYCLES_READ_QUAD;
+  s_command.NbData            = p_op->cur_len;
+  s_command.DdrMode           = QSPI_DDR_MODE_DISABLE;
+  s_command.SIOOMode          = QSPI_SIOO_INST_EVERY_CMD;
+
+  if (HAL_QSPI_Command(&hqspi, &s_command, HAL_QSPI_TIMEOUT_DEFAULT_VALUE) != HAL_OK)
+  {
+    return QSPI_ERROR;
+  }
+
+  MODIFY_REG(hqspi.Instance->DCR, QUADSPI_DCR_CSHT, QSPI_CS_HIGH_TIME_2_CYCLE);
+
+  if (HAL_QSPI_Receive_DMA(&hqspi, &p_op->p_data[p_op->done]) != HAL_OK)
+  {
+    MODIFY_REG(hqspi.Instance->DCR, QUADSPI_DCR_CSHT, QSPI_CS_HIGH_TIME_5_CYCLE);
+    return QSPI_ERROR;
+  }
+
+  return QSPI_OK;
+}
+
+// page 하나를 DMA 로 보내고, 끝나면 status match 인터럽트로 program 완료를 기다린다.
+static uint8_t QSPI_WriteStart(qspi_op_t *p_op)
+{
+  QSPI_CommandTypeDef s_command;
+  uint32_t addr;
+
+  addr = p_op->addr + p_op->done;
+  p_op->cur_len = cmin(p_op->length - p_op->done, W25Q128FV_PAGE_SIZE - (addr % W25Q128FV_PAGE_SIZE));
+
+  s_command.InstructionMode   = QSPI_INSTRUCTION_1_LINE;
+  s_command.Instruction       = QUAD_IN_FAST_PROG_CMD;
+  s_command.AddressMode       = QSPI_ADDRESS_1_LINE;
+  s_command.AddressSize       = QSPI_ADDRESS_24_BITS;
+  s_command.Address           = addr;
+  s_command.AlternateByteMode = QSPI_ALTERNATE_BYTES_NONE;
+  s_command.DataMode          = QSPI_DATA_4_LINES;
+  s_command.DummyCycles       = 0;
+  s_command.NbData            = p_op->cur_len;
+  s_command.DdrMode           = QSPI_DDR_MODE_DISABLE;
+  s_command.SIOOMode          = QSPI_SIOO_INST_EVERY_CMD;
+
+  if (QSPI_WriteEnable(&hqspi) != QSPI_OK)
+  {
+    return QSPI_ERROR;
+  }
+
+  if (HAL_QSPI_Command(&hqspi, &s_command, HAL_QSPI_TIMEOUT_DEFAULT_VALUE) != HAL_OK)
+  {
+    return QSPI_ERROR;
+  }
+
+  p_op->phase = QSPI_PHASE_XFER;
+  if (HAL_QSPI_Transmit_DMA(&hqspi, &p_op->p_data[p_op->done]) != HAL_OK)
+  {
+    return QSPI_ERROR;
+  }
+
+  return QSPI_OK;
+}
+
+static uint8_t QSPI_EraseStart(qspi_op_t *p_op)
+{
+  QSPI_CommandTypeDef s_command;
+  const qspi_erase_t *p_erase;
+
+  p_erase = qspiErasePlan(p_op->addr + p_op->done, p_op->length - p_op->done, p_op->erase_max);
+  p_op->cur_len = p_erase->size;
+
+  s_command.InstructionMode   = QSPI_INSTRUCTION_1_LINE;
+  s_command.Instruction       = p_erase->cmd;
+  s_command.AddressMode       = p_erase->cmd == BULK_ERASE_CMD ? QSPI_ADDRESS_NONE : QSPI_ADDRESS_1_LINE;
+  s_command.AddressSize       = QSPI_ADDRESS_24_BITS;
+  s_command.Address           = p_op->addr + p_op->done;
+  s_command.AlternateByteMode = QSPI_ALTERNATE_BYTES_NONE;
+  s_command.DataMode          = QSPI_DATA_NONE;
+  s_command.DummyCycles       = 0;
+  s_command.DdrMode           = QSPI_DDR_MODE_DISABLE;
+  s_command.SIOOMode          = QSPI_SIOO_INST_EVERY_CMD;
+
+  if (QSPI_WriteEnable(&hqspi) != QSPI_OK)
+  {
+    return QSPI_ERROR;
+  }
+
+  if (HAL_QSPI_Command(&hqspi, &s_command, HAL_QSPI_TIMEOUT_DEFAULT_VALUE) != HAL_OK)
+  {
+    return QSPI_ERROR;
+  }
+
+  p_op->phase = QSPI_PHASE_WAIT;
+  return QSPI_AutoPollingMemReadyIT(&hqspi);
+}
+
+static void QSPI_OpDone(qspi_op_t *p_op, bool ret)
+{
+  p_op->ret     = ret;
+  p_op->type    = QSPI_OP_NONE;
+  p_op->is_busy = false;
+
+  if (p_op->p_func != NULL)
+  {
+    p_op->p_func(p_op->p_arg, ret);
+  }
+
+  // callback 에서 다음 작업을 걸었으면 그것이 끝날 때 들어간다.
+  qspiXipRestore();
+}
+
+static void qspiOpAbort(void)
+{
+  BSP_QSPI_Abort();
+  qspi_op.type    = QSPI_OP_NONE;
+  qspi_op.is_busy = false;
+  qspiXipRestore();
+}
+
+void HAL_QSPI_RxCpltCallback(QSPI_HandleTypeDef *hqspi)
+{
+  qspi_op_t *p_op = &qspi_op;
+
+  MODIFY_REG(hqspi->Instance->DCR, QUADSPI_DCR_CSHT, QSPI_CS_HIGH_TIME_5_CYCLE);
+
+  if (p_op->type != QSPI_OP_READ)
+  {
+    return;
+  }
+
+  p_op->done += p_op->cur_len;
+  if (p_op->done < p_op->length)
+  {
+    if (QSPI_ReadStart(p_op) != QSPI_OK)
+    {
+      QSPI_OpDone(p_op, false);
+    }
+    return;
+  }
+  QSPI_OpDone(p_op, true);
+}
+
+void HAL_QSPI_TxCpltCallback(QSPI_HandleTypeDef *hqspi)
+{
+  qspi_op_t *p_op = &qspi_op;
+
+  if (p_op->type != QSPI_OP_WRITE)
+  {
+    return;
+  }
+
+  p_op->phase = QSPI_PHASE_WAIT;
+  if (QSPI_AutoPollingMemReadyIT(hqspi) != QSPI_OK)
+  {
+    QSPI_OpDone(p_op, false);
+  }
+}
+
+void HAL_QSPI_StatusMatchCallback(QSPI_HandleTypeDef *hqspi)
+{
+  qspi_op_t *p_op = &qspi_op;
+  uint8_t    ret;
+
+  if (p_op->type != QSPI_OP_WRITE && p_op->type != QSPI_OP_ERASE)
+  {
+    return;
+  }
+
+  p_op->done += p_op->cur_len;
+  if (p_op->done >= p_op->length)
+  {
+    QSPI_OpDone(p_op, true);
+    return;
+  }
+  if (p_op->is_cancel == true)
+  {
+    QSPI_OpDone(p_op, false);
+    return;
+  }
+
+  if (p_op->type == QSPI_OP_WRITE)
+    ret = QSPI_WriteStart(p_op);
+  else
+    ret = QSPI_EraseStart(p_op);
+
+  if (ret != QSPI_OK)
+  {
+    QSPI_OpDone(p_op, false);
+  }
+}
+
+void HAL_QSPI_ErrorCallback(QSPI_HandleTypeDef *hqspi)
+{
+  MODIFY_REG(hqspi->Instance->DCR, QUADSPI_DCR_CSHT, QSPI_CS_HIGH_TIME_5_CYCLE);
+
+  if (qspi_op.is_busy == true)
+  {
+    QSPI_OpDone(&qspi_op, false);
+  }
+}
+
 static uint8_t QSPI_ResetMemory(QSPI_HandleTypeDef *hqspi)
 {
   QSPI_CommandTypeDef s_command;
@@ -943,6 +1689,56 @@ static uint8_t QSPI_AutoPollingMemReady(QSPI_HandleTypeDef *hqspi, uint32_t Time
   return QSPI_OK;
 }
 
+static uint8_t QSPI_AutoPollingMemReadyIT(QSPI_HandleTypeDef *hqspi)
+{
+  QSPI_CommandTypeDef     s_command;
+  QSPI_AutoPollingTypeDef s_config;
+
+  s_command.InstructionMode   = QSPI_INSTRUCTION_1_LINE;
+  s_command.Instruction       = READ_STATUS_REG_CMD;
+  s_command.AddressMode       = QSPI_ADDRESS_NONE;
+  s_command.AlternateByteMode = QSPI_ALTERNATE_BYTES_NONE;
+  s_command.DataMode          = QSPI_DATA_1_LINE;
+  s_command.DummyCycles       = 0;
+  s_command.DdrMode           = QSPI_DDR_MODE_DISABLE;
+  s_command.SIOOMode          = QSPI_SIOO_INST_EVERY_CMD;
+
+  s_config.Match           = 0;
+  s_config.Mask            = W25Q128FV_SR_WIP;
+  s_config.MatchMode       = QSPI_MATCH_MODE_AND;
+  s_config.StatusBytesSize = 1;
+  s_config.Interval        = 0x10;
+  s_config.AutomaticStop   = QSPI_AUTOMATIC_STOP_ENABLE;
+
+  if (HAL_QSPI_AutoPolling_IT(hqspi, &s_command, &s_config) != HAL_OK)
+  {
+    return QSPI_ERROR;
+  }
+
+  return QSPI_OK;
+}
+
+static uint8_t QSPI_SendCmd(QSPI_HandleTypeDef *hqspi, uint8_t cmd)
+{
+  QSPI_CommandTypeDef s_command;
+
+  s_command.InstructionMode   = QSPI_INSTRUCTION_1_LINE;
+  s_command.Instruction       = cmd;
+  s_command.AddressMode       = QSPI_ADDRESS_NONE;
+  s_command.AlternateByteMode = QSPI_ALTERNATE_BYTES_NONE;
+  s_command.DataMode          = QSPI_DATA_NONE;
+  s_command.DummyCycles       = 0;
+  s_command.DdrMode           = QSPI_DDR_MODE_DISABLE;
+  s_command.SIOOMode          = QSPI_SIOO_INST_EVERY_CMD;
+
+  if (HAL_QSPI_Command(hqspi, &s_command, HAL_QSPI_TIMEOUT_DEFAULT_VALUE) != HAL_OK)
+  {
+    return QSPI_ERROR;
+  }
+
+  return QSPI_OK;
+}
+
 static uint8_t QSPI_ReadStatus(QSPI_HandleTypeDef *hqspi, uint8_t cmd, uint8_t *p_data)
 {
   QSPI_CommandTypeDef s_command;
@@ -1051,6 +1847,31 @@ void HAL_QSPI_MspInit(QSPI_HandleTypeDef* qspiHandle)
     GPIO_InitStruct.Speed     = GPIO_SPEED_FREQ_VERY_HIGH;
     GPIO_InitStruct.Alternate = GPIO_AF10_QUADSPI;
     HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+
+    /* QUADSPI DMA Init, 방향은 HAL 이 전송할 때마다 바꾼다. */
+    __HAL_RCC_DMAMUX1_CLK_ENABLE();
+    __HAL_RCC_DMA1_CLK_ENABLE();
+
+    hdma_qspi.Instance                 = DMA1_Channel3;
+    hdma_qspi.Init.Request             = DMA_REQUEST_QUADSPI;
+    hdma_qspi.Init.Direction           = DMA_PERIPH_TO_MEMORY;
+    hdma_qspi.Init.PeriphInc           = DMA_PINC_DISABLE;
+    hdma_qspi.Init.MemInc              = DMA_MINC_ENABLE;
+    hdma_qspi.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    hdma_qspi.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+    hdma_qspi.Init.Mode                = DMA_NORMAL;
+    hdma_qspi.Init.Priority            = DMA_PRIORITY_HIGH;
+    if (HAL_DMA_Init(&hdma_qspi) != HAL_OK)
+    {
+      Error_Handler();
+    }
+
+    __HAL_LINKDMA(qspiHandle, hdma, hdma_qspi);
+
+    HAL_NVIC_SetPriority(DMA1_Channel3_IRQn, 5, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Channel3_IRQn);
+    HAL_NVIC_SetPriority(QUADSPI_IRQn, 5, 0);
+    HAL_NVIC_EnableIRQ(QUADSPI_IRQn);
   }
 }
 
@@ -1072,278 +1893,851 @@ void HAL_QSPI_MspDeInit(QSPI_HandleTypeDef* qspiHandle)
     HAL_GPIO_DeInit(GPIOB, GPIO_PIN_8 | GPIO_PIN_9);
 
     HAL_GPIO_DeInit(GPIOA, GPIO_PIN_2 | GPIO_PIN_3 | GPIO_PIN_6 | GPIO_PIN_7);
+
+    HAL_DMA_DeInit(qspiHandle->hdma);
+
+    HAL_NVIC_DisableIRQ(DMA1_Channel3_IRQn);
+    HAL_NVIC_DisableIRQ(QUADSPI_IRQn);
   }
 }
 
-#if CLI_USE(HW_QSPI)
-void cliCmd(cli_args_t *args)
+void DMA1_Channel3_IRQHandler(void)
 {
-  bool ret = false;
-  uint32_t i;
-  uint32_t addr;
-  uint32_t length;
-  uint8_t  data;
-  uint32_t pre_time;
-  bool flash_ret;
+  HAL_DMA_IRQHandler(&hdma_qspi);
+}
 
+void QUADSPI_IRQHandler(void)
+{
+  PROF_ISR_BEGIN();
+  HAL_QSPI_IRQHandler(&hqspi);
+  PROF_ISR_END(PROF_ISR_QSPI);
+}
 
+#if CLI_USE(HW_QSPI)
+void cliQspiInfo(cli_args_t *args)
+{
+  cliPrintf("qspi flash addr  : 0x%X\n", 0);
+  cliPrintf("qspi xip   addr  : 0x%X\n", qspiGetAddr());
+  cliPrintf("qspi xip   mode  : %s%s\n", qspiGetXipMode() ? "True":"False",
+            (qspi_xip.is_enable == true && qspiGetXipMode() != true) ? " (pending)":"");
+  cliPrintf("qspi state       : ");
 
-  if(args->argc == 1 && args->isStr(0, "info"))
+  switch(HAL_QSPI_GetState(&hqspi))
   {
-    cliPrintf("qspi flash addr  : 0x%X\n", 0);
-    cliPrintf("qspi xip   addr  : 0x%X\n", qspiGetAddr());
-    cliPrintf("qspi xip   mode  : %s\n", qspiGetXipMode() ? "True":"False");
-    cliPrintf("qspi state       : ");
+    case HAL_QSPI_STATE_RESET:
+      cliPrintf("RESET\n");
+      break;
+    case HAL_QSPI_STATE_READY:
+      cliPrintf("READY\n");
+      break; 
+    case HAL_QSPI_STATE_BUSY:
+      cliPrintf("BUSY\n");
+      break;    
+    case HAL_QSPI_STATE_BUSY_INDIRECT_TX:
+      cliPrintf("BUSY_INDIRECT_TX\n");
+      break;                                  
+    case HAL_QSPI_STATE_BUSY_INDIRECT_RX:
+      cliPrintf("BUSY_INDIRECT_RX\n");
+      break;      
+    case HAL_QSPI_STATE_BUSY_AUTO_POLLING:
+      cliPrintf("BUSY_AUTO_POLLING\n");
+      break;          
+    case HAL_QSPI_STATE_BUSY_MEM_MAPPED:
+      cliPrintf("BUSY_MEM_MAPPED\n");
+      break;       
+    case HAL_QSPI_STATE_ABORT:
+      cliPrintf("ABORT\n");
+      break;        
+    case HAL_QSPI_STATE_ERROR:
+      cliPrintf("ERROR\n");
+      break;                                                                                        
+    default:
+      cliPrintf("UNKWNON\n");
+      break;
+  }
+  cliPrintf("qspi suspend     : %d, read wait : %d, lat max %d us\n",
+            qspi_sus.suspend_cnt, qspi_sus.wait_cnt, qspi_sus.lat_max_us);
+  cliPrintf("qspi xip exit    : %d, avg %d us, max %d us\n",
+            qspi_xip.exit_cnt, qspi_xip.exit_us_sum / cmax(qspi_xip.exit_cnt, 1), qspi_xip.exit_us_max);
+  cliPrintf("qspi xip enter   : %d, avg %d us, max %d us\n",
+            qspi_xip.enter_cnt, qspi_xip.enter_us_sum / cmax(qspi_xip.enter_cnt, 1), qspi_xip.enter_us_max);
+}
+
+void cliQspiTest(cli_args_t *args)
+{
+  uint8_t rx_buf[256];
 
-    switch(HAL_QSPI_GetState(&hqspi))
+  for (int i=0; i<100; i++)
+  {
+    if (qspiRead(0x1000*i, rx_buf, 256))
     {
-      case HAL_QSPI_STATE_RESET:
-        cliPrintf("RESET\n");
-        break;
-      case HAL_QSPI_STATE_READY:
-        cliPrintf("READY\n");
-        break; 
-      case HAL_QSPI_STATE_BUSY:
-        cliPrintf("BUSY\n");
-        break;    
-      case HAL_QSPI_STATE_BUSY_INDIRECT_TX:
-        cliPrintf("BUSY_INDIRECT_TX\n");
-        break;                                  
-      case HAL_QSPI_STATE_BUSY_INDIRECT_RX:
-        cliPrintf("BUSY_INDIRECT_RX\n");
-        break;      
-      case HAL_QSPI_STATE_BUSY_AUTO_POLLING:
-        cliPrintf("BUSY_AUTO_POLLING\n");
-        break;          
-      case HAL_QSPI_STATE_BUSY_MEM_MAPPED:
-        cliPrintf("BUSY_MEM_MAPPED\n");
-        break;       
-      case HAL_QSPI_STATE_ABORT:
-        cliPrintf("ABORT\n");
-        break;        
-      case HAL_QSPI_STATE_ERROR:
-        cliPrintf("ERROR\n");
-        break;                                                                                        
-      default:
-        cliPrintf("UNKWNON\n");
-        break;
+      cliPrintf("%d : OK\n", i);
+    }
+    else
+    {
+      cliPrintf("%d : FAIL\n", i);
+      break;
     }
-    ret = true;
   }
-  
-  if(args->argc == 1 && args->isStr(0, "test"))
-  {
-    uint8_t rx_buf[256];
+}
 
-    for (int i=0; i<100; i++)
-    {
-      if (qspiRead(0x1000*i, rx_buf, 256))
-      {
-        cliPrintf("%d : OK\n", i);
-      }
-      else
-      {
-        cliPrintf("%d : FAIL\n", i);
-        break;
-      }
-    }
-    ret = true;
-  }    
+void cliQspiXip(cli_args_t *args)
+{
+  bool xip_enable;
 
-  if (args->argc == 2 && args->isStr(0, "xip"))
-  {
-    bool xip_enable;
+  xip_enable = args->isStr(0, "on") ? true:false;
 
-    xip_enable = args->isStr(1, "on") ? true:false;
+  if (qspiSetXipMode(xip_enable))
+    cliPrintf("qspiSetXipMode() : OK\n");
+  else
+    cliPrintf("qspiSetXipMode() : Fail\n");
+  
+  cliPrintf("qspi xip mode  : %s\n", qspiGetXipMode() ? "True":"False");
+}
 
-    if (qspiSetXipMode(xip_enable))
-      cliPrintf("qspiSetXipMode() : OK\n");
-    else
-      cliPrintf("qspiSetXipMode() : Fail\n");
-    
-    cliPrintf("qspi xip mode  : %s\n", qspiGetXipMode() ? "True":"False");
+void cliQspiRead(cli_args_t *args)
+{
+  uint32_t addr;
+  uint32_t length;
+  uint8_t  data;
+  bool     flash_ret;
 
-    ret = true;
-  } 
+  addr   = (uint32_t)args->getData(0);
+  length = (uint32_t)args->getData(1);
 
-  if (args->argc == 3 && args->isStr(0, "read"))
+  for (uint32_t i=0; i<length; i++)
   {
-    addr   = (uint32_t)args->getData(1);
-    length = (uint32_t)args->getData(2);
+    flash_ret = qspiRead(addr+i, &data, 1);
 
-    for (i=0; i<length; i++)
+    if (flash_ret == true)
     {
-      flash_ret = qspiRead(addr+i, &data, 1);
-
-      if (flash_ret == true)
-      {
-        cliPrintf( "addr : 0x%X\t 0x%02X\n", addr+i, data);
-      }
-      else
-      {
-        cliPrintf( "addr : 0x%X\t Fail\n", addr+i);
-      }
+      cliPrintf( "addr : 0x%X\t 0x%02X\n", addr+i, data);
+    }
+    else
+    {
+      cliPrintf( "addr : 0x%X\t Fail\n", addr+i);
+      cliSetError();
     }
-    ret = true;
   }
-  
-  if(args->argc == 3 && args->isStr(0, "erase") == true)
+}
+
+static void cliQspiEraseDone(void *p_arg, bool ret)
+{
+  cli_job_t *p_job = (cli_job_t *)p_arg;
+
+  if (ret != true)
   {
-    addr   = (uint32_t)args->getData(1);
-    length = (uint32_t)args->getData(2);
+    p_job->ret = false;
+  }
+  p_job->arg[2] = 1;
+}
 
-    pre_time = millis();
-    flash_ret = qspiErase(addr, length);
+// erase 는 백그라운드로 돌고 job 은 진행률만 본다.
+static bool cliQspiEraseJob(cli_job_t *p_job)
+{
+  uint32_t done;
+  uint32_t length;
 
-    cliPrintf( "addr : 0x%X\t len : %d %d ms\n", addr, length, (millis()-pre_time));
-    if (flash_ret)
-    {
-      cliPrintf("OK\n");
-    }
-    else
+  if (p_job->step == 0)
+  {
+    p_job->arg[2] = 0;
+    if (qspiEraseAsync(p_job->arg[0], p_job->arg[1], cliQspiEraseDone, p_job) != true)
     {
-      cliPrintf("FAIL\n");
+      cliPrintf("qspiEraseAsync() Fail");
+      p_job->ret = false;
+      return false;
     }
-    ret = true;
+    qspiGetProgress(&done, &length);
+    cliPrintf("addr : 0x%X, len : 0x%X\n", p_job->arg[0], length);
+    cliJobStage(p_job, "erase", length / 1024);
+    p_job->step = 1;
   }
 
-  if(args->argc == 3 && args->isStr(0, "write") == true)
+  if (p_job->is_cancel == true)
   {
-    uint32_t flash_data;
+    qspiCancel();
+  }
 
-    addr = (uint32_t)args->getData(1);
-    flash_data = (uint32_t )args->getData(2);
+  if (qspiGetProgress(&done, &length) == true)
+  {
+    p_job->done = done / 1024;
+  }
+  else if (p_job->arg[2] == 1)
+  {
+    p_job->done = p_job->total;
+    return false;
+  }
 
-    pre_time = millis();
-    flash_ret = qspiWrite(addr, (uint8_t *)&flash_data, 4);
+  return true;
+}
 
-    cliPrintf( "addr : 0x%X\t 0x%X %dms\n", addr, flash_data, millis()-pre_time);
-    if (flash_ret)
-    {
-      cliPrintf("OK\n");
-    }
-    else
-    {
-      cliPrintf("FAIL\n");
-    }
-    ret = true;
+void cliQspiErase(cli_args_t *args)
+{
+  static cli_job_t job;
+
+  if (qspiIsBusy() == true)
+  {
+    cliPrintf("busy\n");
+    cliSetError();
+    return;
   }
+  if (cliJobIsIdle(&job, "erase") != true)
+  {
+    return;
+  }
+
+  job.arg[0] = (uint32_t)args->getData(0);
+  job.arg[1] = (uint32_t)args->getData(1);
+  cliJobStart(&job, "erase", cliQspiEraseJob);
+}
+
+// 같은 범위를 4KB erase 로만 지울 때와 planner 로 지울 때를 비교한다.
+static bool cliQspiEraseBenchJob(cli_job_t *p_job)
+{
+  static const struct
+  {
+    const char *name;
+    uint32_t    erase_max;
+  } bench_tbl[] =
+  {
+    {"4k",   W25Q128FV_SUBSECTOR_SIZE},
+    {"plan", W25Q128FV_FLASH_SIZE},
+  };
+  uint32_t stage = p_job->step / 2;
+  uint32_t done;
+  uint32_t length;
+  uint32_t count;
+  uint32_t typ_ms;
+  uint32_t max_ms;
+
 
-  if (args->argc == 1 && args->isStr(0, "speed-test") == true)
+  if (stage >= sizeof(bench_tbl)/sizeof(bench_tbl[0]))
   {
-    uint32_t buf[512/4];
-    uint32_t cnt;
-    uint32_t pre_time;
-    uint32_t exe_time;
-    uint32_t xip_addr;
+    return false;
+  }
 
-    xip_addr = qspiGetAddr();
-    cnt = 1024*1024 / 512;
-    pre_time = millis();
-    for (int i=0; i<cnt; i++)
+  if (p_job->step % 2 == 0)
+  {
+    if (p_job->is_cancel == true)
     {
-      if (qspiGetXipMode())
-      {
-        memcpy(buf, (void *)(xip_addr + i*512), 512);
-      }
-      else
-      {
-        if (qspiRead(i*512, (uint8_t *)buf, 512) == false)
-        {
-          cliPrintf("qspiRead() Fail:%d\n", i);
-          break;
-        }
-      }
+      return false;
     }
-    exe_time = millis()-pre_time;
-    if (exe_time > 0)
+
+    p_job->arg[2] = 0;
+    if (qspiEraseRangeAsync(p_job->arg[0], p_job->arg[1], bench_tbl[stage].erase_max, cliQspiEraseDone, p_job) != true)
     {
-      cliPrintf("%d KB/sec\n", 1024 * 1000 / exe_time);
+      cliPrintf("\nqspiEraseRangeAsync() Fail");
+      p_job->ret = false;
+      return false;
     }
-    ret = true;
+    qspiGetProgress(&done, &length);
+    cliJobStage(p_job, bench_tbl[stage].name, length / 1024);
+    p_job->arg[3] = millis();
+    p_job->step++;
+    return true;
   }
 
-  if(args->argc == 3 && args->isStr(0, "check"))
+  if (p_job->is_cancel == true)
   {
-    uint64_t data = 0;
-    uint32_t block = 8;
-    bool flash_ret;
+    qspiCancel();
+  }
 
-    addr   = (uint32_t)args->getData(1);
-    length = (uint32_t)args->getData(2);
-    length -= (length % block);
+  if (qspiGetProgress(&done, &length) == true)
+  {
+    p_job->done = done / 1024;
+    return true;
+  }
+  if (p_job->arg[2] == 0)
+  {
+    return true;
+  }
+
+  p_job->done = p_job->total;
+  qspiErasePlanTime(p_job->arg[0] - p_job->arg[0]%W25Q128FV_SUBSECTOR_SIZE, p_job->total * 1024,
+                    bench_tbl[stage].erase_max, &count, &typ_ms, &max_ms);
+  cliPrintf(" : %d ms, %d cmds (model typ %d ms, max %d ms)",
+            (int)(millis() - p_job->arg[3]), (int)count, (int)typ_ms, (int)max_ms);
 
-    do
+  p_job->step++;
+  return p_job->ret;
+}
+
+void cliQspiEraseBench(cli_args_t *args)
+{
+  static cli_job_t job;
+
+  if (qspiIsBusy() == true)
+  {
+    cliPrintf("busy\n");
+    cliSetError();
+    return;
+  }
+  if (cliJobIsIdle(&job, "erase-bench") != true)
+  {
+    return;
+  }
+
+  job.arg[0] = (uint32_t)args->getData(0);
+  job.arg[1] = (uint32_t)args->getData(1);
+  cliJobStart(&job, "erase-bench", cliQspiEraseBenchJob);
+}
+
+#define QSPI_SUS_TEST_READ    0x10000
+#define QSPI_SUS_TEST_ERASE   0x100000
+
+static uint8_t cliQspiSusPattern(uint32_t offset)
+{
+  return (uint8_t)(offset ^ (offset >> 8) ^ 0x5A);
+}
+
+// addr 의 64KB 에 pattern 을 쓰고, 그 뒤 1MB 를 백그라운드로 지우는 동안 계속 읽어서
+// read 지연과 결과를 확인한다. 끝나면 지운 영역이 모두 0xFF 인지 본다.
+static bool cliQspiSuspendTestJob(cli_job_t *p_job)
+{
+  static uint8_t  buf[256];
+  static uint32_t read_cnt;
+  static uint32_t lat_max;
+  static uint32_t sus_cnt;
+  uint32_t addr = p_job->arg[0];
+  uint32_t offset;
+  uint32_t pre_cycles;
+  uint32_t i;
+
+
+  if (p_job->is_cancel == true)
+  {
+    qspiCancel();
+    if (qspiIsBusy() == true)
     {
-      flash_ret = true;
-      cliPrintf("qspiErase()..");
-      if (qspiErase(addr, length) == false)
+      return true;
+    }
+    return false;
+  }
+
+  switch(p_job->step)
+  {
+    case 0:
+      p_job->arg[2] = 0;
+      if (qspiEraseAsync(addr, QSPI_SUS_TEST_READ, cliQspiEraseDone, p_job) != true)
+      {
+        cliPrintf("qspiEraseAsync() Fail\n");
+        p_job->ret = false;
+        return false;
+      }
+      cliJobStage(p_job, "erase", QSPI_SUS_TEST_READ / 1024);
+      p_job->step++;
+      break;
+
+    case 1:
+      if (qspiGetProgress(&offset, &i) == true)
       {
-        flash_ret = false;
+        p_job->done = offset / 1024;
         break;
       }
-      cliPrintf("%s\n", flash_ret ? "OK" : "Fail");
+      if (p_job->arg[2] == 0)
+      {
+        break;
+      }
+      if (p_job->ret != true)
+      {
+        cliPrintf("\nqspiEraseAsync() Fail");
+        return false;
+      }
+      cliJobStage(p_job, "write", QSPI_SUS_TEST_READ / sizeof(buf));
+      p_job->step++;
+      break;
+
+    case 2:
+      offset = p_job->done * sizeof(buf);
+      for (i=0; i<sizeof(buf); i++)
+      {
+        buf[i] = cliQspiSusPattern(offset + i);
+      }
+      if (qspiWrite(addr + offset, buf, sizeof(buf)) != true)
+      {
+        cliPrintf("\nqspiWrite() Fail : 0x%X", addr + offset);
+        p_job->ret = false;
+        return false;
+      }
+      p_job->done++;
+      if (p_job->done >= p_job->total)
+      {
+        p_job->step++;
+      }
+      break;
 
+    case 3:
+      read_cnt = 0;
+      lat_max  = 0;
+      sus_cnt  = qspi_sus.suspend_cnt;
+      p_job->arg[2] = 0;
+      if (qspiEraseAsync(addr + QSPI_SUS_TEST_READ, QSPI_SUS_TEST_ERASE, cliQspiEraseDone, p_job) != true)
+      {
+        cliPrintf("\nqspiEraseAsync() Fail");
+        p_job->ret = false;
+        return false;
+      }
+      cliJobStage(p_job, "read", QSPI_SUS_TEST_ERASE / 1024);
+      p_job->arg[3] = millis();
+      p_job->step++;
+      break;
 
-      flash_ret = true;
-      cliPrintf("qspiWrite()..");
-      for (uint32_t i=0; i<length; i+=block)
+    case 4:
+      qspiGetProgress(&offset, &i);
+      p_job->done = offset / 1024;
+
+      if (p_job->arg[2] == 1)
       {
-        data = ((uint64_t)i<<32) | ((uint64_t)i<<0);
-        if (qspiWrite(addr + i, (uint8_t *)&data, block) == false)
+        cliPrintf("\nerase %d ms, %d reads, %d suspend, read lat max %d us",
+                  (int)(millis() - p_job->arg[3]), (int)read_cnt,
+                  (int)(qspi_sus.suspend_cnt - sus_cnt), (int)lat_max);
+        if (p_job->ret != true)
         {
-          cliPrintf("0x%X ", i);
-          flash_ret = false;
-          break;
+          return false;
         }
+        cliJobStage(p_job, "verify", QSPI_SUS_TEST_ERASE / sizeof(buf));
+        p_job->step++;
+        break;
+      }
+      if (p_job->ret != true)
+      {
+        break;      // 실패했으면 erase 가 끝날 때까지 기다린다.
       }
-      cliPrintf("%s\n", flash_ret ? "OK" : "Fail");
 
-      flash_ret = true;
-      cliPrintf("qspiRead() ..");
-      for (uint32_t i=0; i<length; i+=block)
+      offset = (read_cnt * sizeof(buf)) % QSPI_SUS_TEST_READ;
+      pre_cycles = cycles();
+      if (qspiRead(addr + offset, buf, sizeof(buf)) != true)
+      {
+        cliPrintf("\nqspiRead() Fail : 0x%X", addr + offset);
+        p_job->ret = false;
+        break;
+      }
+      lat_max = cmax(lat_max, (cycles() - pre_cycles) / (SystemCoreClock / 1000000));
+      for (i=0; i<sizeof(buf); i++)
       {
-        data = 0;
-        if (qspiRead(addr + i, (uint8_t *)&data, block) == false)
+        if (buf[i] != cliQspiSusPattern(offset + i))
         {
-          cliPrintf("0x%X ", i);
-          flash_ret = false;
+          cliPrintf("\nCheck Fail : 0x%X", addr + offset + i);
+          p_job->ret = false;
           break;
         }
-        if (data != (((uint64_t)i<<32)|((uint64_t)i<<0)))
+      }
+      if (p_job->ret == true)
+      {
+        read_cnt++;
+      }
+      break;
+
+    case 5:
+      offset = QSPI_SUS_TEST_READ + p_job->done * sizeof(buf);
+      if (qspiRead(addr + offset, buf, sizeof(buf)) != true)
+      {
+        cliPrintf("\nqspiRead() Fail : 0x%X", addr + offset);
+        p_job->ret = false;
+        return false;
+      }
+      for (i=0; i<sizeof(buf); i++)
+      {
+        if (buf[i] != 0xFF)
         {
-          cliPrintf("Check 0x%X ", i);
-          flash_ret = false;
-          break;
+          cliPrintf("\nErase Fail : 0x%X", addr + offset + i);
+          p_job->ret = false;
+          return false;
         }
-      }  
-      cliPrintf("%s\n", flash_ret ? "OK" : "Fail");
+      }
+      p_job->done++;
+      if (p_job->done >= p_job->total)
+      {
+        p_job->step++;
+      }
+      break;
+
+    default:
+      return false;
+  }
+
+  return true;
+}
+
+void cliQspiSuspendTest(cli_args_t *args)
+{
+  static cli_job_t job;
+  uint32_t addr;
 
+  addr = (uint32_t)args->getData(0);
 
-      flash_ret = true;
-      cliPrintf("qspiErase()..");
-      if (qspiErase(addr, length) == false)
+  if ((addr % W25Q128FV_SECTOR_SIZE) != 0 || addr + QSPI_SUS_TEST_READ + QSPI_SUS_TEST_ERASE > W25Q128FV_FLASH_SIZE)
+  {
+    cliPrintf("addr must be 64KB aligned and below 0x%X\n", W25Q128FV_FLASH_SIZE - QSPI_SUS_TEST_READ - QSPI_SUS_TEST_ERASE);
+    cliSetError();
+    return;
+  }
+  if (qspiIsBusy() == true)
+  {
+    cliPrintf("busy\n");
+    cliSetError();
+    return;
+  }
+  if (cliJobIsIdle(&job, "suspend-test") != true)
+  {
+    return;
+  }
+
+  job.arg[0] = addr;
+  cliJobStart(&job, "suspend-test", cliQspiSuspendTestJob);
+}
+
+void cliQspiWrite(cli_args_t *args)
+{
+  uint32_t addr;
+  uint32_t flash_data;
+  uint32_t pre_time;
+  bool     flash_ret;
+
+  addr = (uint32_t)args->getData(0);
+  flash_data = (uint32_t )args->getData(1);
+
+  pre_time = millis();
+  flash_ret = qspiWrite(addr, (uint8_t *)&flash_data, 4);
+
+  cliPrintf( "addr : 0x%X\t 0x%X %dms\n", addr, flash_data, millis()-pre_time);
+  if (flash_ret)
+  {
+    cliPrintf("OK\n");
+  }
+  else
+  {
+    cliPrintf("FAIL\n");
+    cliSetError();
+  }
+}
+
+static void cliQspiSpeedTestPrint(cli_job_t *p_job)
+{
+  uint32_t exe_ms;
+
+  exe_ms = cmax(millis() - p_job->arg[1], 1);
+  cliPrintf(" : %d KB/sec", (int)(p_job->total * 4 * 1000 / exe_ms));
+  if (p_job->arg[2] > 0)
+  {
+    // async 는 CPU 가 명령을 거는 데 쓴 시간만 센다.
+    cliPrintf(", cpu %d%%", (int)((uint64_t)p_job->arg[2] * 100 / (exe_ms * 1000)));
+  }
+}
+
+static void cliQspiSpeedTestDone(void *p_arg, bool ret)
+{
+  cli_job_t *p_job = (cli_job_t *)p_arg;
+
+  if (ret == true)
+  {
+    p_job->done++;
+  }
+  else
+  {
+    p_job->ret = false;
+  }
+  p_job->arg[3] = 0;
+}
+
+// qspi_op 를 잡고 HAL_QSPI_Receive 로 읽는다. 다른 작업이 돌고 있으면 false 로 돌려준다.
+static bool cliQspiReadPoll(uint32_t addr, uint8_t *p_data, uint32_t length, bool *p_ret)
+{
+  if (qspiOpBegin(QSPI_OP_READ, addr, p_data, length, NULL, NULL) != true)
+  {
+    return false;
+  }
+  *p_ret = BSP_QSPI_Read(p_data, addr, length) == QSPI_OK;
+  QSPI_OpDone(&qspi_op, *p_ret);
+
+  return true;
+}
+
+// 1MB 를 4KB 씩 읽는다. (littlefs block 크기)
+//   xip   : qspiRead(), XIP 창에서 복사한다. 매번 XIP 인지 다시 본다.
+//   poll  : HAL_QSPI_Receive, CPU 가 FIFO 를 직접 비운다.
+//   dma   : qspiRead(), DMA 로 받고 끝날 때까지 기다린다.
+//   async : qspiReadAsync(), 기다리는 동안 job 은 양보한다.
+// 다른 session 의 작업이 돌고 있으면 끝날 때까지 양보하고, 멈추지는 않는다.
+static bool cliQspiSpeedTestJob(cli_job_t *p_job)
+{
+  static uint32_t buf[4096/4];
+  const uint32_t total = 1024*1024 / sizeof(buf);
+  uint32_t addr;
+  uint32_t pre_cycles;
+  bool     ret = true;
+
+
+  if (p_job->is_cancel == true || p_job->ret != true)
+  {
+    // 이 job 이 건 async read 만 끝나기를 기다린다.
+    return p_job->arg[3] == 1;
+  }
+
+  addr = p_job->done * sizeof(buf);
+
+  switch(p_job->step)
+  {
+    case 0:
+      if (qspiGetXipMode())
+      {
+        cliJobStage(p_job, "xip", total);
+        p_job->step = 1;
+      }
+      else
+      {
+        cliJobStage(p_job, "poll", total);
+        p_job->step = 2;
+      }
+      p_job->arg[1] = millis();
+      p_job->arg[2] = 0;
+      p_job->arg[3] = 0;
+      break;
+
+    case 1:
+      ret = qspiRead(addr, (uint8_t *)buf, sizeof(buf));
+      p_job->done++;
+      if (p_job->done >= p_job->total)
+      {
+        cliQspiSpeedTestPrint(p_job);
+        p_job->step = 10;
+      }
+      break;
+
+    case 2:
+      if (cliQspiReadPoll(addr, (uint8_t *)buf, sizeof(buf), &ret) != true)
       {
-        flash_ret = false;
         break;
       }
-      cliPrintf("%s\n", flash_ret ? "OK" : "Fail");
-    } while (0);
-    
-    ret = true;
+      p_job->done++;
+      if (p_job->done >= p_job->total)
+      {
+        cliQspiSpeedTestPrint(p_job);
+        cliJobStage(p_job, "dma", total);
+        p_job->arg[1] = millis();
+        p_job->step = 3;
+      }
+      break;
+
+    case 3:
+      ret = qspiRead(addr, (uint8_t *)buf, sizeof(buf));
+      p_job->done++;
+      if (p_job->done >= p_job->total)
+      {
+        cliQspiSpeedTestPrint(p_job);
+        cliJobStage(p_job, "async", total);
+        p_job->arg[1] = millis();
+        p_job->step = 4;
+      }
+      break;
+
+    case 4:
+      if (p_job->arg[3] == 1 || qspiIsBusy() == true)
+      {
+        break;
+      }
+      if (p_job->done >= p_job->total)
+      {
+        cliQspiSpeedTestPrint(p_job);
+        p_job->step = 10;
+        break;
+      }
+      p_job->arg[3] = 1;
+      pre_cycles = cycles();
+      ret = qspiReadAsync(addr, (uint8_t *)buf, sizeof(buf), cliQspiSpeedTestDone, p_job);
+      p_job->arg[2] += (cycles() - pre_cycles) / (SystemCoreClock / 1000000);
+      if (ret != true)
+      {
+        p_job->arg[3] = 0;
+      }
+      break;
+
+    default:
+      return false;
   }
 
-  if (ret == false)
+  if (ret != true)
   {
-    cliPrintf("qspi info\n");
-    cliPrintf("qspi xip on:off\n");
-    cliPrintf("qspi test\n");
-    cliPrintf("qspi speed-test\n");
-    cliPrintf("qspi check [addr] [length]\n");
-    cliPrintf("qspi read  [addr] [length]\n");
-    cliPrintf("qspi erase [addr] [length]\n");
-    cliPrintf("qspi write [addr] [data]\n");
+    cliPrintf("\nqspiRead() Fail:%d", p_job->done);
+    p_job->ret = false;
+    return false;
   }
+
+  return true;
+}
+
+void cliQspiSpeedTest(cli_args_t *args)
+{
+  static cli_job_t job;
+
+  cliJobStart(&job, "speed-test", cliQspiSpeedTestJob);
+}
+
+static bool cliQspiCheckJob(cli_job_t *p_job)
+{
+  uint64_t data = 0;
+  uint32_t block  = 8;
+  uint32_t addr   = p_job->arg[0];
+  uint32_t length = p_job->arg[1];
+  uint32_t i;
+  uint32_t erase_addr;
+  uint32_t erase_len;
+  bool     is_erase;
+
+
+  // step 1, 7 은 이 job 이 건 erase 가 도는 중이다.
+  is_erase = (p_job->step == 1 || p_job->step == 7) && p_job->arg[2] == 0;
+
+  if (p_job->is_cancel == true)
+  {
+    if (is_erase == true)
+    {
+      qspiCancel();
+      return true;
+    }
+    return false;
+  }
+
+  erase_addr = addr - (addr % W25Q128FV_SECTOR_SIZE);
+  erase_len  = (addr + length - erase_addr + W25Q128FV_SECTOR_SIZE - 1) / W25Q128FV_SECTOR_SIZE * W25Q128FV_SECTOR_SIZE;
+
+  switch(p_job->step)
+  {
+    case 0:
+    case 6:
+      p_job->arg[2] = 0;
+      if (qspiEraseAsync(erase_addr, erase_len, cliQspiEraseDone, p_job) != true)
+      {
+        cliPrintf("\nqspiEraseAsync() Fail");
+        p_job->ret = false;
+        return false;
+      }
+      cliJobStage(p_job, "erase", erase_len / 1024);
+      p_job->step++;
+      break;
+
+    case 1:
+    case 7:
+      // erase 는 백그라운드로 돌고 여기서는 진행률만 본다.
+      if (is_erase == true)
+      {
+        qspiGetProgress(&i, &erase_len);
+        p_job->done = i / 1024;
+        break;
+      }
+      if (p_job->ret != true)
+      {
+        cliPrintf("\nqspiEraseAsync() Fail");
+        return false;
+      }
+      p_job->done = p_job->total;
+      p_job->step++;
+      break;
+
+    case 2:
+      cliJobStage(p_job, "write", length / block);
+      p_job->step++;
+      break;
+
+    case 3:
+      i = p_job->done * block;
+      data = ((uint64_t)i<<32) | ((uint64_t)i<<0);
+      if (qspiWrite(addr + i, (uint8_t *)&data, block) == false)
+      {
+        cliPrintf("\nqspiWrite() Fail : 0x%X", i);
+        p_job->ret = false;
+        return false;
+      }
+      p_job->done++;
+      if (p_job->done >= p_job->total)
+      {
+        p_job->step++;
+      }
+      break;
+
+    case 4:
+      cliJobStage(p_job, "read", length / block);
+      p_job->step++;
+      break;
+
+    case 5:
+      i = p_job->done * block;
+      if (qspiRead(addr + i, (uint8_t *)&data, block) == false)
+      {
+        cliPrintf("\nqspiRead() Fail : 0x%X", i);
+        p_job->ret = false;
+        return false;
+      }
+      if (data != (((uint64_t)i<<32)|((uint64_t)i<<0)))
+      {
+        cliPrintf("\nCheck Fail : 0x%X", i);
+        p_job->ret = false;
+        return false;
+      }
+      p_job->done++;
+      if (p_job->done >= p_job->total)
+      {
+        p_job->step++;
+      }
+      break;
+
+    default:
+      return false;
+  }
+
+  return true;
+}
+
+void cliQspiCheck(cli_args_t *args)
+{
+  static cli_job_t job;
+  uint32_t block = 8;
+  uint32_t addr;
+  uint32_t length;
+
+  addr   = (uint32_t)args->getData(0);
+  length = (uint32_t)args->getData(1);
+  length -= (length % block);
+
+  if (length == 0 || addr + length > W25Q128FV_FLASH_SIZE)
+  {
+    cliPrintf("out of range\n");
+    cliSetError();
+    return;
+  }
+  if (cliJobIsIdle(&job, "check") != true)
+  {
+    return;
+  }
+  job.arg[0] = addr;
+  job.arg[1] = length;
+  cliJobStart(&job, "check", cliQspiCheckJob);
+}
+#endif
+
+#ifdef _USE_HW_CLI_BIN
+cli_bin_status_t cliBinQspiRead(cli_bin_t *p_bin)
+{
+  uint32_t addr;
+  uint16_t length;
+  uint8_t *p_data;
+
+  if (cliBinGetU32(p_bin, &addr) != true || cliBinGetU16(p_bin, &length) != true)
+  {
+    return CLI_BIN_ERR_PARAM;
+  }
+
+  p_data = cliBinReserve(p_bin, length);
+  if (p_data == NULL)
+  {
+    return CLI_BIN_ERR_LENGTH;
+  }
+  if (qspiRead(addr, p_data, length) != true)
+  {
+    return CLI_BIN_ERR_FAIL;
+  }
+
+  return CLI_BIN_OK;
 }
 #endif
 
@@ -1,4 +1,5 @@
 #include "swtimer.h"
+#include "prof.h"
 
 
 #ifdef _USE_HW_SWTIMER
@@ -160,7 +161,9 @@ uint32_t swtimerGetCounter(void)
 
 void TIM1_TRG_COM_TIM17_IRQHandler(void)
 {
+  PROF_ISR_BEGIN();
   HAL_TIM_IRQHandler(&htim17);
+  PROF_ISR_END(PROF_ISR_TIM17);
 }
 
 void swtimerTimerCallback(TIM_HandleTypeDef *htim)
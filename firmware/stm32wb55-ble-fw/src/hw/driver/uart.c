@@ -3,6 +3,7 @@
 
 #ifdef _USE_HW_UART
 #include "qbuffer.h"
+#include "print.h"
 #include "cli.h"
 #ifdef _USE_HW_USB
 #include "cdc.h"
@@ -10,6 +11,8 @@
 
 
 #define UART_RX_BUF_LENGTH        1024
+#define UART_TX_BUF_LENGTH        1024
+#define UART_TX_TIMEOUT           100
 
 
 
@@ -22,9 +25,20 @@ typedef struct
   qbuffer_t qbuffer;
   UART_HandleTypeDef *p_huart;
   DMA_HandleTypeDef  *p_hdma_rx;
+  DMA_HandleTypeDef  *p_hdma_tx;
+
+  uint8_t   tx_buf[UART_TX_BUF_LENGTH];
+  qbuffer_t qbuffer_tx;
+  volatile uint32_t tx_dma_len;
+  uart_tx_policy_t  tx_policy;
 
   uint32_t rx_cnt;
   uint32_t tx_cnt;
+
+  uint32_t rx_in_total;       // DMA 가 받은 누적 byte
+  uint32_t rx_out_total;      // 읽었거나 overrun 으로 버린 누적 byte
+  uint32_t rx_overrun_cnt;
+  void   (*rx_event_func)(uint8_t ch, uint32_t event);
 } uart_tbl_t;
 
 typedef struct
@@ -43,6 +57,13 @@ typedef struct
 #if CLI_USE(HW_UART)
 static void cliUart(cli_args_t *args);
 #endif
+static void uartStartTx(uint8_t ch);
+static void uartUpdateRx(uint8_t ch);
+#ifdef _USE_HW_USB
+static void uartCdcRxEvent(void);
+#endif
+static void uartCheckOverrun(uint8_t ch);
+static uint32_t uartWriteTx(uint8_t ch, uint8_t *p_data, uint32_t length, uart_tx_policy_t policy);
 
 
 static bool is_init = false;
@@ -51,11 +72,12 @@ static uart_tbl_t uart_tbl[UART_MAX_CH];
 
 static UART_HandleTypeDef huart1;
 static DMA_HandleTypeDef hdma_usart1_rx;
+static DMA_HandleTypeDef hdma_usart1_tx;
 
 
 const static uart_hw_t uart_hw_tbl[UART_MAX_CH] = 
   {
-    {"USART1 SWD   ", USART1, &huart1, &hdma_usart1_rx, NULL, false},
+    {"USART1 SWD   ", USART1, &huart1, &hdma_usart1_rx, &hdma_usart1_tx, false},
     {"USB    CDC   ", NULL,   NULL,    NULL,            NULL, false},    
   };
 
@@ -71,6 +93,10 @@ bool uartInit(void)
     uart_tbl[i].baud = 57600;
     uart_tbl[i].rx_cnt = 0;
     uart_tbl[i].tx_cnt = 0;    
+    uart_tbl[i].tx_dma_len = 0;
+    uart_tbl[i].tx_policy  = UART_TX_POLICY_BLOCK;
+    uart_tbl[i].rx_overrun_cnt = 0;
+    uart_tbl[i].rx_event_func  = NULL;
   }
 
   is_init = true;
@@ -95,6 +121,7 @@ bool uartOpen(uint8_t ch, uint32_t baud)
 {
   bool ret = false;
   HAL_StatusTypeDef ret_hal;
+  uint32_t primask;
 
 
   if (ch >= UART_MAX_CH) return false;
@@ -112,6 +139,7 @@ bool uartOpen(uint8_t ch, uint32_t baud)
 
       uart_tbl[ch].p_huart           = uart_hw_tbl[ch].p_huart;
       uart_tbl[ch].p_hdma_rx         = uart_hw_tbl[ch].p_hdma_rx;
+      uart_tbl[ch].p_hdma_tx         = uart_hw_tbl[ch].p_hdma_tx;
       uart_tbl[ch].p_huart->Instance = uart_hw_tbl[ch].p_uart;
 
       uart_tbl[ch].p_huart->Init.BaudRate               = baud;
@@ -126,6 +154,10 @@ bool uartOpen(uint8_t ch, uint32_t baud)
       uart_tbl[ch].p_huart->AdvancedInit.AdvFeatureInit = UART_ADVFEATURE_NO_INIT;
 
       qbufferCreate(&uart_tbl[ch].qbuffer, &uart_tbl[ch].rx_buf[0], UART_RX_BUF_LENGTH);
+      qbufferSetName(&uart_tbl[ch].qbuffer, "uart1 rx");
+      qbufferCreate(&uart_tbl[ch].qbuffer_tx, &uart_tbl[ch].tx_buf[0], UART_TX_BUF_LENGTH);
+      qbufferSetName(&uart_tbl[ch].qbuffer_tx, "uart1 tx");
+      uart_tbl[ch].tx_dma_len = 0;
 
       __HAL_RCC_DMAMUX1_CLK_ENABLE();
       __HAL_RCC_DMA1_CLK_ENABLE();
@@ -138,13 +170,23 @@ bool uartOpen(uint8_t ch, uint32_t baud)
         ret = true;
         uart_tbl[ch].is_open = true;
 
-        if(HAL_UART_Receive_DMA(uart_tbl[ch].p_huart, (uint8_t *)&uart_tbl[ch].rx_buf[0], UART_RX_BUF_LENGTH) != HAL_OK)
+        primask = __get_PRIMASK();
+        __disable_irq();
+        // IDLE, DMA HT/TC 에서 HAL_UARTEx_RxEventCallback() 이 호출된다.
+        if(HAL_UARTEx_ReceiveToIdle_DMA(uart_tbl[ch].p_huart, (uint8_t *)&uart_tbl[ch].rx_buf[0], UART_RX_BUF_LENGTH) != HAL_OK)
         {
           ret = false;
         }
+        // TX 완료 처리를 위해 USART 인터럽트를 켰으므로
+        // 수신 에러로 circular RX DMA 가 중단되지 않도록 에러 인터럽트는 끈다.
+        CLEAR_BIT(uart_tbl[ch].p_huart->Instance->CR1, USART_CR1_PEIE);
+        CLEAR_BIT(uart_tbl[ch].p_huart->Instance->CR3, USART_CR3_EIE);
 
         uart_tbl[ch].qbuffer.in  = uart_tbl[ch].qbuffer.len - ((DMA_Channel_TypeDef *)uart_tbl[ch].p_huart->hdmarx->Instance)->CNDTR;
         uart_tbl[ch].qbuffer.out = uart_tbl[ch].qbuffer.in;
+        uart_tbl[ch].rx_in_total  = 0;
+        uart_tbl[ch].rx_out_total = 0;
+        __set_PRIMASK(primask);
       }
       break;
 
@@ -158,6 +200,37 @@ bool uartOpen(uint8_t ch, uint32_t baud)
   return ret;
 }
 
+bool uartIsOpen(uint8_t ch)
+{
+  if (ch >= UART_MAX_CH) return false;
+
+  return uart_tbl[ch].is_open;
+}
+
+// 터미널이 실제로 붙어 있는지 본다. USB CDC 는 DTR 이 켜져 있어야 한다.
+bool uartIsConnected(uint8_t ch)
+{
+  bool ret = false;
+
+
+  if (ch >= UART_MAX_CH) return false;
+
+  switch(ch)
+  {
+    case _DEF_UART1:
+      ret = uart_tbl[ch].is_open;
+      break;
+
+    case _DEF_UART2:
+      #ifdef _USE_HW_USB
+      ret = uart_tbl[ch].is_open && cdcIsConnect();
+      #endif
+      break;
+  }
+
+  return ret;
+}
+
 bool uartClose(uint8_t ch)
 {
   if (ch >= UART_MAX_CH) return false;
@@ -175,8 +248,8 @@ uint32_t uartAvailable(uint8_t ch)
   switch(ch)
   {
     case _DEF_UART1:
-      uart_tbl[ch].qbuffer.in = (uart_tbl[ch].qbuffer.len - ((DMA_Channel_TypeDef *)uart_tbl[ch].p_hdma_rx->Instance)->CNDTR);
-      ret = qbufferAvailable(&uart_tbl[ch].qbuffer);      
+      uartCheckOverrun(ch);
+      ret = qbufferAvailable(&uart_tbl[ch].qbuffer);
       break;
 
     case _DEF_UART2:
@@ -207,40 +280,150 @@ bool uartFlush(uint8_t ch)
   return true;
 }
 
+static void uartUpdateRx(uint8_t ch)
+{
+  qbuffer_t *p_q = &uart_tbl[ch].qbuffer;
+  uint32_t   dma_in;
+  uint32_t   rx_len;
+
+
+  // DMA 가 쓴 만큼을 commit 으로 발행한다.
+  // RX 이벤트 인터럽트에서만 호출하므로 producer 는 하나이고 main 은 in 만 읽는다.
+  dma_in = p_q->len - ((DMA_Channel_TypeDef *)uart_tbl[ch].p_hdma_rx->Instance)->CNDTR;
+  rx_len = (p_q->len + dma_in - p_q->in) % p_q->len;
+  if (rx_len > 0)
+  {
+    qbufferCommit(p_q, rx_len);
+    uart_tbl[ch].rx_in_total += rx_len;
+  }
+}
+
+static void uartCheckOverrun(uint8_t ch)
+{
+  qbuffer_t *p_q = &uart_tbl[ch].qbuffer;
+  uint32_t   lost_len;
+  uint32_t   primask;
+
+
+  // HT/TC 이벤트로 누적 수신량은 정확하므로 읽지 않은 양이 링 크기 이상이면
+  // DMA 가 읽지 않은 데이터를 덮어쓴 것이다. 이 경우 남은 데이터는 모두 버린다.
+  primask = __get_PRIMASK();
+  __disable_irq();
+
+  lost_len = uart_tbl[ch].rx_in_total - uart_tbl[ch].rx_out_total;
+  if (lost_len >= p_q->len)
+  {
+    qbufferConsume(p_q, qbufferAvailable(p_q));
+    p_q->stat.drop_bytes += lost_len;
+    uart_tbl[ch].rx_out_total = uart_tbl[ch].rx_in_total;
+    uart_tbl[ch].rx_overrun_cnt++;
+  }
+
+  __set_PRIMASK(primask);
+}
+
 uint8_t uartRead(uint8_t ch)
 {
   uint8_t ret = 0;
 
+  uartReadBlock(ch, &ret, 1);
+
+  return ret;
+}
+
+uint32_t uartReadBlock(uint8_t ch, uint8_t *p_data, uint32_t length)
+{
+  uint32_t ret = 0;
+
 
   switch(ch)
   {
     case _DEF_UART1:
-      qbufferRead(&uart_tbl[ch].qbuffer, &ret, 1);
+      uartCheckOverrun(ch);
+      ret = qbufferAvailable(&uart_tbl[ch].qbuffer);
+      if (ret > length)
+      {
+        ret = length;
+      }
+      qbufferRead(&uart_tbl[ch].qbuffer, p_data, ret);
+      uart_tbl[ch].rx_out_total += ret;
       break;
 
     case _DEF_UART2:
       #ifdef _USE_HW_USB
-      ret = cdcRead();
+      ret = cdcReadBlock(p_data, length);
       #endif
       break;      
   }
-  uart_tbl[ch].rx_cnt++;
+  uart_tbl[ch].rx_cnt += ret;
 
   return ret;
 }
 
+bool uartPeekSpan(uint8_t ch, uint8_t **pp_data, uint32_t *p_length)
+{
+  uint32_t length = 0;
+
+
+  switch(ch)
+  {
+    case _DEF_UART1:
+      uartCheckOverrun(ch);
+      length = qbufferPeek(&uart_tbl[ch].qbuffer, pp_data, uart_tbl[ch].qbuffer.len);
+      break;
+
+    case _DEF_UART2:
+      #ifdef _USE_HW_USB
+      length = cdcPeekSpan(pp_data);
+      #endif
+      break;      
+  }
+  *p_length = length;
+
+  return length > 0 ? true:false;
+}
+
+bool uartConsume(uint8_t ch, uint32_t length)
+{
+  if (ch >= UART_MAX_CH) return false;
+
+  switch(ch)
+  {
+    case _DEF_UART1:
+      qbufferConsume(&uart_tbl[ch].qbuffer, length);
+      uart_tbl[ch].rx_out_total += length;
+      break;
+
+    case _DEF_UART2:
+      #ifdef _USE_HW_USB
+      cdcConsume(length);
+      #endif
+      break;      
+  }
+  uart_tbl[ch].rx_cnt += length;
+
+  return true;
+}
+
 uint32_t uartWrite(uint8_t ch, uint8_t *p_data, uint32_t length)
+{
+  if (ch >= UART_MAX_CH) return 0;
+
+  return uartWriteEx(ch, p_data, length, uart_tbl[ch].tx_policy);
+}
+
+// 채널에 설정된 정책 대신 이번 쓰기에만 policy 를 적용한다.
+uint32_t uartWriteEx(uint8_t ch, uint8_t *p_data, uint32_t length, uart_tx_policy_t policy)
 {
   uint32_t ret = 0;
 
 
+  if (ch >= UART_MAX_CH) return 0;
+
   switch(ch)
   {
     case _DEF_UART1:
-      if (HAL_UART_Transmit(uart_tbl[ch].p_huart, p_data, length, 100) == HAL_OK)
-      {
-        ret = length;
-      }
+      ret = uartWriteTx(ch, p_data, length, policy);
       break;
 
     case _DEF_UART2:
@@ -254,38 +437,183 @@ uint32_t uartWrite(uint8_t ch, uint8_t *p_data, uint32_t length)
   return ret;
 }
 
-uint32_t uartVPrintf(uint8_t ch, const char *fmt, va_list arg)
+bool uartSetTxPolicy(uint8_t ch, uart_tx_policy_t policy)
 {
-  uint32_t ret = 0;
-  char print_buf[256];
+  if (ch >= UART_MAX_CH) return false;
+
+  uart_tbl[ch].tx_policy = policy;
 
+  return true;
+}
+
+bool uartFlushTx(uint8_t ch)
+{
+  bool     ret = true;
+  uint32_t pre_time;
+  uint32_t pre_len;
+  uint32_t cur_len;
 
-  int len;
-  len = vsnprintf(print_buf, 256, fmt, arg);
 
-  if (len > 0)
+  if (ch >= UART_MAX_CH) return false;
+
+  switch(ch)
   {
-    ret = uartWrite(ch, (uint8_t *)print_buf, len);
+    case _DEF_UART1:
+      if (uart_tbl[ch].is_open != true)
+      {
+        break;
+      }
+
+      pre_time = millis();
+      pre_len  = qbufferAvailable(&uart_tbl[ch].qbuffer_tx);
+      while(uart_tbl[ch].tx_dma_len > 0 || qbufferAvailable(&uart_tbl[ch].qbuffer_tx) > 0)
+      {
+        uartStartTx(ch);
+
+        cur_len = qbufferAvailable(&uart_tbl[ch].qbuffer_tx);
+        if (cur_len != pre_len)
+        {
+          pre_len  = cur_len;
+          pre_time = millis();
+        }
+        if (millis()-pre_time >= UART_TX_TIMEOUT)
+        {
+          ret = false;
+          break;
+        }
+      }
+      break;
   }
 
   return ret;
 }
 
+static void uartStartTx(uint8_t ch)
+{
+  uart_tbl_t *p_uart = &uart_tbl[ch];
+  uint32_t    primask;
+  uint32_t    tx_len;
+  uint8_t    *p_tx_buf;
+
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+
+  if (p_uart->tx_dma_len == 0)
+  {
+    tx_len = qbufferPeek(&p_uart->qbuffer_tx, &p_tx_buf, p_uart->qbuffer_tx.len);
+    if (tx_len > 0)
+    {
+      p_uart->tx_dma_len = tx_len;
+      if (HAL_UART_Transmit_DMA(p_uart->p_huart, p_tx_buf, tx_len) != HAL_OK)
+      {
+        p_uart->tx_dma_len = 0;
+      }
+    }
+  }
+
+  __set_PRIMASK(primask);
+}
+
+static uint32_t uartWriteTx(uint8_t ch, uint8_t *p_data, uint32_t length, uart_tx_policy_t policy)
+{
+  uart_tbl_t      *p_uart = &uart_tbl[ch];
+  qbuffer_t       *p_q    = &p_uart->qbuffer_tx;
+  uint32_t         sent_len = 0;
+  uint32_t         wr_len;
+  uint32_t         free_len;
+  uint32_t         primask;
+  uint32_t         pre_time;
+
+
+  if (p_uart->is_open != true) return 0;
+
+  // 인터럽트 안이나 인터럽트가 막힌 상태에서는 기다려도 비워지지 않는다.
+  if (policy == UART_TX_POLICY_BLOCK && (__get_IPSR() != 0 || __get_PRIMASK() != 0))
+  {
+    policy = UART_TX_POLICY_TRUNCATE;
+  }
+
+  pre_time = millis();
+  while(sent_len < length)
+  {
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    free_len = p_q->len - qbufferAvailable(p_q) - 1;
+    wr_len   = length - sent_len;
+
+    if (policy == UART_TX_POLICY_DROP && wr_len > free_len)
+    {
+      wr_len = 0;
+    }
+    if (wr_len > free_len)
+    {
+      wr_len = free_len;
+    }
+    if (wr_len > 0)
+    {
+      qbufferWrite(p_q, &p_data[sent_len], wr_len);
+      sent_len += wr_len;
+    }
+
+    __set_PRIMASK(primask);
+
+    uartStartTx(ch);
+
+    if (policy != UART_TX_POLICY_BLOCK)
+    {
+      break;
+    }
+    if (wr_len > 0)
+    {
+      pre_time = millis();
+    }
+    else if (millis()-pre_time >= UART_TX_TIMEOUT)
+    {
+      break;
+    }
+  }
+
+  p_q->stat.drop_bytes += (length - sent_len);
+
+  return sent_len;
+}
+
+typedef struct
+{
+  uint8_t  ch;
+  uint32_t sent_len;
+} uart_print_t;
+
+static void uartPrintOut(void *p_arg, const uint8_t *p_data, uint32_t length)
+{
+  uart_print_t *p_print = (uart_print_t *)p_arg;
+
+  p_print->sent_len += uartWrite(p_print->ch, (uint8_t *)p_data, length);
+}
+
+uint32_t uartVPrintf(uint8_t ch, const char *fmt, va_list arg)
+{
+  uart_print_t print;
+
+
+  print.ch       = ch;
+  print.sent_len = 0;
+  printFormat(uartPrintOut, &print, fmt, arg);
+
+  return print.sent_len;
+}
+
 uint32_t uartPrintf(uint8_t ch, const char *fmt, ...)
 {
-  char buf[256];
   va_list args;
-  int len;
   uint32_t ret;
 
   va_start(args, fmt);
-  len = vsnprintf(buf, 256, fmt, args);
-
-  ret = uartWrite(ch, (uint8_t *)buf, len);
-
+  ret = uartVPrintf(ch, fmt, args);
   va_end(args);
 
-
   return ret;
 }
 
@@ -322,6 +650,44 @@ uint32_t uartGetTxCnt(uint8_t ch)
   return uart_tbl[ch].tx_cnt;
 }
 
+uint32_t uartGetRxOverrun(uint8_t ch)
+{
+  if (ch >= UART_MAX_CH) return 0;
+
+  return uart_tbl[ch].rx_overrun_cnt;
+}
+
+bool uartAttachRxEvent(uint8_t ch, void (*p_func)(uint8_t ch, uint32_t event))
+{
+  if (ch >= UART_MAX_CH) return false;
+
+  #ifdef _USE_HW_USB
+  // USB CDC 는 OUT 패킷을 받을 때마다 알려준다.
+  if (ch == HW_UART_CH_USB)
+  {
+    uart_tbl[ch].rx_event_func = p_func;
+    return cdcAttachRxEvent(uartCdcRxEvent);
+  }
+  #endif
+
+  // RX 이벤트는 DMA 로 받는 채널만 지원한다.
+  if (uart_hw_tbl[ch].p_hdma_rx == NULL) return false;
+
+  uart_tbl[ch].rx_event_func = p_func;
+
+  return true;
+}
+
+#ifdef _USE_HW_USB
+void uartCdcRxEvent(void)
+{
+  if (uart_tbl[HW_UART_CH_USB].rx_event_func != NULL)
+  {
+    uart_tbl[HW_UART_CH_USB].rx_event_func(HW_UART_CH_USB, UART_RX_EVENT_IDLE);
+  }
+}
+#endif
+
 void HAL_UART_MspInit(UART_HandleTypeDef *uartHandle)
 {
   GPIO_InitTypeDef         GPIO_InitStruct     = {0};
@@ -370,6 +736,30 @@ void HAL_UART_MspInit(UART_HandleTypeDef *uartHandle)
     }
 
     __HAL_LINKDMA(uartHandle, hdmarx, hdma_usart1_rx);
+
+    /* USART1_TX Init */
+    hdma_usart1_tx.Instance                 = DMA1_Channel2;
+    hdma_usart1_tx.Init.Request             = DMA_REQUEST_USART1_TX;
+    hdma_usart1_tx.Init.Direction           = DMA_MEMORY_TO_PERIPH;
+    hdma_usart1_tx.Init.PeriphInc           = DMA_PINC_DISABLE;
+    hdma_usart1_tx.Init.MemInc              = DMA_MINC_ENABLE;
+    hdma_usart1_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    hdma_usart1_tx.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+    hdma_usart1_tx.Init.Mode                = DMA_NORMAL;
+    hdma_usart1_tx.Init.Priority            = DMA_PRIORITY_LOW;
+    if (HAL_DMA_Init(&hdma_usart1_tx) != HAL_OK)
+    {
+      Error_Handler();
+    }
+
+    __HAL_LINKDMA(uartHandle, hdmatx, hdma_usart1_tx);
+
+    HAL_NVIC_SetPriority(DMA1_Channel1_IRQn, 5, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Channel1_IRQn);
+    HAL_NVIC_SetPriority(DMA1_Channel2_IRQn, 5, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Channel2_IRQn);
+    HAL_NVIC_SetPriority(USART1_IRQn, 5, 0);
+    HAL_NVIC_EnableIRQ(USART1_IRQn);
   }
 }
 
@@ -391,12 +781,97 @@ void HAL_UART_MspDeInit(UART_HandleTypeDef* uartHandle)
 
     /* USART1 DMA DeInit */
     HAL_DMA_DeInit(uartHandle->hdmarx);
+    HAL_DMA_DeInit(uartHandle->hdmatx);
+
+    HAL_NVIC_DisableIRQ(DMA1_Channel1_IRQn);
+    HAL_NVIC_DisableIRQ(DMA1_Channel2_IRQn);
+    HAL_NVIC_DisableIRQ(USART1_IRQn);
     /* USER CODE BEGIN USART1_MspDeInit 1 */
 
     /* USER CODE END USART1_MspDeInit 1 */
   }
 }
 
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+  for (int i=0; i<UART_MAX_CH; i++)
+  {
+    if (uart_tbl[i].p_huart == huart && uart_tbl[i].tx_dma_len > 0)
+    {
+      qbufferConsume(&uart_tbl[i].qbuffer_tx, uart_tbl[i].tx_dma_len);
+      uart_tbl[i].tx_dma_len = 0;
+      uartStartTx(i);
+    }
+  }
+}
+
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+  for (int i=0; i<UART_MAX_CH; i++)
+  {
+    // TX DMA 에러면 전송 중이던 구간은 버리고 다음 구간을 시작한다.
+    if (uart_tbl[i].p_huart == huart && uart_tbl[i].tx_dma_len > 0 && huart->gState == HAL_UART_STATE_READY)
+    {
+      qbufferConsume(&uart_tbl[i].qbuffer_tx, uart_tbl[i].tx_dma_len);
+      uart_tbl[i].qbuffer_tx.stat.drop_bytes += uart_tbl[i].tx_dma_len;
+      uart_tbl[i].tx_dma_len = 0;
+      uartStartTx(i);
+    }
+  }
+}
+
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
+{
+  for (int i=0; i<UART_MAX_CH; i++)
+  {
+    if (uart_tbl[i].p_huart == huart && uart_tbl[i].is_open == true)
+    {
+      uint32_t event;
+
+      uartUpdateRx(i);
+
+      switch(HAL_UARTEx_GetRxEventType(huart))
+      {
+        case HAL_UART_RXEVENT_HT:
+          event = UART_RX_EVENT_HALF;
+          break;
+
+        case HAL_UART_RXEVENT_TC:
+          event = UART_RX_EVENT_FULL;
+          break;
+
+        default:
+          event = UART_RX_EVENT_IDLE;
+          break;
+      }
+      if (uart_tbl[i].rx_in_total - uart_tbl[i].rx_out_total >= uart_tbl[i].qbuffer.len)
+      {
+        event |= UART_RX_EVENT_OVERRUN;
+      }
+
+      if (uart_tbl[i].rx_event_func != NULL)
+      {
+        uart_tbl[i].rx_event_func(i, event);
+      }
+    }
+  }
+}
+
+void DMA1_Channel1_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&hdma_usart1_rx);
+}
+
+void DMA1_Channel2_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&hdma_usart1_tx);
+}
+
+void USART1_IRQHandler(void)
+{
+  HAL_UART_IRQHandler(&huart1);
+}
+
 #if CLI_USE(HW_UART)
 void cliUart(cli_args_t *args)
 {
@@ -407,7 +882,7 @@ void cliUart(cli_args_t *args)
   {
     for (int i=0; i<UART_MAX_CH; i++)
     {
-      cliPrintf("_DEF_UART%d : %s, %d bps\n", i+1, uart_hw_tbl[i].p_msg, uartGetBaud(i));
+      cliPrintf("_DEF_UART%d : %s, %d bps, overrun %d\n", i+1, uart_hw_tbl[i].p_msg, uartGetBaud(i), uartGetRxOverrun(i));
     }
     ret = true;
   }
@@ -452,10 +927,100 @@ void cliUart(cli_args_t *args)
     ret = true;
   }
 
+  if (args->argc >= 3 && args->isStr(0, "speed-test"))
+  {
+    uint8_t  uart_ch;
+    uint8_t  mode = 0;
+    uint32_t baud;
+    uint32_t pre_baud;
+    uint32_t pre_time;
+    uint32_t pre_cycles;
+    uint32_t rx_cycles = 0;
+    uint32_t rx_bytes  = 0;
+    uint32_t rx_sum    = 0;
+    uint8_t  rx_buf[128];
+
+    uart_ch  = constrain(args->getData(1), 1, UART_MAX_CH) - 1;
+    pre_baud = uartGetBaud(uart_ch);
+    baud     = pre_baud;
+
+    if (args->isStr(2, "block")) mode = 1;
+    if (args->isStr(2, "span"))  mode = 2;
+    if (args->argc == 4 && uart_ch != HW_UART_CH_USB)
+    {
+      baud = args->getData(3);
+    }
+
+    cliPrintf("send data to _DEF_UART%d at %d bps for 5 sec\n", uart_ch + 1, baud);
+    uartFlushTx(cliGetPort());
+    if (baud != pre_baud)
+    {
+      uartOpen(uart_ch, baud);
+    }
+    uartFlush(uart_ch);
+
+    pre_time = millis();
+    while(millis()-pre_time < 5000)
+    {
+      pre_cycles = cycles();
+      if (mode == 0)
+      {
+        while(uartAvailable(uart_ch) > 0)
+        {
+          rx_sum += uartRead(uart_ch);
+          rx_bytes++;
+        }
+      }
+      else if (mode == 1)
+      {
+        uint32_t rx_len;
+
+        rx_len = uartReadBlock(uart_ch, rx_buf, sizeof(rx_buf));
+        for (int i=0; i<rx_len; i++)
+        {
+          rx_sum += rx_buf[i];
+        }
+        rx_bytes += rx_len;
+      }
+      else
+      {
+        uint8_t *p_data;
+        uint32_t rx_len;
+
+        if (uartPeekSpan(uart_ch, &p_data, &rx_len) == true)
+        {
+          for (int i=0; i<rx_len; i++)
+          {
+            rx_sum += p_data[i];
+          }
+          uartConsume(uart_ch, rx_len);
+          rx_bytes += rx_len;
+        }
+      }
+      rx_cycles += cycles() - pre_cycles;
+    }
+
+    if (baud != pre_baud)
+    {
+      uartOpen(uart_ch, pre_baud);
+    }
+    uartFlush(uart_ch);
+
+    cliPrintf("rx bytes   : %d\n", rx_bytes);
+    cliPrintf("rx speed   : %d KB/s\n", rx_bytes / 5 / 1024);
+    cliPrintf("rx sum     : 0x%X\n", rx_sum);
+    if (rx_bytes > 0)
+    {
+      cliPrintf("cycle/byte : %d\n", (int)(rx_cycles / rx_bytes));
+    }
+    ret = true;
+  }
+
   if (ret == false)
   {
     cliPrintf("uart info\n");
     cliPrintf("uart test ch[1~%d]\n", HW_UART_MAX_CH);
+    cliPrintf("uart speed-test ch[1~%d] byte:block:span [baud]\n", HW_UART_MAX_CH);
   }
 }
 #endif
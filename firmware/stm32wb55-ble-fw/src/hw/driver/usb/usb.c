@@ -12,7 +12,9 @@
 
 #ifdef _USE_HW_USB
 #include "cdc.h"
+#include "log.h"
 #include "cli.h"
+#include "prof.h"
 
 static bool is_init = false;
 static UsbMode_t is_usb_mode = USB_NON_MODE;
@@ -62,8 +64,8 @@ bool usbBegin(UsbMode_t usb_mode)
 
     is_usb_mode = USB_CDC_MODE;
     
-    logPrintf("[OK] usbBegin()\n");
-    logPrintf("     USB_CDC\r\n");
+    logI(USB, "[OK] usbBegin()\n");
+    logI(USB, "     USB_CDC\r\n");
   }
   else if (usb_mode == USB_MSC_MODE)
   {
@@ -84,15 +86,15 @@ bool usbBegin(UsbMode_t usb_mode)
 
     is_usb_mode = USB_MSC_MODE;
 
-    logPrintf("[OK] usbBegin()\n");
-    logPrintf("     USB_MSC\r\n");
+    logI(USB, "[OK] usbBegin()\n");
+    logI(USB, "     USB_MSC\r\n");
     #endif
   }
   else
   {
     is_init = false;
 
-    logPrintf("[NG] usbBegin()\n");
+    logE(USB, "[NG] usbBegin()\n");
   }
 
   return is_init;
@@ -145,7 +147,9 @@ UsbType_t usbGetType(void)
 
 void USB_LP_IRQHandler(void)
 {
+  PROF_ISR_BEGIN();
   HAL_PCD_IRQHandler(&hpcd_USB_FS);
+  PROF_ISR_END(PROF_ISR_USB);
 }
 
 
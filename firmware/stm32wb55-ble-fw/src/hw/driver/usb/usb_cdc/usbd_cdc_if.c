@@ -40,20 +40,22 @@ USBD_CDC_LineCodingTypeDef LineCoding =
 
 
 uint8_t CDC_Reset_Status = 0;
-uint8_t UserRxBufferFS[APP_RX_DATA_SIZE];
-uint8_t UserTxBufferFS[APP_TX_DATA_SIZE];
 
 
 
 static qbuffer_t q_rx;
 static qbuffer_t q_tx;
 
-static uint8_t q_rx_buf[2048];
+// USB OUT 패킷을 q_rx 에 직접 받기 위해 링 끝에 패킷 하나 크기의 여유를 둔다.
+static uint8_t q_rx_buf[2048 + CDC_DATA_FS_MAX_PACKET_SIZE];
 static uint8_t q_tx_buf[2048];
+static uint8_t rx_spare_buf[CDC_DATA_FS_MAX_PACKET_SIZE];
 
 static bool is_opened = false;
 static bool is_rx_full = false;
+static uint32_t tx_busy_len = 0;   // q_tx 에서 전송 중인 길이, 완료되면 consume 한다.
 static uint8_t cdc_type = 0;
+static void  (*rx_event_func)(void) = NULL;
 
 extern USBD_HandleTypeDef USBD_Device;
 
@@ -63,6 +65,8 @@ static int8_t CDC_DeInit_FS(void);
 static int8_t CDC_Control_FS(uint8_t cmd, uint8_t* pbuf, uint16_t length);
 static int8_t CDC_Receive_FS(uint8_t* pbuf, uint32_t *Len);
 static int8_t CDC_TransmitCplt_FS(uint8_t *pbuf, uint32_t *Len, uint8_t epnum);
+static bool   cdcIfReceiveNext(void);
+static void   cdcIfDropTxBusy(void);
 
 
 
@@ -84,6 +88,8 @@ bool cdcIfInit(void)
   is_opened = false;
   qbufferCreate(&q_rx, q_rx_buf, 2048);
   qbufferCreate(&q_tx, q_tx_buf, 2048);
+  qbufferSetName(&q_rx, "cdc rx");
+  qbufferSetName(&q_tx, "cdc tx");
 
   return true;
 }
@@ -102,6 +108,37 @@ uint8_t cdcIfRead(void)
   return ret;
 }
 
+uint32_t cdcIfReadBlock(uint8_t *p_data, uint32_t length)
+{
+  uint32_t rx_len;
+
+  rx_len = qbufferAvailable(&q_rx);
+  if (rx_len > length)
+  {
+    rx_len = length;
+  }
+  qbufferRead(&q_rx, p_data, rx_len);
+
+  return rx_len;
+}
+
+uint32_t cdcIfPeekSpan(uint8_t **pp_data)
+{
+  return qbufferPeek(&q_rx, pp_data, q_rx.len);
+}
+
+void cdcIfConsume(uint32_t length)
+{
+  qbufferConsume(&q_rx, length);
+}
+
+// OUT 패킷이 q_rx 에 들어올 때마다 USB 인터럽트 안에서 불린다.
+bool cdcIfAttachRxEvent(void (*p_func)(void))
+{
+  rx_event_func = p_func;
+  return true;
+}
+
 uint32_t cdcIfWrite(uint8_t *p_data, uint32_t length)
 {
   uint32_t pre_time;
@@ -148,6 +185,9 @@ uint32_t cdcIfWrite(uint8_t *p_data, uint32_t length)
     }
   }
 
+  // timeout 으로 보내지 못한 데이터도 drop 으로 기록한다.
+  q_tx.stat.drop_bytes += (length - sent_len);
+
   return sent_len;
 }
 
@@ -194,14 +234,8 @@ uint8_t CDC_SoF_ISR(struct _USBD_HandleTypeDef *pdev)
   //
   if (is_rx_full)
   {
-    uint32_t buf_len;
-
-    buf_len = (q_rx.len - qbufferAvailable(&q_rx)) - 1;
-
-    if (buf_len >= CDC_DATA_FS_MAX_PACKET_SIZE)
+    if (cdcIfReceiveNext() == true)
     {
-      USBD_CDC_SetRxBuffer(&USBD_Device, &UserRxBufferFS[0]);
-      USBD_CDC_ReceivePacket(&USBD_Device);
       is_rx_full = false;
     }
   }
@@ -209,25 +243,28 @@ uint8_t CDC_SoF_ISR(struct _USBD_HandleTypeDef *pdev)
 
   //-- TX
   //
-  uint32_t tx_len;
-  tx_len = qbufferAvailable(&q_tx);
-
-  if (tx_len%CDC_DATA_FS_MAX_PACKET_SIZE == 0)
+  // q_tx 를 그대로 전송하고 전송 완료(CDC_TransmitCplt_FS)에서 consume 한다.
+  //
+  USBD_CDC_HandleTypeDef *hcdc = (USBD_CDC_HandleTypeDef*)USBD_Device.pClassData;
+  if (hcdc->TxState == 0)
   {
-    if (tx_len > 0)
+    uint32_t tx_len;
+    uint8_t *p_tx_buf;
+
+    tx_len = qbufferPeek(&q_tx, &p_tx_buf, q_tx.len);
+
+    if (tx_len%CDC_DATA_FS_MAX_PACKET_SIZE == 0)
     {
-      tx_len = tx_len - 1;
+      if (tx_len > 0)
+      {
+        tx_len = tx_len - 1;
+      }
     }
-  }
 
-  if (tx_len > 0)
-  {
-    USBD_CDC_HandleTypeDef *hcdc = (USBD_CDC_HandleTypeDef*)USBD_Device.pClassData;
-    if (hcdc->TxState == 0)
+    if (tx_len > 0)
     {
-      qbufferRead(&q_tx, UserTxBufferFS, tx_len);
-
-      USBD_CDC_SetTxBuffer(&USBD_Device, UserTxBufferFS, tx_len);
+      tx_busy_len = tx_len;
+      USBD_CDC_SetTxBuffer(&USBD_Device, p_tx_buf, tx_len);
       USBD_CDC_TransmitPacket(&USBD_Device);
     }
   }
@@ -235,6 +272,35 @@ uint8_t CDC_SoF_ISR(struct _USBD_HandleTypeDef *pdev)
   return 0;
 }
 
+// 전송 중에 USB reset/DeInit 이 오면 완료가 오지 않으므로 그 구간을 버린다.
+// 남겨 두면 다시 연결된 뒤 같은 데이터를 한 번 더 보낸다.
+static void cdcIfDropTxBusy(void)
+{
+  if (tx_busy_len > 0)
+  {
+    qbufferConsume(&q_tx, tx_busy_len);
+    q_tx.stat.drop_bytes += tx_busy_len;
+    tx_busy_len = 0;
+  }
+}
+
+static bool cdcIfReceiveNext(void)
+{
+  qbuffer_span_t span;
+
+
+  qbufferAvailableSpan(&q_rx, &span);
+  if (span.free < CDC_DATA_FS_MAX_PACKET_SIZE)
+  {
+    return false;
+  }
+
+  USBD_CDC_SetRxBuffer(&USBD_Device, qbufferPeekWrite(&q_rx));
+  USBD_CDC_ReceivePacket(&USBD_Device);
+
+  return true;
+}
+
 
 
 
@@ -245,9 +311,23 @@ uint8_t CDC_SoF_ISR(struct _USBD_HandleTypeDef *pdev)
   */
 static int8_t CDC_Init_FS(void)
 {
+  qbuffer_span_t span;
+
+
+  cdcIfDropTxBusy();
+
   /* Set Application Buffers */
-  USBD_CDC_SetTxBuffer(&USBD_Device, UserTxBufferFS, 0);
-  USBD_CDC_SetRxBuffer(&USBD_Device, UserRxBufferFS);
+  USBD_CDC_SetTxBuffer(&USBD_Device, q_tx_buf, 0);
+
+  qbufferAvailableSpan(&q_rx, &span);
+  if (span.free >= CDC_DATA_FS_MAX_PACKET_SIZE)
+  {
+    USBD_CDC_SetRxBuffer(&USBD_Device, qbufferPeekWrite(&q_rx));
+  }
+  else
+  {
+    USBD_CDC_SetRxBuffer(&USBD_Device, rx_spare_buf);
+  }
 
   is_opened = false;
 
@@ -260,6 +340,7 @@ static int8_t CDC_Init_FS(void)
   */
 static int8_t CDC_DeInit_FS(void)
 {
+  cdcIfDropTxBusy();
 
   is_opened = false;
 
@@ -396,7 +477,21 @@ static int8_t CDC_Receive_FS(uint8_t* Buf, uint32_t *Len)
   uint32_t i;
 
 
-  qbufferWrite(&q_rx, Buf, *Len);
+  if (Buf == qbufferPeekWrite(&q_rx))
+  {
+    uint32_t end_len = q_rx.in + *Len;
+
+    // 링 끝을 넘어 여유 영역에 들어온 부분은 링 앞쪽으로 옮긴다.
+    if (end_len > q_rx.len)
+    {
+      memcpy(&q_rx_buf[0], &q_rx_buf[q_rx.len], end_len - q_rx.len);
+    }
+    qbufferCommit(&q_rx, *Len);
+  }
+  else
+  {
+    qbufferWrite(&q_rx, Buf, *Len);
+  }
 
   if( CDC_Reset_Status == 1 )
   {
@@ -416,18 +511,14 @@ static int8_t CDC_Receive_FS(uint8_t* Buf, uint32_t *Len)
     }
   }
 
-  uint32_t buf_len;
-
-  buf_len = (q_rx.len - qbufferAvailable(&q_rx)) - 1;
-
-  if (buf_len >= CDC_DATA_FS_MAX_PACKET_SIZE)
+  if (cdcIfReceiveNext() != true)
   {
-    USBD_CDC_SetRxBuffer(&USBD_Device, &Buf[0]);
-    USBD_CDC_ReceivePacket(&USBD_Device);
+    is_rx_full = true;
   }
-  else
+
+  if (rx_event_func != NULL)
   {
-    is_rx_full = true;
+    rx_event_func();
   }
 
   return (USBD_OK);
@@ -474,9 +565,13 @@ static int8_t CDC_TransmitCplt_FS(uint8_t *Buf, uint32_t *Len, uint8_t epnum)
 {
   uint8_t result = USBD_OK;
   /* USER CODE BEGIN 13 */
-  UNUSED(Buf);
-  UNUSED(Len);
   UNUSED(epnum);
+
+  if (Buf >= &q_tx_buf[0] && Buf < &q_tx_buf[sizeof(q_tx_buf)])
+  {
+    qbufferConsume(&q_tx, *Len);
+    tx_busy_len = 0;
+  }
   /* USER CODE END 13 */
   return result;
 }
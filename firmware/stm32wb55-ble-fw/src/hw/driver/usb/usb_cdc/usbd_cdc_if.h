@@ -111,10 +111,14 @@ extern USBD_CDC_ItfTypeDef USBD_CDC_fops;
 bool     cdcIfInit(void);
 uint32_t cdcIfAvailable(void);
 uint8_t  cdcIfRead(void);
+uint32_t cdcIfReadBlock(uint8_t *p_data, uint32_t length);
+uint32_t cdcIfPeekSpan(uint8_t **pp_data);
+void     cdcIfConsume(uint32_t length);
 uint32_t cdcIfGetBaud(void);
 uint32_t cdcIfWrite(uint8_t *p_data, uint32_t length);
 bool     cdcIfIsConnected(void);
 uint8_t  cdcIfGetType(void);
+bool     cdcIfAttachRxEvent(void (*p_func)(void));
 
 
 /**
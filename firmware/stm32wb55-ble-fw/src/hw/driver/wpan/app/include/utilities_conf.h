@@ -28,6 +28,7 @@ extern "C" {
 
 #include "cmsis_compiler.h"
 #include "string.h"
+#include "prof.h"
 
 /******************************************************************************
  * common
@@ -57,6 +58,8 @@ extern "C" {
 #define UTIL_SEQ_CONF_TASK_NBR                  (32)
 #define UTIL_SEQ_CONF_PRIO_NBR                  (2)
 #define UTIL_SEQ_MEMSET8( dest, value, size )   UTILS_MEMSET8( dest, value, size )
+#define UTIL_SEQ_TASK_BEGIN( )                  PROF_TASK_BEGIN( )
+#define UTIL_SEQ_TASK_END( task_idx )           PROF_TASK_END( task_idx )
 
 #ifdef __cplusplus
 }
@@ -628,7 +628,7 @@ typedef enum
 
 /* USER CODE BEGIN Defines */
 #undef  APP_DBG_MSG
-#define APP_DBG_MSG printf
+#define APP_DBG_MSG(...)  logD(BLE, __VA_ARGS__)
 /* USER CODE END Defines */
 
 /******************************************************************************
@@ -660,6 +660,7 @@ typedef enum
   CFG_FIRST_TASK_ID_WITH_NO_HCICMD = CFG_LAST_TASK_ID_WITH_HCICMD - 1,        /**< Shall be FIRST in the list */
   CFG_TASK_SYSTEM_HCI_ASYNCH_EVT_ID,
   /* USER CODE BEGIN CFG_Task_Id_With_NO_HCI_Cmd_t */
+  CFG_TASK_LOG_ID,
 
   /* USER CODE END CFG_Task_Id_With_NO_HCI_Cmd_t */
   CFG_LAST_TASK_ID_WITH_NO_HCICMD                                            /**< Shall be LAST in the list */
@@ -675,6 +676,7 @@ typedef enum
 {
   CFG_SCH_PRIO_0,
   /* USER CODE BEGIN CFG_SCH_Prio_Id_t */
+  CFG_SCH_PRIO_1,
 
   /* USER CODE END CFG_SCH_Prio_Id_t */
 } CFG_SCH_Prio_Id_t;
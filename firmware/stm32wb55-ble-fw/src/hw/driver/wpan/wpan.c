@@ -10,6 +10,7 @@
 #include "ipcc.h"
 #include "rf.h"
 #include "rtc_stm.h"
+#include "prof.h"
 
 
 
@@ -43,12 +44,16 @@ void RTC_WKUP_IRQHandler(void)
 
 void IPCC_C1_RX_IRQHandler(void)
 {
+  PROF_ISR_BEGIN();
   HAL_IPCC_RX_IRQHandler(&hipcc);
+  PROF_ISR_END(PROF_ISR_IPCC);
 }
 
 void IPCC_C1_TX_IRQHandler(void)
 {
+  PROF_ISR_BEGIN();
   HAL_IPCC_TX_IRQHandler(&hipcc);
+  PROF_ISR_END(PROF_ISR_IPCC);
 }
 
 void HSEM_IRQHandler(void)
@@ -26,6 +26,17 @@ bool hwInit(void)
   #ifdef _USE_HW_CLI
   cliInit();
   #endif
+  #ifdef _USE_HW_CLI_GUI
+  cliGuiInit();
+  #endif
+  #ifdef _USE_HW_PROF
+  profInit();
+  #endif
+  qbufferInit();
+  #if CLI_USE(HW_QBUFFER)
+  cliQbufferInit();
+  #endif
+  printInit();
   logInit();
   ledInit();
   uartInit();
@@ -51,6 +62,9 @@ bool hwInit(void)
   qspiInit();
   flashInit();
   fsInit();
+  #ifdef _USE_HW_CLI_RUN
+  cliRunInit();
+  #endif
   nvsInit();
 
 
@@ -60,5 +74,7 @@ bool hwInit(void)
     
   wpanInit();
 
+  logBoot(false);
+
   return true;
 }
\ No newline at end of file
@@ -7,11 +7,16 @@ extern "C" {
 
 #include "hw_def.h"
 
+#include "qbuffer.h"
+#include "print.h"
 #include "led.h"
 #include "uart.h"
 #include "log.h"
 #include "cli.h"
 #include "cli_gui.h"
+#include "cli_run.h"
+#include "cli_qbuffer.h"
+#include "prof.h"
 #include "flash.h"
 #include "i2c.h"
 #include "eeprom.h"
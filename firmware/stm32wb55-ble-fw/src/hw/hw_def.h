@@ -28,12 +28,37 @@
 
 #define _USE_HW_LOG
 #define      HW_LOG_CH              HW_UART_CH_SWD
+#define      HW_LOG_LIST_BUF_MAX    4096
+#ifndef      HW_LOG_LEVEL
+#define      HW_LOG_LEVEL_BLE       LOG_LEVEL_DEBUG
+#endif
 
 #define _USE_HW_CLI
 #define      HW_CLI_CMD_LIST_MAX    32
+#define      HW_CLI_CMD_HASH_MAX    128
 #define      HW_CLI_CMD_NAME_MAX    16
 #define      HW_CLI_LINE_HIS_MAX    8
 #define      HW_CLI_LINE_BUF_MAX    64
+#define      HW_CLI_SESSION_MAX     2
+#define      HW_CLI_STAT_MAX        32
+
+#define _USE_HW_CLI_BIN
+#define      HW_CLI_BIN_DATA_MAX    256
+#define      HW_CLI_BIN_CMD_MAX     16
+
+#define _USE_HW_CLI_GUI
+#define      HW_CLI_GUI_WIDTH       80
+#define      HW_CLI_GUI_HEIGHT      24
+#define      HW_CLI_GUI_FLUSH_MAX   512
+#define      HW_CLI_GUI_FRAME       1             // frame buffer 2개, 80x24 에서 11.5KB
+
+#define _USE_HW_CLI_RUN
+#define      HW_CLI_RUN_VAR_MAX     8
+#define      HW_CLI_RUN_LOOP_MAX    4
+#define      HW_CLI_RUN_BOOT_FILE   "boot.run"
+
+#define _USE_HW_PROF
+#define      HW_PROF_SEQ_MAX        32
 
 #define _USE_HW_I2C
 #define      HW_I2C_MAX_CH          1
@@ -73,6 +98,13 @@
 #define _USE_CLI_HW_FS              1
 #define _USE_CLI_HW_UART            1
 #define _USE_CLI_HW_USB             1
+#define _USE_CLI_HW_QBUFFER         1
+#define _USE_CLI_HW_LOG             1
+#define _USE_CLI_HW_PRINT           1
+#define _USE_CLI_HW_CLI             1
+#define _USE_CLI_HW_CLI_RUN         1
+#define _USE_CLI_HW_CLI_GUI         1
+#define _USE_CLI_HW_PROF            1
 
 
 #endif
\ No newline at end of file
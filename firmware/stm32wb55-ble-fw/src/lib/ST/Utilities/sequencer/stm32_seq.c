@@ -68,6 +68,18 @@ typedef struct
   #define UTIL_SEQ_EXIT_CRITICAL_SECTION_IDLE( )     UTIL_SEQ_EXIT_CRITICAL_SECTION( )
 #endif
 
+/**
+ * @brief macros called around each task execution (e.g. for profiling)
+ * @note  UTIL_SEQ_TASK_BEGIN may declare local variables used by UTIL_SEQ_TASK_END
+ */
+#ifndef UTIL_SEQ_TASK_BEGIN
+  #define UTIL_SEQ_TASK_BEGIN( )
+#endif
+
+#ifndef UTIL_SEQ_TASK_END
+  #define UTIL_SEQ_TASK_END( task_idx )
+#endif
+
 /**
  * @brief define to represent no task running
  */
@@ -287,7 +299,11 @@ void UTIL_SEQ_Run( UTIL_SEQ_bm_t Mask_bm )
     UTIL_SEQ_EXIT_CRITICAL_SECTION( );
 
     /* Execute the task */
-    TaskCb[CurrentTaskIdx]( );
+    {
+      UTIL_SEQ_TASK_BEGIN( );
+      TaskCb[CurrentTaskIdx]( );
+      UTIL_SEQ_TASK_END( CurrentTaskIdx );
+    }
 
     local_taskset = TaskSet;
     local_evtset = EvtSet;
@@ -0,0 +1,357 @@
+#!/usr/bin/env python3
+#
+# cli_bin.py
+#
+#   Host client for the framed binary command channel (cli_bin.c).
+#   Frames share the text CLI port : 0x00 [COBS(packet)] 0x00
+#
+#     req  : seq:1 cmd:2 data:n crc16:2
+#     resp : seq:1 cmd:2 status:1 data:n crc16:2
+#
+#   usage : cli_bin.py --port /dev/ttyUSB0 ping [count] [--window N]
+#           cli_bin.py --port /dev/ttyUSB0 info
+#           cli_bin.py --port /dev/ttyUSB0 list
+#           cli_bin.py --port /dev/ttyUSB0 qspi-read addr length
+#           cli_bin.py selftest [--host build_host/stm32wb55-ble-host]
+#
+#   selftest runs the host build of the firmware and talks to it over its pty, so the
+#   COBS/CRC decoder and the handlers in cli_bin.c and qspi.c answer the requests.
+#
+
+import argparse
+import os
+import re
+import struct
+import subprocess
+import sys
+import time
+
+
+CMD_PING      = 0x0000
+CMD_INFO      = 0x0001
+CMD_LIST      = 0x0002
+CMD_QSPI_READ = 0x0100
+
+STATUS_STR = ['ok', 'crc error', 'unknown cmd', 'length error', 'param error', 'fail']
+
+
+def crc16(data, crc=0):
+  # poly 0x8005, init 0, no reflection (utilUpdateCrc)
+  for b in data:
+    crc ^= b << 8
+    for _ in range(8):
+      crc = ((crc << 1) ^ 0x8005) if (crc & 0x8000) else (crc << 1)
+      crc &= 0xFFFF
+  return crc
+
+
+def cobs_encode(data):
+  out  = bytearray([0])
+  code_i = 0
+  code = 1
+  for b in data:
+    if b == 0:
+      out[code_i] = code
+      code_i = len(out)
+      out.append(0)
+      code = 1
+    else:
+      out.append(b)
+      code += 1
+      if code == 0xFF:
+        out[code_i] = code
+        code_i = len(out)
+        out.append(0)
+        code = 1
+  out[code_i] = code
+  return bytes(out)
+
+
+def cobs_decode(data):
+  out = bytearray()
+  i = 0
+  while i < len(data):
+    code = data[i]
+    i += 1
+    if code == 0 or i + code - 1 > len(data):
+      raise ValueError('bad cobs frame')
+    out += data[i:i + code - 1]
+    i += code - 1
+    if code != 0xFF and i < len(data):
+      out.append(0)
+  return bytes(out)
+
+
+class Frame:
+  def __init__(self):
+    self.buf      = bytearray()
+    self.is_frame = False
+
+  def feed(self, data):
+    """Returns decoded packets; bytes outside frames (text CLI output) are dropped."""
+    packets = []
+    for b in data:
+      if b == 0:
+        if self.is_frame and self.buf:
+          try:
+            packets.append(cobs_decode(bytes(self.buf)))
+          except ValueError:
+            pass
+          self.is_frame = False
+        else:
+          self.is_frame = True
+        self.buf.clear()
+      elif self.is_frame:
+        self.buf.append(b)
+    return packets
+
+
+class CliBin:
+  def __init__(self, port, timeout=1.0):
+    self.port    = port
+    self.timeout = timeout
+    self.seq     = 0
+    self.frame   = Frame()
+    self.pending = {}
+
+  def send(self, cmd, data=b''):
+    seq = self.seq
+    self.seq = (self.seq + 1) & 0xFF
+    packet = struct.pack('<BH', seq, cmd) + bytes(data)
+    packet += struct.pack('<H', crc16(packet))
+    self.port.write(b'\x00' + cobs_encode(packet) + b'\x00')
+    return seq
+
+  def recv(self):
+    """Waits for one response : (seq, cmd, status, data)."""
+    end = time.time() + self.timeout
+    while time.time() < end:
+      if self.pending:
+        seq = next(iter(self.pending))
+        return self.pending.pop(seq)
+      chunk = self.port.read(256)
+      for packet in self.frame.feed(chunk):
+        if len(packet) < 6 or crc16(packet[:-2]) != struct.unpack_from('<H', packet, len(packet) - 2)[0]:
+          continue
+        seq, cmd, status = struct.unpack_from('<BHB', packet, 0)
+        self.pending[seq] = (seq, cmd, status, packet[4:-2])
+    raise TimeoutError('no response')
+
+  def request(self, cmd, data=b''):
+    seq = self.send(cmd, data)
+    while True:
+      r_seq, r_cmd, status, resp = self.recv()
+      if r_seq == seq:
+        if status != 0:
+          raise RuntimeError('cmd 0x%04X : %s' % (cmd, STATUS_STR[status] if status < len(STATUS_STR) else status))
+        return resp
+
+  def pipeline(self, requests, window=8):
+    """Keeps up to `window` requests in flight; returns responses in request order."""
+    requests  = list(requests)
+    results   = [None] * len(requests)
+    in_flight = {}
+    index     = 0
+    while index < len(requests) or in_flight:
+      while index < len(requests) and len(in_flight) < min(window, 255):
+        cmd, data = requests[index]
+        in_flight[self.send(cmd, data)] = index
+        index += 1
+      seq, cmd, status, resp = self.recv()
+      if seq in in_flight:
+        results[in_flight.pop(seq)] = (status, resp)
+    return results
+
+
+class PtyPort:
+  def __init__(self, fd):
+    self.fd = fd
+    os.set_blocking(fd, False)
+
+  def write(self, data):
+    while data:
+      try:
+        data = data[os.write(self.fd, data):]
+      except BlockingIOError:
+        time.sleep(0.001)
+
+  def read(self, size):
+    try:
+      return os.read(self.fd, size)
+    except BlockingIOError:
+      time.sleep(0.001)
+      return b''
+
+
+HOST_DEFAULT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'build_host', 'stm32wb55-ble-host')
+PROMPT       = b'cli# '
+
+
+def host_open(path):
+  """Start the host build and open the pty it reports on stderr."""
+  import tty
+
+  proc = subprocess.Popen([path], stdin=subprocess.DEVNULL, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE)
+  m = re.search(rb'pty : (\S+)', proc.stderr.readline())
+  if m is None:
+    proc.kill()
+    raise RuntimeError('%s : no pty' % path)
+  fd = os.open(m.group(1), os.O_RDWR | os.O_NOCTTY)
+  tty.setraw(fd)
+  return proc, PtyPort(fd)
+
+
+def host_command(port, cmd, timeout=5.0):
+  port.write(cmd + b'\r')
+  out = b''
+  end = time.time() + timeout
+  while not out.endswith(PROMPT):
+    if time.time() > end:
+      raise TimeoutError('%s : no prompt' % cmd.decode())
+    out += port.read(4096)
+  return out
+
+
+def sus_pattern(offset):
+  # cliQspiSusPattern() in qspi.c
+  return (offset ^ (offset >> 8) ^ 0x5A) & 0xFF
+
+
+def selftest(host):
+  for data in [b'', b'\x00', b'\x00\x00', bytes(range(1, 255)), bytes(range(256)) * 2]:
+    assert cobs_decode(cobs_encode(data)) == data
+    assert b'\x00' not in cobs_encode(data)
+  assert crc16(b'123456789') == 0xFEE8      # CRC-16/BUYPASS check value
+
+  proc, port = host_open(host)
+  ok = True
+  try:
+    # 0x0 에 64KB pattern 을 쓰고 그 뒤 1MB 를 지운다.
+    out = host_command(port, b'qspi suspend-test 0x0', 30.0)
+    if b'suspend-test : OK' not in out:
+      raise RuntimeError('suspend-test failed')
+
+    client = CliBin(port)
+    data_max, = struct.unpack_from('<H', client.request(CMD_INFO), 0)
+
+    # 0 이 많이 섞인 payload 로 COBS 를 돌린다.
+    count  = 500
+    reqs   = [(CMD_PING, struct.pack('<I', i) + bytes(i % 64)) for i in range(count)]
+    pre    = time.time()
+    result = client.pipeline(reqs, window=16)
+    exe    = time.time() - pre
+    if len(result) != count or any(status != 0 or resp != reqs[i][1] for i, (status, resp) in enumerate(result)):
+      print('ping : mismatch')
+      ok = False
+    print('ping : %d in %.3f s (%.0f req/s)' % (count, exe, count / exe))
+
+    memory = bytes(sus_pattern(i) for i in range(0x10000)) + b'\xff' * 0x1000
+    reqs   = [(CMD_QSPI_READ, struct.pack('<IH', addr, data_max)) for addr in range(0, 0x10000, data_max)]
+    reqs  += [(CMD_QSPI_READ, struct.pack('<IH', addr, length)) for addr, length in [(1, 1), (0xFFF0, 0x20), (0x3, 0x0)]]
+    pre    = time.time()
+    result = client.pipeline(reqs, window=8)
+    exe    = time.time() - pre
+    for (cmd, req), (status, resp) in zip(reqs, result):
+      addr, length = struct.unpack('<IH', req)
+      if status != 0 or resp != memory[addr:addr + length]:
+        print('qspi read : 0x%X %d mismatch' % (addr, length))
+        ok = False
+    print('qspi read : 64 KB in %.3f s' % exe)
+
+    # device 가 거절해야 하는 요청
+    for name, cmd, data, expect in [('length', CMD_QSPI_READ, struct.pack('<IH', 0, data_max + 1), 3),
+                                    ('param',  CMD_QSPI_READ, struct.pack('<I', 0), 4),
+                                    ('cmd',    0x7777, b'', 2)]:
+      status, resp = client.pipeline([(cmd, data)])[0]
+      if status != expect:
+        print('%s : status %d, expected %d' % (name, status, expect))
+        ok = False
+
+    packet = struct.pack('<BHI', client.seq, CMD_PING, 0x12345678)
+    packet += struct.pack('<H', crc16(packet) ^ 0x0100)
+    port.write(b'\x00' + cobs_encode(packet) + b'\x00')
+    _, _, status, _ = client.recv()
+    err_crc, = struct.unpack_from('<I', client.request(CMD_INFO), 6)
+    if status != 1 or err_crc != 1:
+      print('crc : status %d, err_crc %d' % (status, err_crc))
+      ok = False
+
+    # 구분자 하나를 같이 쓰는 연속 frame 도 둘 다 처리해야 한다.
+    frames = []
+    for value in (0x11111111, 0x22222222):
+      packet  = struct.pack('<BHI', client.seq, CMD_PING, value)
+      packet += struct.pack('<H', crc16(packet))
+      frames.append(cobs_encode(packet))
+      client.seq = (client.seq + 1) & 0xFF
+    port.write(b'\x00' + frames[0] + b'\x00' + frames[1] + b'\x00')
+    resp = [client.recv()[3] for _ in frames]
+    if resp != [struct.pack('<I', 0x11111111), struct.pack('<I', 0x22222222)]:
+      print('shared delimiter : %s' % resp)
+      ok = False
+
+    # frame 직후 CLI_BIN_NEXT_MS 안의 byte 는 다음 frame 으로 보므로 잠시 쉬고 text 를 보낸다.
+    time.sleep(0.1)
+    port.write(b'exit\r')
+    proc.wait(2)
+  finally:
+    if proc.poll() is None:
+      proc.kill()
+
+  print('selftest : %s' % ('OK' if ok else 'FAIL'))
+  return 0 if ok else 1
+
+
+def main():
+  parser = argparse.ArgumentParser(description='binary cli client')
+  parser.add_argument('--port')
+  parser.add_argument('--baud', type=int, default=115200)
+  parser.add_argument('--window', type=int, default=8)
+  parser.add_argument('--host', default=HOST_DEFAULT, help='host build used by selftest')
+  parser.add_argument('cmd', choices=['ping', 'info', 'list', 'qspi-read', 'selftest'])
+  parser.add_argument('args', nargs='*')
+  args = parser.parse_args()
+
+  if args.cmd == 'selftest':
+    return selftest(args.host)
+
+  import serial
+  with serial.Serial(args.port, args.baud, timeout=0.05) as port:
+    client = CliBin(port)
+
+    if args.cmd == 'ping':
+      count = int(args.args[0], 0) if args.args else 100
+      pre = time.time()
+      result = client.pipeline([(CMD_PING, struct.pack('<I', i)) for i in range(count)], args.window)
+      exe = time.time() - pre
+      fail = sum(1 for status, _ in result if status != 0)
+      print('%d requests, %d fail, %.0f req/s' % (len(result), fail, count / exe))
+
+    elif args.cmd == 'info':
+      resp = client.request(CMD_INFO)
+      data_max, rx_cnt, err_crc, err_frame = struct.unpack_from('<HIII', resp, 0)
+      name, ver = resp[14:].split(b'\x00')[:2]
+      print('board     : %s %s' % (name.decode(), ver.decode()))
+      print('data max  : %d' % data_max)
+      print('rx frames : %d, crc err : %d, frame err : %d' % (rx_cnt, err_crc, err_frame))
+
+    elif args.cmd == 'list':
+      resp = client.request(CMD_LIST)
+      i = 0
+      while i < len(resp):
+        cmd, = struct.unpack_from('<H', resp, i)
+        end = resp.index(b'\x00', i + 2)
+        print('0x%04X %s' % (cmd, resp[i + 2:end].decode()))
+        i = end + 1
+
+    elif args.cmd == 'qspi-read':
+      addr   = int(args.args[0], 0)
+      length = int(args.args[1], 0)
+      resp = client.request(CMD_QSPI_READ, struct.pack('<IH', addr, length))
+      for i in range(0, len(resp), 16):
+        print('0x%08X : %s' % (addr + i, ' '.join('%02X' % b for b in resp[i:i + 16])))
+
+  return 0
+
+
+if __name__ == '__main__':
+  sys.exit(main())
@@ -0,0 +1,165 @@
+#!/usr/bin/env python3
+#
+# log_decode.py
+#
+#   Decodes the deferred binary log frames written by logDefer() (log.c).
+#   Format strings and %s arguments are read back from the firmware ELF.
+#   Text between frames (normal logPrintf/cli output) is passed through.
+#
+#   usage : log_decode.py firmware.elf capture.bin
+#           log_decode.py firmware.elf --port /dev/ttyUSB0 [--baud 115200]
+#
+
+import argparse
+import re
+import struct
+import sys
+
+
+FRAME_SYNC = b'\xA5\x5A'
+FMT_RE     = re.compile(r'%([-+ #0]*)(\d+|\*)?(?:\.(\d+))?(hh|h|ll|l|z|t)?([diuxXcspo%])')
+
+
+class Elf:
+  def __init__(self, path):
+    with open(path, 'rb') as f:
+      self.data = f.read()
+
+    if self.data[:4] != b'\x7fELF' or self.data[4] != 1:
+      raise ValueError('not an ELF32 file')
+
+    e_shoff, = struct.unpack_from('<I', self.data, 0x20)
+    e_shentsize, e_shnum = struct.unpack_from('<HH', self.data, 0x2E)
+
+    self.sections = []
+    for i in range(e_shnum):
+      sh = struct.unpack_from('<IIIIIIIIII', self.data, e_shoff + i * e_shentsize)
+      sh_type, sh_flags, sh_addr, sh_offset, sh_size = sh[1], sh[2], sh[3], sh[4], sh[5]
+      # SHF_ALLOC, not SHT_NOBITS
+      if (sh_flags & 0x2) and sh_type != 8 and sh_addr != 0:
+        self.sections.append((sh_addr, sh_offset, sh_size))
+
+  def read_str(self, addr):
+    for sh_addr, sh_offset, sh_size in self.sections:
+      if sh_addr <= addr < sh_addr + sh_size:
+        begin = sh_offset + addr - sh_addr
+        end   = self.data.index(b'\0', begin)
+        return self.data[begin:end].decode('latin-1')
+    return None
+
+
+def format_c(elf, fmt, args):
+  args = list(args)
+
+  def conv(m):
+    flags, width, prec, _, spec = m.groups()
+    if spec == '%':
+      return '%'
+    if width == '*':
+      width = str(struct.unpack('<i', struct.pack('<I', args.pop(0)))[0])
+    value = args.pop(0) if args else 0
+
+    py_fmt = '%' + flags + (width or '') + ('.' + prec if prec else '')
+    if spec in 'di':
+      return (py_fmt + 'd') % struct.unpack('<i', struct.pack('<I', value))[0]
+    if spec == 'u':
+      return (py_fmt + 'd') % value
+    if spec in 'xXo':
+      return (py_fmt + spec) % value
+    if spec == 'p':
+      return '0x%08X' % value
+    if spec == 'c':
+      return (py_fmt + 'c') % (value & 0xFF)
+    if spec == 's':
+      text = elf.read_str(value)
+      return (py_fmt + 's') % (text if text is not None else '<0x%08X>' % value)
+    return m.group(0)
+
+  return FMT_RE.sub(conv, fmt)
+
+
+class Decoder:
+  def __init__(self, elf, clock):
+    self.elf      = elf
+    self.clock    = clock
+    self.buf      = bytearray()
+    self.seq      = None
+    self.time_hi  = 0
+    self.time_pre = None
+
+  def timestamp(self, time):
+    if self.time_pre is not None and time < self.time_pre:
+      self.time_hi += 1 << 32
+    self.time_pre = time
+    return (self.time_hi + time) / self.clock
+
+  def feed(self, data, out):
+    self.buf += data
+
+    while True:
+      idx = self.buf.find(FRAME_SYNC)
+      if idx < 0:
+        keep = 1 if self.buf[-1:] == FRAME_SYNC[:1] else 0
+        out.write(self.buf[:len(self.buf) - keep].decode('latin-1'))
+        del self.buf[:len(self.buf) - keep]
+        return
+
+      if idx > 0:
+        out.write(self.buf[:idx].decode('latin-1'))
+        del self.buf[:idx]
+
+      if len(self.buf) < 4:
+        return
+      length = self.buf[2]
+      if len(self.buf) < 3 + length + 1:
+        return
+
+      payload = bytes(self.buf[3:3 + length])
+      if length < 11 or (sum(payload) & 0xFF) != self.buf[3 + length]:
+        # 프레임이 아니면 sync 한 byte 만 텍스트로 넘긴다.
+        out.write(self.buf[:1].decode('latin-1'))
+        del self.buf[:1]
+        continue
+      del self.buf[:3 + length + 1]
+
+      fmt_addr, time, seq, argc = struct.unpack_from('<IIHB', payload, 0)
+      args = struct.unpack_from('<%dI' % argc, payload, 11)
+
+      if self.seq is not None and seq != ((self.seq + 1) & 0xFFFF):
+        out.write('[log] %d record(s) dropped\n' % ((seq - self.seq - 1) & 0xFFFF))
+      self.seq = seq
+
+      fmt = self.elf.read_str(fmt_addr)
+      if fmt is None:
+        text = '<fmt 0x%08X> %s\n' % (fmt_addr, ' '.join('0x%X' % a for a in args))
+      else:
+        text = format_c(self.elf, fmt, args)
+      out.write('[%10.6f] %s' % (self.timestamp(time), text))
+
+
+def main():
+  parser = argparse.ArgumentParser(description='deferred log decoder')
+  parser.add_argument('elf')
+  parser.add_argument('capture', nargs='?', help='raw capture file, - for stdin')
+  parser.add_argument('--port')
+  parser.add_argument('--baud', type=int, default=115200)
+  parser.add_argument('--clock', type=float, default=64e6, help='CPU1 clock for cycles() timestamps')
+  args = parser.parse_args()
+
+  decoder = Decoder(Elf(args.elf), args.clock)
+
+  if args.port:
+    import serial
+    with serial.Serial(args.port, args.baud, timeout=0.1) as port:
+      while True:
+        data = port.read(1024)
+        if data:
+          decoder.feed(data, sys.stdout)
+          sys.stdout.flush()
+  else:
+    src = sys.stdin.buffer if args.capture in (None, '-') else open(args.capture, 'rb')
+    decoder.feed(src.read(), sys.stdout)
+
+
+if __name__ == '__main__':
+  main()
@@ -0,0 +1,36 @@
+#!/bin/sh
+#
+# log_size.sh
+#
+#   LOG_LEVEL 별로 빌드해서 로그 호출이 차지하는 flash 크기를 비교한다.
+#
+#   usage : tools/log_size.sh [level ...]     (기본 : 0 1 3 5)
+#
+
+LEVELS=${*:-"0 1 3 5"}
+ELF=stm32wb55-ble-fw.elf
+SIZE=${ARM_TOOLCHAIN_DIR:+$ARM_TOOLCHAIN_DIR/}arm-none-eabi-size
+
+base=""
+
+printf "%-10s %10s %10s %10s\n" "LOG_LEVEL" "text" "data" "diff"
+
+for level in default $LEVELS; do
+  dir=build_log_$level
+
+  if [ "$level" = "default" ]; then
+    cmake -S . -B $dir -DLOG_LEVEL= > /dev/null || exit 1
+  else
+    cmake -S . -B $dir -DLOG_LEVEL=$level > /dev/null || exit 1
+  fi
+  cmake --build $dir -j > /dev/null || exit 1
+
+  set -- $($SIZE $dir/$ELF | tail -n 1)
+  text=$1
+  data=$2
+
+  if [ -z "$base" ]; then
+    base=$text
+  fi
+  printf "%-10s %10d %10d %+10d\n" "$level" "$text" "$data" $((text - base))
+done
@@ -0,0 +1,221 @@
+#!/usr/bin/env python3
+#
+# md_dump.py
+#
+#   Host side of the streaming memory dump (cli "md bin|b64 addr length").
+#
+#     #MD BIN 0x08000000 4096\n  [raw bytes]           \n#MD END crc32 length\n
+#     #MD B64 0x08000000 4096\n  [base64, 512 chars/line] \n#MD END crc32 length\n
+#
+#   crc32 is the zlib/IEEE one over the source bytes. Ctrl-C on the device side
+#   (or a stalled host) ends the stream with "#MD ABORT".
+#
+#   usage : md_dump.py --port /dev/ttyACM0 0x08000000 0x80000 -o flash.bin
+#           md_dump.py --port /dev/ttyACM0 --b64 0x20000000 0x1000 -o sram.bin
+#           md_dump.py selftest [--host build_host/stm32wb55-ble-host]
+#
+#   selftest runs the host build of the firmware and dumps its QSPI XIP window over
+#   the pty, so the framing, base64 and crc32 come from cli.c itself.
+#
+
+import argparse
+import base64
+import os
+import re
+import subprocess
+import sys
+import time
+import zlib
+
+
+RE_HEAD = re.compile(rb'#MD (BIN|B64) 0x([0-9A-Fa-f]+) (\d+)\r?\n')
+RE_TAIL = re.compile(rb'\r?\n#MD (END ([0-9A-Fa-f]{8}) (\d+)|ABORT)')
+
+
+class MdDump:
+  def __init__(self, port, timeout=2.0):
+    self.port    = port
+    self.timeout = timeout
+    self.buf     = b''
+
+  def read_until(self, cond):
+    end = time.time() + self.timeout
+    while time.time() < end:
+      ret = cond()
+      if ret is not None:
+        return ret
+      chunk = self.port.read(4096)
+      if chunk:
+        self.buf += chunk
+        end = time.time() + self.timeout
+    raise TimeoutError('no response')
+
+  def dump(self, addr, length, b64=False, progress=None):
+    self.buf = b''
+    self.port.write(b'md %s 0x%X %d\r' % (b'b64' if b64 else b'bin', addr, length))
+
+    m = self.read_until(lambda: RE_HEAD.search(self.buf))
+    if int(m.group(3)) != length:
+      raise RuntimeError('length mismatch : %s' % m.group(0))
+    self.buf = self.buf[m.end():]
+
+    if b64:
+      data = bytearray()
+      def take_lines():
+        while len(data) < length:
+          i = self.buf.find(b'\n')
+          if i < 0:
+            return None
+          line, self.buf = self.buf[:i].strip(), self.buf[i + 1:]
+          if line.startswith(b'#MD'):
+            raise RuntimeError('stream aborted')
+          data.extend(base64.b64decode(line))
+          if progress:
+            progress(len(data), length)
+        return True
+      self.read_until(take_lines)
+      data = bytes(data)
+    else:
+      def take_raw():
+        if progress:
+          progress(min(len(self.buf), length), length)
+        return True if len(self.buf) >= length else None
+      self.read_until(take_raw)
+      data, self.buf = self.buf[:length], self.buf[length:]
+
+    m = self.read_until(lambda: RE_TAIL.search(self.buf))
+    if m.group(1) == b'ABORT':
+      raise RuntimeError('stream aborted')
+    crc_dev = int(m.group(2), 16)
+    crc_host = zlib.crc32(data)
+    if crc_dev != crc_host or int(m.group(3)) != length:
+      raise RuntimeError('crc mismatch : dev %08X, host %08X' % (crc_dev, crc_host))
+    return data
+
+
+class PtyPort:
+  def __init__(self, fd):
+    self.fd = fd
+    os.set_blocking(fd, False)
+
+  def write(self, data):
+    while data:
+      try:
+        data = data[os.write(self.fd, data):]
+      except BlockingIOError:
+        time.sleep(0.001)
+
+  def read(self, size):
+    try:
+      return os.read(self.fd, size)
+    except BlockingIOError:
+      time.sleep(0.001)
+      return b''
+
+
+HOST_DEFAULT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'build_host', 'stm32wb55-ble-host')
+PROMPT       = b'cli# '
+
+
+def host_open(path):
+  """Start the host build and open the pty it reports on stderr."""
+  import tty
+
+  proc = subprocess.Popen([path], stdin=subprocess.DEVNULL, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE)
+  m = re.search(rb'pty : (\S+)', proc.stderr.readline())
+  if m is None:
+    proc.kill()
+    raise RuntimeError('%s : no pty' % path)
+  fd = os.open(m.group(1), os.O_RDWR | os.O_NOCTTY)
+  tty.setraw(fd)
+  return proc, PtyPort(fd)
+
+
+def host_command(port, cmd, timeout=5.0):
+  port.write(cmd + b'\r')
+  out = b''
+  end = time.time() + timeout
+  while not out.endswith(PROMPT):
+    if time.time() > end:
+      raise TimeoutError('%s : no prompt' % cmd.decode())
+    out += port.read(4096)
+  return out
+
+
+def sus_pattern(offset):
+  # cliQspiSusPattern() in qspi.c
+  return (offset ^ (offset >> 8) ^ 0x5A) & 0xFF
+
+
+def selftest(host):
+  assert zlib.crc32(b'123456789') == 0xCBF43926
+
+  proc, port = host_open(host)
+  ok = True
+  try:
+    # 0x0 에 64KB pattern 을 쓰고 그 뒤 1MB 를 지운다.
+    out = host_command(port, b'qspi suspend-test 0x0', 30.0)
+    if b'suspend-test : OK' not in out:
+      raise RuntimeError('suspend-test failed')
+    host_command(port, b'qspi xip on')
+
+    memory = bytes(sus_pattern(i) for i in range(0x10000)) + b'\xff' * 0x1000
+    client = MdDump(port)
+    for b64 in [False, True]:
+      for addr, length in [(0, 1), (3, 383), (100, 513), (0xFF00, 0x200), (0, 0x10000)]:
+        pre  = time.time()
+        data = client.dump(0x90000000 + addr, length, b64)
+        exe  = time.time() - pre
+        host_command(port, b'')
+        if data != memory[addr:addr + length]:
+          print('%s : 0x%X %d mismatch' % ('b64' if b64 else 'bin', addr, length))
+          ok = False
+      print('%s : %d KB in %.3f s' % ('b64' if b64 else 'bin', length // 1024, exe))
+
+    port.write(b'exit\r')
+    proc.wait(2)
+  finally:
+    if proc.poll() is None:
+      proc.kill()
+
+  print('selftest : %s' % ('OK' if ok else 'FAIL'))
+  return 0 if ok else 1
+
+
+def main():
+  parser = argparse.ArgumentParser(description='streaming memory dump')
+  parser.add_argument('--port')
+  parser.add_argument('--baud', type=int, default=115200)
+  parser.add_argument('--b64', action='store_true', help='base64 lines, for links that are not 8bit clean')
+  parser.add_argument('-o', '--output')
+  parser.add_argument('--host', default=HOST_DEFAULT, help='host build used by selftest')
+  parser.add_argument('args', nargs='+', help='addr length | selftest')
+  args = parser.parse_args()
+
+  if args.args[0] == 'selftest':
+    return selftest(args.host)
+
+  addr   = int(args.args[0], 0)
+  length = int(args.args[1], 0)
+
+  def progress(done, total):
+    sys.stderr.write('\r%3d%%' % (done * 100 // max(total, 1)))
+
+  import serial
+  with serial.Serial(args.port, args.baud, timeout=0.05) as port:
+    port.reset_input_buffer()
+    client = MdDump(port)
+    pre  = time.time()
+    data = client.dump(addr, length, args.b64, progress)
+    exe  = time.time() - pre
+
+  sys.stderr.write('\n')
+  print('0x%08X %d bytes, crc32 %08X, %.3f s (%.1f KB/s)' % (addr, len(data), zlib.crc32(data), exe, len(data) / 1024 / exe))
+  if args.output:
+    with open(args.output, 'wb') as f:
+      f.write(data)
+  return 0
+
+
+if __name__ == '__main__':
+  sys.exit(main())